@@ -2,6 +2,9 @@
 #include "AppVersion.h"
 #include "Windows/ProgressWindow.h"
 #include "Windows/SettingsWindow.h"
+#include "Misc/ATrace.h"
+#include "Misc/TextureCache.h"
+#include "Misc/TextureDecoder.h"
 #include "Windows/CompositePackagePicker.h"
 #include "Windows/BulkImportWindow.h"
 #include "Windows/REDialogs.h"
@@ -11,6 +14,7 @@
 
 #include <wx/mimetype.h>
 #include <wx/cmdline.h>
+#include <wx/filename.h>
 #include <wx/stdpaths.h>
 #include <wx/fileconf.h>
 #include <wx/mstream.h>
@@ -22,7 +26,6 @@
 
 #include <Tera/FPackage.h>
 #include <Tera/FStream.h>
-#include <Tera/Utils/APerfSamples.h>
 #include <Tera/Utils/ALDevice.h>
 
 
@@ -332,6 +335,7 @@ void App::OnShowSettings(wxCommandEvent& e)
       return;
     }
     Config = newConfig;
+    TextureCache::Get().SetBudget(uint64(Config.TextureCacheBudget) * 1024 * 1024);
   }
 }
 
@@ -541,6 +545,7 @@ bool App::OpenPackage(const wxString& path, const wxString selectionIn)
     std::thread([package, window]() {
       try
       {
+        TRACE_SCOPE("PackageLoad");
         package->Load();
       }
       catch (const std::exception& e)
@@ -693,6 +698,7 @@ bool App::OpenNamedPackage(const wxString& name, const wxString selectionIn)
     std::thread([package, window, selection]() {
       try
       {
+        TRACE_SCOPE("PackageLoad");
         package->Load();
       }
       catch (const std::exception& e)
@@ -839,8 +845,16 @@ bool App::OnInit()
     {
     }
   }
+  TextureCache::Get().SetBudget(uint64(Config.TextureCacheBudget) * 1024 * 1024);
   InstanceChecker = new wxSingleInstanceChecker;
   ALog::SharedLog();
+#ifdef _DEBUG
+  std::string decoderError;
+  if (!TextureDecoder::SelfCheck(decoderError))
+  {
+    LogE("TextureDecoder: %s", decoderError.c_str());
+  }
+#endif
   
   IsReady = true;
   
@@ -893,7 +907,7 @@ int App::OnRun()
 
 void App::LoadCore(ProgressWindow* pWindow)
 {
-  PERF_START(LoadCore);
+  TRACE_START(LoadCore);
   FPackage::CleanCacheDir();
   SendEvent(pWindow, UPDATE_PROGRESS_DESC, "Enumerating the game folder contents...");
   FPackage::SetRootPath(Config.RootDir);
@@ -1013,7 +1027,7 @@ void App::LoadCore(ProgressWindow* pWindow)
     extraClassPackageNames = FPackage::ClassPackages(false, false);
   }
 
-  PERF_START(ClassPackagesLoad);
+  TRACE_START(ClassPackagesLoad);
   for (const FString& name : classPackageNames)
   {
     wxString desc = wxS("Loading ");
@@ -1059,7 +1073,7 @@ void App::LoadCore(ProgressWindow* pWindow)
     }
   }
   FPackage::BuildClassInheritance();
-  PERF_END(ClassPackagesLoad);
+  TRACE_END(ClassPackagesLoad);
 
 #if 0
   // Don't need this
@@ -1103,11 +1117,15 @@ void App::LoadCore(ProgressWindow* pWindow)
   if (FPackage::GetCoreVersion() == VER_TERA_MODERN)
   {
     const auto& compositeMap = FPackage::GetCompositePackageMap();
-    CompositePackageNames.reserve(compositeMap.size());
+    std::vector<wxString> names;
+    names.reserve(compositeMap.size());
     for (const auto& pair : compositeMap)
     {
-      CompositePackageNames.push_back(pair.first.String());
+      names.push_back(pair.first.String());
     }
+    auto compositeNames = std::make_shared<PackageNameIndex>();
+    compositeNames->Build(std::move(names));
+    CompositePackageNames = std::move(compositeNames);
 
     if (pWindow->IsCanceled())
     {
@@ -1117,7 +1135,7 @@ void App::LoadCore(ProgressWindow* pWindow)
       return;
     }
   }
-  PERF_END(LoadCore);
+  TRACE_END(LoadCore);
 
   SendEvent(pWindow, UPDATE_PROGRESS_FINISH);
   SendEvent(this, DELAY_LOAD);
@@ -1187,6 +1205,12 @@ int App::OnExit()
   AConfiguration cfg = AConfiguration(W2A(GetConfigPath().ToStdWstring()));
   cfg.SetConfig(Config);
   cfg.Save();
+  if (ATrace::IsEnabled())
+  {
+    wxFileName tracePath(GetConfigPath());
+    tracePath.SetFullName(wxS("RE.trace.json"));
+    ATrace::Save(tracePath.GetFullPath().ToStdWstring());
+  }
   delete ALog::SharedLog();
   return wxApp::OnExit();
 }
@@ -1197,6 +1221,7 @@ void App::OnInitCmdLine(wxCmdLineParser& parser)
   {
     { wxCMD_LINE_SWITCH, "i", "private", "for internal usage" },
     { wxCMD_LINE_SWITCH, "s", "private", "for internal usage" },
+    { wxCMD_LINE_SWITCH, "t", "trace", "record a trace and save it next to the config on exit" },
     { wxCMD_LINE_PARAM,  NULL, NULL, "Package path", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
     { wxCMD_LINE_NONE }
   };
@@ -1222,6 +1247,7 @@ void App::OnLoadError(wxCommandEvent& e)
 bool App::OnCmdLineParsed(wxCmdLineParser& parser)
 {
   int paramsCount = parser.GetParamCount();
+  ATrace::SetEnabled(parser.Found("t"));
   if (InstanceChecker && InstanceChecker->IsAnotherRunning())
   {
     RpcClient::SendRequest("open", paramsCount ? parser.GetParam((size_t)paramsCount - 1) : wxEmptyString);
@@ -1410,9 +1436,24 @@ void App::RestartElevated(bool keepWindows)
   }
 }
 
-const wxArrayString& App::GetCompositePackageNames() const
+std::shared_ptr<const PackageNameIndex> App::GetFilePackageNames()
 {
-  return CompositePackageNames;
+  const uint32 generation = DirCacheGeneration;
+  if (!FilePackageNames || FilePackageNamesGeneration != generation)
+  {
+    std::vector<wxString> names;
+    names.reserve(FPackage::FilePackageNames.size());
+    for (const FString& name : FPackage::FilePackageNames)
+    {
+      names.push_back(name.WString());
+    }
+    // Open completers keep the previous snapshot
+    auto index = std::make_shared<PackageNameIndex>();
+    index->Build(std::move(names));
+    FilePackageNames = std::move(index);
+    FilePackageNamesGeneration = generation;
+  }
+  return FilePackageNames;
 }
 
 bool App::CheckMimeTypes(bool strict) const
@@ -1455,6 +1496,9 @@ void App::SaveAndReopenPackage(std::shared_ptr<FPackage> package, const FString&
   }
   if (win)
   {
+    // Reopen the package where the user left it
+    const wxString reopenPath = PackGpkPath(dest.WString(), win->GetPosition(), win->GetSize(), win->GetSelectedObjectPath());
+
     // TODO: this is incorrect. The package can be retained by other packages and closing its stream may cause bugs or crash the app
     // Need to iterate over all open packages, release this package and unload all objects
     package->GetStream().Close();
@@ -1466,18 +1510,46 @@ void App::SaveAndReopenPackage(std::shared_ptr<FPackage> package, const FString&
     bool ok = false;
     try
     {
-      std::filesystem::path backup = GetTempFilePath().WString();
       std::error_code err;
-      std::filesystem::copy_file(dest.WString(), backup, err);
-      std::filesystem::rename(tmp.WString(), dest.WString(), err);
-      if (err)
+      const std::filesystem::path tmpPath = tmp.WString();
+      const std::filesystem::path destPath = dest.WString();
+      if (std::filesystem::equivalent(tmpPath, destPath, err))
       {
-        std::filesystem::rename(backup, dest.WString());
-        REDialog::Error("Check if the destination is available and have free space.", "Failed to write package to the disk!");
+        // Saved in place. Nothing to move.
+        ok = true;
       }
       else
       {
-        ok = true;
+        // Keep the old file next to the destination. Renaming within a volume doesn't copy the data,
+        // unlike a backup in the temp folder, which costs a full copy of big maps on every save.
+        std::filesystem::path backup = destPath;
+        backup += ".bak";
+        bool hasBackup = false;
+        if (std::filesystem::exists(destPath, err))
+        {
+          std::filesystem::rename(destPath, backup, err);
+          hasBackup = !err;
+        }
+        if (!err)
+        {
+          std::filesystem::rename(tmpPath, destPath, err);
+        }
+        if (err)
+        {
+          if (hasBackup)
+          {
+            std::filesystem::rename(backup, destPath);
+          }
+          REDialog::Error("Check if the destination is available and have free space.", "Failed to write package to the disk!");
+        }
+        else
+        {
+          if (hasBackup)
+          {
+            std::filesystem::remove(backup, err);
+          }
+          ok = true;
+        }
       }
     }
     catch (const std::exception& e)
@@ -1486,7 +1558,7 @@ void App::SaveAndReopenPackage(std::shared_ptr<FPackage> package, const FString&
     }
     if (ok)
     {
-      OpenPackage(dest.WString());
+      OpenPackage(reopenPath);
     }
     else if (PackageWindows.empty())
     {
@@ -1572,7 +1644,7 @@ void App::DumpCompositeObjects()
 
     SendEvent(&progress, UPDATE_MAX_PROGRESS, total);
 
-    PERF_START(CompositeDump);
+    TRACE_START(CompositeDump);
     std::vector<FString> pools = FPackageDumpHelper::GetGpkPools();
     std::for_each(std::execution::par_unseq, pools.begin(), pools.end(), [&](const auto& pool) {
       std::vector<FString> items = FPackageDumpHelper::GetPoolItems(pool);
@@ -1678,7 +1750,7 @@ void App::DumpCompositeObjects()
         }
       }
     });
-    PERF_END(CompositeDump);
+    TRACE_END(CompositeDump);
     if (fatal)
     {
       return;
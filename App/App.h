@@ -9,9 +9,12 @@
 #include <wx/wx.h>
 #include <wx/event.h>
 #include <wx/snglinst.h>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include "Misc/RpcCom.h"
 #include "Misc/AConfiguration.h"
+#include "Misc/PackageNameIndex.h"
 #include "Windows/WXDialog.h"
 #include "Windows/PackageWindow.h"
 
@@ -156,7 +159,19 @@ public:
     DcToolIsOpen = flag;
   }
 
-  const wxArrayString& GetCompositePackageNames() const;
+  std::shared_ptr<const PackageNameIndex> GetCompositePackageNames() const
+  {
+    return CompositePackageNames;
+  }
+
+  // Built on the first call after the dir cache was updated. Call from the main thread.
+  std::shared_ptr<const PackageNameIndex> GetFilePackageNames();
+
+  // Call after FPackage::UpdateDirCache. Safe to call from a worker thread.
+  void OnDirCacheUpdated()
+  {
+    DirCacheGeneration++;
+  }
 
   bool CheckMimeTypes(bool strict) const;
 
@@ -229,8 +244,11 @@ private:
   std::vector<WXDialog*> Dialogs;
   std::atomic_int REDialogsCount = { 0 };
 
-  wxArrayString CompositePackageNames;
-  wxArrayString FilePackageNames;
+  std::shared_ptr<const PackageNameIndex> CompositePackageNames = std::make_shared<PackageNameIndex>();
+  std::shared_ptr<const PackageNameIndex> FilePackageNames;
+  // FilePackageNames is up to date if the generations match
+  std::atomic_uint32_t DirCacheGeneration = { 1 };
+  uint32 FilePackageNamesGeneration = 0;
 
   bool NeedsRestart = false;
   bool ShuttingDown = false;
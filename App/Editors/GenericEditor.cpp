@@ -1,6 +1,7 @@
 #include "GenericEditor.h"
 #include "../Windows/PackageWindow.h"
 #include "../Windows/REDialogs.h"
+#include "../Misc/ATrace.h"
 #include "../App.h"
 
 #include <Tera/Utils/ALog.h>
@@ -163,7 +164,10 @@ void GenericEditor::LoadObject()
     std::thread([obj, id, wpackage] {
       if (auto l = wpackage.lock())
       {
-        obj->Load();
+        {
+          TRACE_SCOPE("ObjectLoad");
+          obj->Load();
+        }
         SendEvent(wxTheApp, OBJECT_LOADED, id);
       }
     }).detach();
@@ -7,10 +7,13 @@
 
 #include "../Windows/REDialogs.h"
 #include "../Windows/TextureImporter.h"
+#include "../Misc/TerrainRaster.h"
 
 #include <wx/filename.h>
 #include "../resource.h"
 
+#include <execution>
+
 void LandscapeProxyEditor::PopulateToolBar(wxToolBar* toolbar)
 {
   GenericEditor::PopulateToolBar(toolbar);
@@ -37,17 +40,14 @@ void LandscapeProxyEditor::OnExportClicked(wxCommandEvent&)
   }
 
   std::filesystem::path dst(path.ToStdWstring());
-  dst.replace_extension(HasAVX2() ? "png" : "dds");
-
-  TextureProcessor processor(TextureProcessor::TCFormat::G16, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-  processor.SetOutputPath(W2A(dst.wstring()));
-  processor.SetInputData(HeightMapData.Allocation, HeightMapData.Size);
-  processor.SetInputDataDimensions(HeightMapData.Width, HeightMapData.Height);
+  dst.replace_extension("png");
 
-  if (!processor.Process())
+  std::string error;
+  TerrainRaster heights = TerrainRaster::View(HeightMapData.Allocation, HeightMapData.Width, HeightMapData.Height, sizeof(uint16));
+  if (!heights.SavePng(dst, error))
   {
     LogW("Failed to export heights");
-    REDialog::Error(processor.GetError());
+    REDialog::Error(error);
   }
 }
 
@@ -188,6 +188,7 @@ wxString LandscapeEditor::OnExportWeightsClicked(wxCommandEvent& e)
   {
     return wxEmptyString;
   }
+  std::vector<std::pair<TerrainRaster, std::filesystem::path>> layers;
   std::vector<LandscapeLayerStruct> LayerInfoObjs = Landscape->LayerInfoObjs;
   for (const LandscapeLayerStruct& l : LayerInfoObjs)
   {
@@ -196,20 +197,24 @@ wxString LandscapeEditor::OnExportWeightsClicked(wxCommandEvent& e)
       l.LayerInfoObj->Load();
       UTextureBitmapInfo bitmap;
       Landscape->GetWeighMapData(l.LayerInfoObj->LayerName, bitmap);
+      if (!bitmap.Allocation)
+      {
+        continue;
+      }
 
       std::filesystem::path dst(path.ToStdWstring());
       FString name = l.LayerInfoObj->LayerName.GetString();
-      dst /= name.WString() + (HasAVX2() ? L".png" : L".dds");
-
-      TextureProcessor processor(TextureProcessor::TCFormat::G8, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-      processor.SetOutputPath(W2A(dst.wstring()));
-      processor.SetInputData(bitmap.Allocation, bitmap.Size);
-      processor.SetInputDataDimensions(bitmap.Width, bitmap.Height);
-      processor.Process();
-
-      free(bitmap.Allocation);
+      dst /= name.WString() + L".png";
+      layers.emplace_back(TerrainRaster::Adopt(bitmap.Allocation, bitmap.Width, bitmap.Height, 1), dst);
     }
   }
+  std::for_each(std::execution::par, layers.begin(), layers.end(), [](auto& layer) {
+    std::string error;
+    if (!layer.first.SavePng(layer.second, error))
+    {
+      LogW("Failed to export weightmap %s: %s", layer.second.filename().u8string().c_str(), error.c_str());
+    }
+  });
   return path;
 }
 
@@ -1,14 +1,16 @@
 #include "../App.h"
 #include "LevelEditor.h"
 #include "../Windows/PackageWindow.h"
-#include "../Windows/ProgressWindow.h"
 #include "../Windows/REDialogs.h"
+#include "../Misc/ATrace.h"
+#include "../Misc/OSGMeshBuffers.h"
 
 #include <osgViewer/ViewerEventHandlers>
 #include <osgGA/TrackballManipulator>
 #include <osgUtil/SmoothingVisitor>
 #include <osg/BlendFunc>
 #include <osg/Depth>
+#include <osg/LOD>
 
 #include <Tera/Cast.h>
 #include <Tera/FPackage.h>
@@ -19,7 +21,10 @@
 #include <Tera/UMaterial.h>
 #include <Tera/UPrefab.h>
 
+#include <algorithm>
+#include <cfloat>
 #include <execution>
+#include <unordered_set>
 
 #include "../resource.h"
 
@@ -27,6 +32,105 @@ static const osg::Vec3d YawAxis(0.0, 0.0, -1.0);
 static const osg::Vec3d PitchAxis(0.0, -1.0, 0.0);
 static const osg::Vec3d RollAxis(1.0, 0.0, 0.0);
 
+// Projected size in pixels below which the next mesh LOD is used. Halves for every next LOD.
+static const float LodPixelSize = 256.f;
+static const int32 MaxMeshLods = 4;
+// Projected size in pixels below which actors replaced by an MLOD switch to the MLOD
+static const float MLodPixelSize = 192.f;
+static const float SmallFeaturePixelSize = 4.f;
+static const size_t BvhLeafSize = 16;
+
+// Wrap mesh LODs into a node that switches them by the projected size
+static osg::ref_ptr<osg::Node> CreateLodNode(const std::vector<osg::ref_ptr<osg::Geode>>& geodes)
+{
+  std::vector<osg::ref_ptr<osg::Geode>> valid;
+  for (const osg::ref_ptr<osg::Geode>& geode : geodes)
+  {
+    if (geode)
+    {
+      valid.push_back(geode);
+    }
+  }
+  if (valid.size() < 2)
+  {
+    return valid.size() ? valid.front() : nullptr;
+  }
+  osg::ref_ptr<osg::LOD> lod = new osg::LOD;
+  lod->setRangeMode(osg::LOD::PIXEL_SIZE_ON_SCREEN);
+  lod->setDataVariance(osg::Object::STATIC);
+  float maxSize = FLT_MAX;
+  float minSize = LodPixelSize;
+  for (size_t idx = 0; idx < valid.size(); ++idx)
+  {
+    if (idx == valid.size() - 1)
+    {
+      minSize = 0.f;
+    }
+    lod->addChild(valid[idx], minSize, maxSize);
+    maxSize = minSize;
+    minSize *= .5f;
+  }
+  return lod;
+}
+
+static osg::ref_ptr<osg::Group> CreateBvhNode(std::vector<osg::ref_ptr<osg::Node>>& nodes, size_t begin, size_t end)
+{
+  osg::ref_ptr<osg::Group> result = new osg::Group;
+  if (end - begin <= BvhLeafSize)
+  {
+    for (size_t idx = begin; idx < end; ++idx)
+    {
+      result->addChild(nodes[idx]);
+    }
+    return result;
+  }
+  // Median split along the longest axis of the node centers
+  osg::BoundingBox box;
+  for (size_t idx = begin; idx < end; ++idx)
+  {
+    box.expandBy(nodes[idx]->getBound().center());
+  }
+  const osg::Vec3 extent = box._max - box._min;
+  const int32 axis = extent.x() > extent.y() ? (extent.x() > extent.z() ? 0 : 2) : (extent.y() > extent.z() ? 1 : 2);
+  const size_t mid = begin + (end - begin) / 2;
+  std::nth_element(nodes.begin() + begin, nodes.begin() + mid, nodes.begin() + end, [axis](const osg::ref_ptr<osg::Node>& a, const osg::ref_ptr<osg::Node>& b) {
+    return a->getBound().center()[axis] < b->getBound().center()[axis];
+  });
+  result->addChild(CreateBvhNode(nodes, begin, mid));
+  result->addChild(CreateBvhNode(nodes, mid, end));
+  return result;
+}
+
+// Rebuild children of the group into a bounding volume hierarchy, so the cull traversal skips
+// whole branches instead of testing every actor. Nodes in 'keep' stay direct children.
+static void BuildHierarchy(osg::Group* group, const std::unordered_set<osg::Node*>& keep)
+{
+  std::vector<osg::ref_ptr<osg::Node>> nodes;
+  std::vector<osg::ref_ptr<osg::Node>> kept;
+  for (uint32 idx = 0; idx < group->getNumChildren(); ++idx)
+  {
+    osg::Node* child = group->getChild(idx);
+    if (keep.count(child))
+    {
+      kept.emplace_back(child);
+    }
+    else
+    {
+      nodes.emplace_back(child);
+    }
+  }
+  if (nodes.size() <= BvhLeafSize)
+  {
+    return;
+  }
+  group->removeChildren(0, group->getNumChildren());
+  for (osg::ref_ptr<osg::Node>& node : kept)
+  {
+    group->addChild(node);
+  }
+  group->addChild(CreateBvhNode(nodes, 0, nodes.size()));
+}
+
 LevelEditor::LevelEditor(wxPanel* parent, PackageWindow* window)
   : GenericEditor(parent, window)
 {
@@ -34,8 +138,30 @@ LevelEditor::LevelEditor(wxPanel* parent, PackageWindow* window)
   window->FixOSG();
 }
 
+LevelEditor::~LevelEditor()
+{
+  CancelLoading = true;
+  if (LoadThread.joinable())
+  {
+    LoadThread.join();
+  }
+  if (Streamer)
+  {
+    Streamer->Stop();
+  }
+  delete Renderer;
+}
+
 void LevelEditor::OnTick()
 {
+  if (Renderer && IsLoading)
+  {
+    ApplyLoadedNodes();
+  }
+  if (Renderer && Streamer && Streamer->HasPendingUpdates())
+  {
+    Renderer->requestRedraw();
+  }
   if (Renderer && Renderer->isRealized() && Renderer->checkNeedToDoFrame())
   {
     Renderer->frame();
@@ -51,7 +177,10 @@ void LevelEditor::OnObjectLoaded()
 {
   if (Loading || !Level)
   {
+    CancelSceneLoading();
     LevelNodes.clear();
+    StaticMeshCache.clear();
+    SkelMeshCache.clear();
     Level = (ULevel*)Object;
     Root = new osg::Geode;
     Bind(wxEVT_IDLE, &LevelEditor::OnIdle, this);
@@ -72,6 +201,7 @@ void LevelEditor::PopulateToolBar(wxToolBar* toolbar)
   {
     tool->SetShortHelp("The level was loaded!");
   }
+  UpdateExportTool();
 }
 
 void LevelEditor::OnToolBarEvent(wxCommandEvent& event)
@@ -85,7 +215,6 @@ void LevelEditor::OnToolBarEvent(wxCommandEvent& event)
   if (event.GetId() == eID_Level_Load)
   {
     LoadPersistentLevel();
-    ShowEmptyMessage = !Root->getNumChildren();
     if (wxToolBarBase* item = (wxToolBarBase*)event.GetEventObject())
     {
       if (wxToolBarToolBase* sender = item->FindById(event.GetId()))
@@ -103,6 +232,11 @@ void LevelEditor::OnToolBarEvent(wxCommandEvent& event)
 
 void LevelEditor::OnExportClicked(wxCommandEvent& e)
 {
+  if (IsLoading)
+  {
+    REDialog::Warning("Wait until the level preview finishes loading.");
+    return;
+  }
   LevelExportContext ctx = LevelExportContext::LoadFromAppConfig();
   LevelExportOptionsWindow optionsWin(this, ctx);
   if (optionsWin.ShowModal() != wxID_OK)
@@ -145,6 +279,8 @@ void LevelEditor::CreateRenderer()
   Renderer->getCamera()->setProjectionMatrixAsPerspective(60, GetSize().x / GetSize().y, 0.1, 500);
   Renderer->getCamera()->setDrawBuffer(GL_BACK);
   Renderer->getCamera()->setReadBuffer(GL_BACK);
+  Renderer->getCamera()->setCullingMode(Renderer->getCamera()->getCullingMode() | osg::CullSettings::SMALL_FEATURE_CULLING);
+  Renderer->getCamera()->setSmallFeatureCullingPixelSize(SmallFeaturePixelSize);
 
 #if _DEBUG
   Renderer->addEventHandler(new osgViewer::StatsHandler);
@@ -176,149 +312,328 @@ void LevelEditor::LoadPersistentLevel()
     }
     return;
   }
-  ProgressWindow progress(Window, "Please wait...");
-  progress.SetCurrentProgress(-1);
-  progress.SetCanCancel(false);
-  progress.SetActionText("Loading the level");
-  progress.Layout();
-
-  std::thread([&] {
-    CreateLevel(Level, Root);
-    UObject* world = Level->GetOuter();
-    auto worldInner = world->GetInner();
-
-    std::vector<ULevelStreaming*> streamedLevels;
-    for (UObject* inner : worldInner)
-    {
-      if (ULevelStreaming* level = Cast<ULevelStreaming>(inner))
-      {
-        streamedLevels.emplace_back(level);
-      }
-    }
-    std::mutex osgMutex;
-    std::for_each(std::execution::par_unseq, streamedLevels.begin(), streamedLevels.end(), [&](auto* level) {
-      level->Load();
-      if (level->Level)
-      {
-        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-        geode->setName(level->Level->GetPackage()->GetPackageName().C_str());
-        CreateLevel(level->Level, geode);
-        std::scoped_lock<std::mutex> l(osgMutex);
-        Root->addChild(geode);
-      }
-    });
-    SendEvent(&progress, UPDATE_PROGRESS_FINISH, true);
-  }).detach();
-
-  progress.ShowModal();
-
+  Streamer = new TextureStreamer;
+  Root->setUpdateCallback(new TextureStreamer::UpdateCallback(Streamer));
   Renderer->getCamera()->setViewport(0, 0, GetSize().x, GetSize().y);
   Renderer->setSceneData(Root);
   LevelLoaded = true;
+  IsLoading = true;
+  UpdateExportTool();
+  LoadThread = std::thread(&LevelEditor::BuildSceneAsync, this);
 }
 
-void LevelEditor::CreateLevel(ULevel* level, osg::ref_ptr<osg::Geode> root)
+void LevelEditor::CancelSceneLoading()
 {
-  if (!level)
+  if (!IsLoading)
   {
     return;
   }
+  CancelLoading = true;
+  if (LoadThread.joinable())
+  {
+    LoadThread.join();
+  }
+  CancelLoading = false;
+  PendingNodes.clear();
+  LevelGroups.clear();
+  LoadingFinished = false;
+  HomeReady = false;
+  LoadedActorCount = 0;
+  if (Streamer)
+  {
+    Streamer->Stop();
+    Streamer = nullptr;
+  }
+  Renderer->setSceneData(nullptr);
+  IsLoading = false;
+  LevelLoaded = false;
+  UpdateExportTool();
+}
 
-  auto actors = level->GetActors();
+void LevelEditor::UpdateExportTool()
+{
+  if (Toolbar && Toolbar->FindById(eID_Export))
+  {
+    Toolbar->EnableTool(eID_Export, !IsLoading);
+  }
+}
 
-  if (actors.empty())
+void LevelEditor::BuildSceneAsync()
+{
+  TRACE_SCOPE("SceneBuild");
+  // Actors of all levels with the node they will be attached to
+  std::vector<ActorEntry> actors;
   {
-    return;
+    std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>> groups;
+    CollectLevelActors(Level, Root, actors, groups);
+    std::scoped_lock<std::mutex> l(PendingMutex);
+    LevelGroups.emplace_back(Root);
+    PendingNodes.insert(PendingNodes.end(), groups.begin(), groups.end());
   }
 
-  std::vector<UActor*> skip;
-  for (UActor* actor : actors)
+  UObject* world = Level->GetOuter();
+  auto worldInner = world->GetInner();
+  std::vector<ULevelStreaming*> streamedLevels;
+  for (UObject* inner : worldInner)
   {
-    if (!actor || actor->bHidden)
+    if (ULevelStreaming* level = Cast<ULevelStreaming>(inner))
     {
-      continue;
+      streamedLevels.emplace_back(level);
+    }
+  }
+  // Levels are loaded in parallel. Each level keeps its own results, which are merged after the loop.
+  struct StreamedLevelResult {
+    osg::ref_ptr<osg::Geode> Geode;
+    std::vector<ActorEntry> Actors;
+    std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>> Groups;
+  };
+  std::vector<StreamedLevelResult> levelResults(streamedLevels.size());
+  std::vector<size_t> levelIndices(streamedLevels.size());
+  for (size_t idx = 0; idx < levelIndices.size(); ++idx)
+  {
+    levelIndices[idx] = idx;
+  }
+  std::for_each(std::execution::par, levelIndices.begin(), levelIndices.end(), [&](size_t idx) {
+    if (CancelLoading)
+    {
+      return;
     }
-    if (UStaticMeshActor* staticActor = Cast<UStaticMeshActor>(actor))
+    TRACE_SCOPE("StreamedLevelLoad");
+    ULevelStreaming* level = streamedLevels[idx];
+    level->Load();
+    if (level->Level)
     {
-      if (staticActor->StaticMeshComponent && staticActor->StaticMeshComponent->ReplacementPrimitive)
-      {
-        skip.push_back(actor);
-      }
+      StreamedLevelResult& result = levelResults[idx];
+      result.Geode = new osg::Geode;
+      result.Geode->setName(level->Level->GetPackage()->GetPackageName().C_str());
+      CollectLevelActors(level->Level, result.Geode, result.Actors, result.Groups);
     }
-    else if (UInterpActor* interpActor = Cast<UInterpActor>(actor))
+  });
+  {
+    std::scoped_lock<std::mutex> l(PendingMutex);
+    for (StreamedLevelResult& result : levelResults)
     {
-      if (interpActor->StaticMeshComponent && interpActor->StaticMeshComponent->ReplacementPrimitive)
+      if (!result.Geode)
       {
-        skip.push_back(actor);
+        continue;
       }
+      actors.insert(actors.end(), result.Actors.begin(), result.Actors.end());
+      LevelGroups.emplace_back(result.Geode);
+      PendingNodes.emplace_back(Root, result.Geode);
+      PendingNodes.insert(PendingNodes.end(), result.Groups.begin(), result.Groups.end());
+    }
+  }
+
+  // Place the camera over the whole level and build actors closest to it first
+  osg::BoundingSphere bounds;
+  for (const ActorEntry& entry : actors)
+  {
+    FVector location = entry.Actor->GetLocation();
+    bounds.expandBy(osg::Vec3(location.X, -location.Y, location.Z));
+  }
+  const osg::Vec3 eye = bounds.center() + osg::Vec3(0.f, -3.5f * bounds.radius(), 0.f);
+  {
+    std::scoped_lock<std::mutex> l(PendingMutex);
+    HomeEye = eye;
+    HomeCenter = bounds.center();
+    HomeReady = bounds.valid();
+  }
+  std::vector<std::pair<float, size_t>> order;
+  order.reserve(actors.size());
+  for (size_t idx = 0; idx < actors.size(); ++idx)
+  {
+    FVector location = actors[idx].Actor->GetLocation();
+    order.emplace_back((osg::Vec3(location.X, -location.Y, location.Z) - eye).length2(), idx);
+  }
+  std::sort(order.begin(), order.end());
+
+  const size_t batchSize = 256;
+  for (size_t batchStart = 0; batchStart < order.size() && !CancelLoading; batchStart += batchSize)
+  {
+    TRACE_SCOPE("SceneActorsBatch");
+    const size_t batchEnd = std::min(batchStart + batchSize, order.size());
+    // Actors read mesh and material data from the core objects, which is not thread safe. Build them on this thread.
+    std::vector<osg::ref_ptr<osg::MatrixTransform>> nodes(batchEnd - batchStart);
+    for (size_t idx = 0; idx < nodes.size(); ++idx)
+    {
+      const ActorEntry& entry = actors[order[batchStart + idx].second];
+      nodes[idx] = CreateActor(entry.Actor, entry.Kind);
     }
-    else if (USkeletalMeshActor* skelActor = Cast<USkeletalMeshActor>(actor))
+    std::scoped_lock<std::mutex> l(PendingMutex);
+    for (size_t idx = 0; idx < nodes.size(); ++idx)
     {
-      if (skelActor->SkeletalMeshComponent && skelActor->SkeletalMeshComponent->ReplacementPrimitive)
+      if (nodes[idx])
       {
-        skip.push_back(actor);
+        PendingNodes.emplace_back(actors[order[batchStart + idx].second].Parent, nodes[idx]);
+        LoadedActorCount++;
       }
     }
   }
+  std::scoped_lock<std::mutex> l(PendingMutex);
+  LoadingFinished = true;
+}
 
-  for (UActor* actor : actors)
+void LevelEditor::ApplyLoadedNodes()
+{
+  std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>> nodes;
+  bool finished = false;
   {
-    if (!actor || actor->bHidden)
+    std::scoped_lock<std::mutex> l(PendingMutex);
+    nodes.swap(PendingNodes);
+    finished = LoadingFinished;
+    if (HomeReady)
     {
-      continue;
+      HomeReady = false;
+      Renderer->getCameraManipulator()->setHomePosition(HomeEye, HomeCenter, osg::Vec3d(0., 0., 1.));
+      Renderer->home();
     }
-    if (std::find(skip.begin(), skip.end(), actor) != skip.end())
+  }
+  for (auto& pair : nodes)
+  {
+    pair.first->addChild(pair.second);
+  }
+  if (nodes.size())
+  {
+    Renderer->requestRedraw();
+  }
+  if (finished)
+  {
+    IsLoading = false;
+    LoadThread.join();
+    UpdateExportTool();
+    // Everything is attached. Replace flat actor lists with hierarchies.
+    std::unordered_set<osg::Node*> keep;
+    for (osg::ref_ptr<osg::Group>& group : LevelGroups)
     {
-      continue;
+      keep.insert(group.get());
     }
-    osg::ref_ptr<osg::MatrixTransform> componentTransform = nullptr;
-    if (UStaticMeshActor* staticActor = Cast<UStaticMeshActor>(actor))
+    for (osg::ref_ptr<osg::Group>& group : LevelGroups)
+    {
+      BuildHierarchy(group, keep);
+    }
+    LevelGroups.clear();
+    ShowEmptyMessage = !LoadedActorCount;
+    Renderer->requestRedraw();
+  }
+}
+
+void LevelEditor::CollectLevelActors(ULevel* level, osg::ref_ptr<osg::Group> container, std::vector<ActorEntry>& outActors, std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>>& outGroups)
+{
+  if (!level)
+  {
+    return;
+  }
+
+  const LevelActorClassifier classifier(level);
+  const size_t count = classifier.Size();
+
+  // Replaced actors are rendered up close and their MLOD actor at distance
+  std::vector<osg::ref_ptr<osg::LOD>> mlods(classifier.GetMLodCount() ? count : 0);
+  for (size_t idx = 0; idx < mlods.size(); ++idx)
+  {
+    if (!classifier.IsMLod(idx) || classifier.IsHidden(idx))
     {
-      componentTransform = CreateStaticMeshComponent(staticActor->StaticMeshComponent);
+      continue;
     }
-    else if (UInterpActor* interpActor = Cast<UInterpActor>(actor))
+    osg::ref_ptr<osg::LOD> lod = new osg::LOD;
+    lod->setName(classifier.GetActor(idx)->GetObjectNameString().UTF8().c_str());
+    lod->setRangeMode(osg::LOD::PIXEL_SIZE_ON_SCREEN);
+    lod->addChild(new osg::Group, MLodPixelSize, FLT_MAX);
+    lod->addChild(new osg::Group, 0.f, MLodPixelSize);
+    mlods[idx] = lod;
+    outGroups.emplace_back(container, lod);
+  }
+
+  for (size_t idx = 0; idx < count; ++idx)
+  {
+    const LevelActorClassifier::ActorKind kind = classifier.GetKind(idx);
+    if (classifier.IsHidden(idx) || kind == LevelActorClassifier::ActorKind::Other)
     {
-      componentTransform = CreateStaticMeshComponent(interpActor->StaticMeshComponent);
+      continue;
     }
-    else if (USkeletalMeshActor* skelActor = Cast<USkeletalMeshActor>(actor))
+    osg::ref_ptr<osg::Group> parent = container;
+    const int32 mlodIdx = classifier.GetReplacementIndex(idx);
+    if (mlodIdx >= 0 && mlods[mlodIdx])
     {
-      componentTransform = CreateSkelMeshComponent(skelActor->SkeletalMeshComponent);
+      parent = mlods[mlodIdx]->getChild(0)->asGroup();
     }
-    else if (UPrefabInstance* prefab = Cast<UPrefabInstance>(actor))
+    else if (mlods.size() && mlods[idx])
     {
-      componentTransform = CreatePrefabInstance(prefab);
+      parent = mlods[idx]->getChild(1)->asGroup();
     }
+    outActors.push_back({ classifier.GetActor(idx), kind, parent });
+  }
+}
 
-    if (!componentTransform)
+void LevelEditor::CreateLevel(ULevel* level, osg::ref_ptr<osg::Geode> root)
+{
+  std::vector<ActorEntry> actors;
+  std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>> groups;
+  CollectLevelActors(level, root, actors, groups);
+  for (auto& pair : groups)
+  {
+    pair.first->addChild(pair.second);
+  }
+  for (const ActorEntry& entry : actors)
+  {
+    if (osg::ref_ptr<osg::MatrixTransform> mt = CreateActor(entry.Actor, entry.Kind))
     {
-      continue;
+      entry.Parent->addChild(mt);
     }
+  }
+  BuildHierarchy(root, {});
+}
 
-    osg::ref_ptr<osg::MatrixTransform> mt = new osg::MatrixTransform;
-    mt->setName(actor->GetObjectNameString().UTF8().c_str());
-    osg::Matrix m;
-    m.makeIdentity();
+osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateActor(UActor* actor, LevelActorClassifier::ActorKind kind)
+{
+  osg::ref_ptr<osg::MatrixTransform> componentTransform = nullptr;
+  switch (kind)
+  {
+  case LevelActorClassifier::ActorKind::StaticMesh:
+    componentTransform = CreateStaticMeshComponent(static_cast<UStaticMeshActor*>(actor)->StaticMeshComponent);
+    break;
+  case LevelActorClassifier::ActorKind::Interp:
+    componentTransform = CreateStaticMeshComponent(static_cast<UInterpActor*>(actor)->StaticMeshComponent);
+    break;
+  case LevelActorClassifier::ActorKind::SkeletalMesh:
+    componentTransform = CreateSkelMeshComponent(static_cast<USkeletalMeshActor*>(actor)->SkeletalMeshComponent);
+    break;
+  case LevelActorClassifier::ActorKind::Prefab:
+    componentTransform = CreatePrefabInstance(static_cast<UPrefabInstance*>(actor));
+    break;
+  default:
+    break;
+  }
 
-    FVector location = actor->GetLocation();
-    FVector rotation = actor->Rotation.Normalized().Euler();
-    FVector scale3D = actor->DrawScale3D * actor->DrawScale;
+  if (!componentTransform)
+  {
+    return nullptr;
+  }
 
-    m.preMultTranslate(osg::Vec3(location.X, -location.Y, location.Z));
+  osg::ref_ptr<osg::MatrixTransform> mt = new osg::MatrixTransform;
+  mt->setName(actor->GetObjectNameString().UTF8().c_str());
+  osg::Matrix m;
+  m.makeIdentity();
 
-    osg::Quat quat;
-    quat.makeRotate(
-      rotation.X * M_PI / 180., RollAxis,
-      rotation.Y * M_PI / 180., PitchAxis,
-      rotation.Z * M_PI / 180., YawAxis
-    );
-    m.preMultRotate(quat);
+  FVector location = actor->GetLocation();
+  FVector rotation = actor->Rotation.Normalized().Euler();
+  FVector scale3D = actor->DrawScale3D * actor->DrawScale;
 
-    m.preMultScale(osg::Vec3(scale3D.X, scale3D.Y, scale3D.Z));
+  m.preMultTranslate(osg::Vec3(location.X, -location.Y, location.Z));
 
-    mt->setMatrix(m);
-    mt->addChild(componentTransform);
-    root->addChild(mt);
-  }
+  osg::Quat quat;
+  quat.makeRotate(
+    rotation.X * M_PI / 180., RollAxis,
+    rotation.Y * M_PI / 180., PitchAxis,
+    rotation.Z * M_PI / 180., YawAxis
+  );
+  m.preMultRotate(quat);
+
+  m.preMultScale(osg::Vec3(scale3D.X, scale3D.Y, scale3D.Z));
+
+  mt->setMatrix(m);
+  mt->addChild(componentTransform);
+  return mt;
 }
 
 void LevelEditor::OnIdle(wxIdleEvent& e)
@@ -326,6 +641,62 @@ void LevelEditor::OnIdle(wxIdleEvent& e)
   Unbind(wxEVT_IDLE, &LevelEditor::OnIdle, this);
 }
 
+osg::ref_ptr<osg::Node> LevelEditor::GetStaticMeshNode(UStaticMesh* mesh)
+{
+  {
+    std::scoped_lock<std::mutex> l(MeshCacheMutex);
+    auto it = StaticMeshCache.find(mesh);
+    if (it != StaticMeshCache.end())
+    {
+      return it->second;
+    }
+  }
+  // Build outside of the lock. If another thread was faster, use its node.
+  StreamedTextures textures;
+  std::vector<osg::ref_ptr<osg::Geode>> lods;
+  for (int32 lodIdx = 0; lodIdx < MaxMeshLods && mesh->GetLod(lodIdx); ++lodIdx)
+  {
+    lods.emplace_back(CreateStaticMeshGeode(mesh, lodIdx, textures));
+  }
+  osg::ref_ptr<osg::Node> node = CreateLodNode(lods);
+  std::scoped_lock<std::mutex> l(MeshCacheMutex);
+  auto it = StaticMeshCache.find(mesh);
+  if (it != StaticMeshCache.end())
+  {
+    return it->second;
+  }
+  // Register textures before the node is shared, so no other thread attaches it half initialized
+  AddStreamedTextures(textures);
+  return StaticMeshCache.emplace(mesh, node).first->second;
+}
+
+osg::ref_ptr<osg::Node> LevelEditor::GetSkelMeshNode(USkeletalMesh* mesh)
+{
+  {
+    std::scoped_lock<std::mutex> l(MeshCacheMutex);
+    auto it = SkelMeshCache.find(mesh);
+    if (it != SkelMeshCache.end())
+    {
+      return it->second;
+    }
+  }
+  StreamedTextures textures;
+  std::vector<osg::ref_ptr<osg::Geode>> lods;
+  for (int32 lodIdx = 0; lodIdx < MaxMeshLods && mesh->GetLod(lodIdx); ++lodIdx)
+  {
+    lods.emplace_back(CreateSkelMeshGeode(mesh, lodIdx, textures));
+  }
+  osg::ref_ptr<osg::Node> node = CreateLodNode(lods);
+  std::scoped_lock<std::mutex> l(MeshCacheMutex);
+  auto it = SkelMeshCache.find(mesh);
+  if (it != SkelMeshCache.end())
+  {
+    return it->second;
+  }
+  AddStreamedTextures(textures);
+  return SkelMeshCache.emplace(mesh, node).first->second;
+}
+
 osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateStaticMeshComponent(UStaticMeshComponent* component)
 {
   if (!component)
@@ -339,24 +710,57 @@ osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateStaticMeshComponent(UStati
     return nullptr;
   }
 
-  const FStaticMeshRenderData* model = mesh->GetLod(0);
+  osg::ref_ptr<osg::Node> node = GetStaticMeshNode(mesh);
+  if (!node)
+  {
+    return nullptr;
+  }
+
+  FVector translation = component->Translation;
+  FVector rotation = component->Rotation.Normalized().Euler();
+  FVector scale3d = component->Scale3D * component->Scale;
+
+  osg::ref_ptr<osg::MatrixTransform> mt = new osg::MatrixTransform;
+  mt->setName(component->GetObjectNameString().UTF8().c_str());
+  osg::Matrix m;
+  m.makeIdentity();
+
+  m.preMultTranslate(osg::Vec3(translation.X, -translation.Y, translation.Z));
+
+  osg::Quat quat;
+  quat.makeRotate(
+    rotation.X * M_PI / 180., RollAxis,
+    rotation.Y * M_PI / 180., PitchAxis,
+    rotation.Z * M_PI / 180., YawAxis
+  );
+  m.preMultRotate(quat);
+
+  m.preMultScale(osg::Vec3(scale3d.X, scale3d.Y, scale3d.Z));
+
+  mt->setMatrix(m);
+  mt->addChild(node);
 
-  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
-  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array(osg::Array::BIND_PER_VERTEX);
+  return mt;
+}
 
-  std::vector<FStaticVertex> uvertices = model->GetVertices();
-  for (auto & uvertex : uvertices)
+void LevelEditor::AddStreamedTextures(const StreamedTextures& textures)
+{
+  for (const auto& p : textures)
   {
-    FVector normal = uvertex.TangentZ;
-    normals->push_back(osg::Vec3(normal.X, -normal.Y, normal.Z));
-    vertices->push_back(osg::Vec3(uvertex.Position.X, -uvertex.Position.Y, uvertex.Position.Z));
-    uvs->push_back(osg::Vec2(uvertex.UVs[0].X, uvertex.UVs[0].Y));
+    Streamer->Add(p.first, p.second);
   }
+}
+
+osg::ref_ptr<osg::Geode> LevelEditor::CreateStaticMeshGeode(UStaticMesh* mesh, int32 lodIdx, StreamedTextures& outTextures)
+{
+  const FStaticMeshRenderData* model = mesh->GetLod(lodIdx);
+
+  OSGMeshBuffers buffers(model);
 
   osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+  std::vector<UTexture2D*> textures;
+  const size_t firstTexture = outTextures.size();
   std::vector<FStaticMeshElement> elements = model->GetElements();
-  const FRawIndexBuffer& indexContainer = model->IndexBuffer;
   int32 drawableCount = 0;
   for (const FStaticMeshElement& section : elements)
   {
@@ -364,35 +768,19 @@ osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateStaticMeshComponent(UStati
     {
       continue;
     }
-    osg::ref_ptr <osg::Geometry> geo = new osg::Geometry;
-    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
-    for (uint32 faceIndex = 0; faceIndex < section.NumTriangles; ++faceIndex)
+    osg::ref_ptr<osg::Geometry> geo = buffers.CreateSection(section.FirstIndex, section.NumTriangles);
+    if (!geo)
     {
-      indices->push_back(indexContainer.GetIndex(section.FirstIndex + (faceIndex * 3) + 0));
-      indices->push_back(indexContainer.GetIndex(section.FirstIndex + (faceIndex * 3) + 1));
-      indices->push_back(indexContainer.GetIndex(section.FirstIndex + (faceIndex * 3) + 2));
+      continue;
     }
-    geo->addPrimitiveSet(indices);
-    geo->setVertexArray(vertices);
-    geo->setNormalArray(normals);
-    geo->setTexCoordArray(0, uvs);
 
     osg::ref_ptr<osg::BlendFunc> blendMasked = new osg::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     if (UMaterialInterface* material = Cast<UMaterialInterface>(section.Material))
     {
       if (UTexture2D* tex = material->GetDiffuseTexture())
       {
-        osg::ref_ptr<osg::Image> img = new osg::Image;
-        UTextureBitmapInfo info;
-        if (tex->GetBitmapData(info) && info.IsValid())
-        {
-          img->setImage(info.Width, info.Height, 0, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
-        }
-        osg::ref_ptr<osg::Texture2D> osgtex = new osg::Texture2D(img);
-        osgtex->setUseHardwareMipMapGeneration(true);
-        osgtex->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::REPEAT);
-        osgtex->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::REPEAT);
-        geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex);
+        outTextures.emplace_back(geo->getOrCreateStateSet(), tex);
+        textures.push_back(tex);
         if (material->GetBlendMode() == EBlendMode::BLEND_Masked)
         {
           geo->getOrCreateStateSet()->setAttributeAndModes(blendMasked);
@@ -409,6 +797,35 @@ osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateStaticMeshComponent(UStati
   }
 
   if (!drawableCount)
+  {
+    outTextures.resize(firstTexture);
+    return nullptr;
+  }
+
+  geode->setName((mesh->GetObjectNameString().UTF8() + "_LOD" + std::to_string(lodIdx)).c_str());
+  geode->setDataVariance(osg::Object::STATIC);
+  if (textures.size())
+  {
+    geode->setCullCallback(new TextureStreamer::CullCallback(Streamer, textures));
+  }
+  return geode;
+}
+
+osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateSkelMeshComponent(USkeletalMeshComponent* component)
+{
+  if (!component)
+  {
+    return nullptr;
+  }
+
+  USkeletalMesh* mesh = component->SkeletalMesh;
+  if (!mesh)
+  {
+    return nullptr;
+  }
+
+  osg::ref_ptr<osg::Node> node = GetSkelMeshNode(mesh);
+  if (!node)
   {
     return nullptr;
   }
@@ -435,56 +852,27 @@ osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateStaticMeshComponent(UStati
   m.preMultScale(osg::Vec3(scale3d.X, scale3d.Y, scale3d.Z));
 
   mt->setMatrix(m);
-  mt->addChild(geode);
+  mt->addChild(node);
 
   return mt;
 }
 
-osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateSkelMeshComponent(USkeletalMeshComponent* component)
+osg::ref_ptr<osg::Geode> LevelEditor::CreateSkelMeshGeode(USkeletalMesh* mesh, int32 lodIdx, StreamedTextures& outTextures)
 {
-  if (!component)
-  {
-    return nullptr;
-  }
-
-  USkeletalMesh* mesh = component->SkeletalMesh;
-  if (!mesh)
-  {
-    return nullptr;
-  }
+  const FStaticLODModel* model = mesh->GetLod(lodIdx);
 
-  const FStaticLODModel* model = mesh->GetLod(0);
-
-  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
-  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array(osg::Array::BIND_PER_VERTEX);
-
-  std::vector<FSoftSkinVertex> uvertices = model->GetVertices();
-  for (int32 idx = 0; idx < uvertices.size(); ++idx)
-  {
-    FVector normal = uvertices[idx].TangentZ;
-    normals->push_back(osg::Vec3(normal.X, -normal.Y, normal.Z));
-    vertices->push_back(osg::Vec3(uvertices[idx].Position.X, -uvertices[idx].Position.Y, uvertices[idx].Position.Z));
-    uvs->push_back(osg::Vec2(uvertices[idx].UVs[0].X, uvertices[idx].UVs[0].Y));
-  }
+  OSGMeshBuffers buffers(model);
 
   osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+  std::vector<UTexture2D*> textures;
   std::vector<const FSkelMeshSection*> sections = model->GetSections();
-  const FMultiSizeIndexContainer* indexContainer = model->GetIndexContainer();
   for (const FSkelMeshSection* section : sections)
   {
-    osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
-    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
-    for (uint32 faceIndex = 0; faceIndex < section->NumTriangles; ++faceIndex)
+    osg::ref_ptr<osg::Geometry> geo = buffers.CreateSection(section->BaseIndex, section->NumTriangles);
+    if (!geo)
     {
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 0));
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 1));
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 2));
+      continue;
     }
-    geo->addPrimitiveSet(indices);
-    geo->setVertexArray(vertices);
-    geo->setNormalArray(normals);
-    geo->setTexCoordArray(0, uvs);
 
     // TODO: Use MaterialMap to remap section materials to the global materials list
     osg::ref_ptr<osg::BlendFunc> blendMasked = new osg::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -494,16 +882,8 @@ osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateSkelMeshComponent(USkeleta
       {
         if (UTexture2D* tex = material->GetDiffuseTexture())
         {
-          osg::ref_ptr<osg::Image> img = new osg::Image;
-          UTextureBitmapInfo info(64);
-          if (tex->GetBitmapData(info) && info.IsValid())
-          {
-            img->setImage(info.Width, info.Height, 0, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
-          }
-          osg::ref_ptr<osg::Texture2D> osgtex = new osg::Texture2D(img);
-          osgtex->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::REPEAT);
-          osgtex->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::REPEAT);
-          geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex);
+          outTextures.emplace_back(geo->getOrCreateStateSet(), tex);
+          textures.push_back(tex);
           if (material->GetBlendMode() == EBlendMode::BLEND_Masked)
           {
             geo->getOrCreateStateSet()->setAttributeAndModes(blendMasked);
@@ -515,31 +895,13 @@ osg::ref_ptr<osg::MatrixTransform> LevelEditor::CreateSkelMeshComponent(USkeleta
     geode->addDrawable(geo);
   }
 
-  FVector translation = component->Translation;
-  FVector rotation = component->Rotation.Normalized().Euler();
-  FVector scale3d = component->Scale3D * component->Scale;
-
-  osg::ref_ptr<osg::MatrixTransform> mt = new osg::MatrixTransform;
-  mt->setName(component->GetObjectNameString().UTF8().c_str());
-  osg::Matrix m;
-  m.makeIdentity();
-
-  m.preMultTranslate(osg::Vec3(translation.X, -translation.Y, translation.Z));
-
-  osg::Quat quat;
-  quat.makeRotate(
-    rotation.X * M_PI / 180., RollAxis,
-    rotation.Y * M_PI / 180., PitchAxis,
-    rotation.Z * M_PI / 180., YawAxis
-  );
-  m.preMultRotate(quat);
-
-  m.preMultScale(osg::Vec3(scale3d.X, scale3d.Y, scale3d.Z));
-
-  mt->setMatrix(m);
-  mt->addChild(geode);
-
-  return mt;
+  geode->setName((mesh->GetObjectNameString().UTF8() + "_LOD" + std::to_string(lodIdx)).c_str());
+  geode->setDataVariance(osg::Object::STATIC);
+  if (textures.size())
+  {
+    geode->setCullCallback(new TextureStreamer::CullCallback(Streamer, textures));
+  }
+  return geode;
 }
 
 osg::ref_ptr<osg::Geode> LevelEditor::CreateStreamingLevelVolumeActor(ULevelStreamingVolume* actor)
@@ -6,13 +6,20 @@
 
 #include "../CustomViews/OSGView.h"
 #include "../Windows/LevelExportOptions.h"
+#include "../Misc/LevelActorClassifier.h"
+#include "../Misc/TextureStreamer.h"
 #include <osg/MatrixTransform>
 
+#include <atomic>
 #include <unordered_map>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 class UActor;
 class ULevel;
+class UStaticMesh;
+class USkeletalMesh;
 class UPrefabInstance;
 class ULevelStreamingVolume;
 
@@ -20,13 +27,17 @@ class ProgressWindow;
 
 class LevelEditor : public GenericEditor {
 public:
+  // Actor queued for the scene build with the node it attaches to
+  struct ActorEntry {
+    UActor* Actor = nullptr;
+    LevelActorClassifier::ActorKind Kind = LevelActorClassifier::ActorKind::Other;
+    osg::ref_ptr<osg::Group> Parent;
+  };
+
   using GenericEditor::GenericEditor;
   LevelEditor(wxPanel* parent, PackageWindow* window);
 
-  ~LevelEditor() override
-  {
-    delete Renderer;
-  }
+  ~LevelEditor() override;
 
   void OnTick() override;
   void OnObjectLoaded() override;
@@ -43,8 +54,16 @@ protected:
   void CreateRenderer();
   void LoadPersistentLevel();
   void CreateLevel(ULevel* level, osg::ref_ptr<osg::Geode> root);
+  // Build actors of the persistent and streamed levels in batches, closest to the camera first
+  void BuildSceneAsync();
+  // Attach nodes built by BuildSceneAsync to the scene. Called from OnTick.
+  void ApplyLoadedNodes();
+  // Collect visible actors of the level and the groups they attach to. Actors replaced by an MLOD
+  // go to an osg::LOD that shows them up close and the MLOD actor at distance.
+  void CollectLevelActors(ULevel* level, osg::ref_ptr<osg::Group> container, std::vector<ActorEntry>& outActors, std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>>& outGroups);
+  osg::ref_ptr<osg::MatrixTransform> CreateActor(UActor* actor, LevelActorClassifier::ActorKind kind);
   void PrepareToExportLevel(LevelExportContext& ctx);
-  void ExportLevel(class T3DFile& file, ULevel* level, LevelExportContext& ctx, ProgressWindow* progress);
+  void ExportLevel(class T3DWriter& file, ULevel* level, LevelExportContext& ctx, ProgressWindow* progress);
   bool ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWindow* progress);
   void OnIdle(wxIdleEvent& e);
 
@@ -53,11 +72,44 @@ protected:
   osg::ref_ptr<osg::MatrixTransform> CreatePrefabInstance(UPrefabInstance* instance);
   osg::ref_ptr<osg::Geode> CreateStreamingLevelVolumeActor(ULevelStreamingVolume* actor);
 
+  // State sets of a mesh node and their diffuse textures
+  typedef std::vector<std::pair<osg::ref_ptr<osg::StateSet>, UTexture2D*>> StreamedTextures;
+
+  // Geometry is built once per mesh and shared by all components that use it. Meshes with
+  // multiple LODs are wrapped into an osg::LOD that switches them by the screen size. Thread safe.
+  // Textures are registered in the streamer only for the node that ends up in the cache.
+  osg::ref_ptr<osg::Node> GetStaticMeshNode(UStaticMesh* mesh);
+  osg::ref_ptr<osg::Node> GetSkelMeshNode(USkeletalMesh* mesh);
+  osg::ref_ptr<osg::Geode> CreateStaticMeshGeode(UStaticMesh* mesh, int32 lodIdx, StreamedTextures& outTextures);
+  osg::ref_ptr<osg::Geode> CreateSkelMeshGeode(USkeletalMesh* mesh, int32 lodIdx, StreamedTextures& outTextures);
+  void AddStreamedTextures(const StreamedTextures& textures);
+  // Stop the scene build and wait for the worker. Nodes that were not attached yet are dropped.
+  void CancelSceneLoading();
+  // Export reads the same objects the scene build does, so it is disabled until the build ends
+  void UpdateExportTool();
+
 protected:
   ULevel* Level = nullptr;
   bool LevelLoaded = false;
   bool ShowEmptyMessage = false;
   std::unordered_map<UActor*, osg::ref_ptr<osg::Geode>> LevelNodes;
+  std::unordered_map<UStaticMesh*, osg::ref_ptr<osg::Node>> StaticMeshCache;
+  std::unordered_map<USkeletalMesh*, osg::ref_ptr<osg::Node>> SkelMeshCache;
+  std::mutex MeshCacheMutex;
+  osg::ref_ptr<TextureStreamer> Streamer;
+
+  std::thread LoadThread;
+  std::atomic_bool CancelLoading = false;
+  bool IsLoading = false;
+  std::mutex PendingMutex;
+  std::vector<std::pair<osg::ref_ptr<osg::Group>, osg::ref_ptr<osg::Node>>> PendingNodes;
+  // Level containers that get a bounding volume hierarchy once loading finishes
+  std::vector<osg::ref_ptr<osg::Group>> LevelGroups;
+  bool LoadingFinished = false;
+  bool HomeReady = false;
+  osg::Vec3 HomeEye;
+  osg::Vec3 HomeCenter;
+  int32 LoadedActorCount = 0;
   osg::ref_ptr<osg::Geode> Root = nullptr;
   OSGCanvas* Canvas = nullptr;
   OSGWindow* OSGProxy = nullptr;
@@ -2,6 +2,11 @@
 #include "../App.h"
 #include "../Windows/ProgressWindow.h"
 #include "../Windows/REDialogs.h"
+#include "../Misc/ATrace.h"
+#include "../Misc/T3DWriter.h"
+#include "../Misc/TerrainRaster.h"
+#include "../Misc/TextureDecoder.h"
+#include "../Misc/TextureFormats.h"
 
 #include <Tera/Cast.h>
 #include <Tera/FPackage.h>
@@ -21,25 +26,40 @@
 #include <Tera/UPrefab.h>
 #include <Tera/UModel.h>
 
-#include <Tera/Utils/APerfSamples.h>
 #include <Tera/Utils/T3DUtils.h>
 #include <Tera/Utils/MeshUtils.h>
 #include <Tera/Utils/TextureUtils.h>
 
+#include <atomic>
+#include <chrono>
+#include <execution>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 const char* VSEP = "\t";
 
 #define TEST_MAT_EXPS_EXPORT 0
 
-typedef std::function<void(T3DFile&, LevelExportContext&, UActorComponent*)> ComponentDataFunc;
+typedef std::function<void(T3DWriter&, LevelExportContext&, UActorComponent*)> ComponentDataFunc;
 
-void AddCommonPrimitiveComponentParameters(T3DFile& f, LevelExportContext& ctx, UPrimitiveComponent* component);
+void AddCommonPrimitiveComponentParameters(T3DWriter& f, LevelExportContext& ctx, UPrimitiveComponent* component);
 std::vector<UObject*> SaveMaterialMap(UMeshComponent* component, LevelExportContext& ctx, const std::vector<UObject*>& materials);
 
-void ExportActor(T3DFile& f, LevelExportContext& ctx, UActor* untypedActor);
-void ExportTerrainActor(T3DFile& f, LevelExportContext& ctx, UTerrain* actor);
-void ExportLandscapeActor(T3DFile& f, LevelExportContext& ctx, ULandscape* actor);
+void ExportActor(T3DWriter& f, LevelExportContext& ctx, UActor* untypedActor);
+void ExportTerrainActor(T3DWriter& f, LevelExportContext& ctx, UTerrain* actor);
+void ExportLandscapeActor(T3DWriter& f, LevelExportContext& ctx, ULandscape* actor);
+void ExportWaves(LevelExportContext& ctx, ProgressWindow& progress);
+void ExportCues(LevelExportContext& ctx);
+
+uint64 GetFileSize(const std::filesystem::path& path)
+{
+  std::error_code err;
+  const uintmax_t size = std::filesystem::file_size(path, err);
+  return err ? 0 : size;
+}
 
 std::string GetActorName(UObject* actor)
 {
@@ -555,7 +575,7 @@ void ExportMaterialExpressions(UMaterial* material, FString& output)
   }
 }
 
-ComponentDataFunc ExportStaticMeshComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportStaticMeshComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   UStaticMeshComponent* component = Cast<UStaticMeshComponent>(acomp);
   if (!component || !component->StaticMesh)
   {
@@ -592,26 +612,35 @@ ComponentDataFunc ExportStaticMeshComponentData = [](T3DFile& f, LevelExportCont
   materials = SaveMaterialMap(component, ctx, materials);
   for (int32 idx = 0; idx < materials.size(); ++idx)
   {
-    FString item = "None";
-    if (materials[idx])
+    if (!materials[idx])
     {
-      item = FString::Sprintf("%s'\"/Game/%s/%s%s\"'", materials[idx]->GetClassNameString().UTF8().c_str(), ctx.DataDirName, materials[idx]->GetLocalDir(false, "/").UTF8().c_str(), materials[idx]->GetObjectNameString().UTF8().c_str());
+      f.AddCustom("OverrideMaterials", idx, "None");
+      continue;
     }
-    f.AddCustom(FString::Sprintf("OverrideMaterials(%d)", idx).UTF8().c_str(), item.UTF8().c_str());
+    std::string path = "/Game/" + std::string(ctx.DataDirName) + "/" + materials[idx]->GetLocalDir(false, "/").UTF8() + materials[idx]->GetObjectNameString().UTF8();
+    f.AddReference("OverrideMaterials", idx, materials[idx]->GetClassNameString().UTF8(), path);
   }
   std::filesystem::path path = ctx.GetStaticMeshDir() / component->StaticMesh->GetLocalDir().UTF8();
   std::error_code err;
-  if (!std::filesystem::exists(path, err))
+  if (!ctx.DryRun && !std::filesystem::exists(path, err))
   {
     std::filesystem::create_directories(path, err);
   }
   std::string fbxName = component->StaticMesh->GetObjectNameString().UTF8();
-  if (std::filesystem::exists(path, err))
+  if (ctx.DryRun || std::filesystem::exists(path, err))
   {
     path /= fbxName;
     path.replace_extension("fbx");
-    if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
+    if (ctx.DryRun)
+    {
+      if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
+      {
+        ctx.Report.AddItem(LevelExportReport::StaticMeshes, 0, component->StaticMesh);
+      }
+    }
+    else if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
     {
+      LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::StaticMeshes);
       auto utils = MeshUtils::CreateUtils(MeshExporterType::MET_Fbx);
       utils->SetCreatorInfo(App::GetSharedApp()->GetAppDisplayName().ToStdString(), GetAppVersion());
       MeshExportContext fbxCtx;
@@ -628,6 +657,7 @@ ComponentDataFunc ExportStaticMeshComponentData = [](T3DFile& f, LevelExportCont
       {
         ctx.Errors.emplace_back("Error: Failed to save static mesh " + component->StaticMesh->GetLocalDir(true).UTF8() + " of " + GetActorName(component->GetOuter()));
       }
+      ctx.Report.AddItem(LevelExportReport::StaticMeshes, GetFileSize(path));
     }
     f.AddStaticMesh((std::string(ctx.DataDirName) + "/" + component->StaticMesh->GetLocalDir(false, "/").UTF8() + fbxName).c_str());
   }
@@ -661,7 +691,7 @@ ComponentDataFunc ExportStaticMeshComponentData = [](T3DFile& f, LevelExportCont
   }
 };
 
-ComponentDataFunc ExportSkeletalMeshComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportSkeletalMeshComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   USkeletalMeshComponent* component = Cast<USkeletalMeshComponent>(acomp);
   if (!component || !component->SkeletalMesh)
   {
@@ -697,26 +727,35 @@ ComponentDataFunc ExportSkeletalMeshComponentData = [](T3DFile& f, LevelExportCo
   materials = SaveMaterialMap(component, ctx, materials);
   for (int32 idx = 0; idx < materials.size(); ++idx)
   {
-    FString item = "None";
-    if (materials[idx])
+    if (!materials[idx])
     {
-      item = FString::Sprintf("%s'\"/Game/%s/%s%s\"'", materials[idx]->GetClassNameString().UTF8().c_str(), ctx.DataDirName, materials[idx]->GetLocalDir(false, "/").UTF8().c_str(), materials[idx]->GetObjectNameString().UTF8().c_str());
+      f.AddCustom("OverrideMaterials", idx, "None");
+      continue;
     }
-    f.AddCustom(FString::Sprintf("OverrideMaterials(%d)", idx).UTF8().c_str(), item.UTF8().c_str());
+    std::string path = "/Game/" + std::string(ctx.DataDirName) + "/" + materials[idx]->GetLocalDir(false, "/").UTF8() + materials[idx]->GetObjectNameString().UTF8();
+    f.AddReference("OverrideMaterials", idx, materials[idx]->GetClassNameString().UTF8(), path);
   }
   std::filesystem::path path = ctx.GetSkeletalMeshDir() / component->SkeletalMesh->GetLocalDir().UTF8();
   std::error_code err;
-  if (!std::filesystem::exists(path, err))
+  if (!ctx.DryRun && !std::filesystem::exists(path, err))
   {
     std::filesystem::create_directories(path, err);
   }
-  if (std::filesystem::exists(path, err))
+  if (ctx.DryRun || std::filesystem::exists(path, err))
   {
     std::string fbxName = component->SkeletalMesh->GetObjectNameString().UTF8();
     path /= fbxName;
     path.replace_extension("fbx");
-    if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
+    if (ctx.DryRun)
+    {
+      if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
+      {
+        ctx.Report.AddItem(LevelExportReport::SkeletalMeshes, 0, component->SkeletalMesh);
+      }
+    }
+    else if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
     {
+      LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::SkeletalMeshes);
       auto utils = MeshUtils::CreateUtils(MeshExporterType::MET_Fbx);
       utils->SetCreatorInfo(App::GetSharedApp()->GetAppDisplayName().ToStdString(), GetAppVersion());
       MeshExportContext fbxCtx;
@@ -732,6 +771,7 @@ ComponentDataFunc ExportSkeletalMeshComponentData = [](T3DFile& f, LevelExportCo
       {
         ctx.Errors.emplace_back("Error: Failed to save skeletal mesh " + component->SkeletalMesh->GetLocalDir(true).UTF8() + " of " + GetActorName(component->GetOuter()));
       }
+      ctx.Report.AddItem(LevelExportReport::SkeletalMeshes, GetFileSize(path));
     }
     f.AddSkeletalMesh((std::string(ctx.DataDirName) + "/" + component->SkeletalMesh->GetLocalDir(false, "/").UTF8() + fbxName).c_str());
   }
@@ -742,7 +782,7 @@ ComponentDataFunc ExportSkeletalMeshComponentData = [](T3DFile& f, LevelExportCo
   AddCommonPrimitiveComponentParameters(f, ctx, component);
 };
 
-ComponentDataFunc ExportSpeedTreeComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportSpeedTreeComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   USpeedTreeComponent* component = Cast<USpeedTreeComponent>(acomp);
   if (!component || !component->SpeedTree)
   {
@@ -892,11 +932,11 @@ ComponentDataFunc ExportSpeedTreeComponentData = [](T3DFile& f, LevelExportConte
     UActor* actor = Cast<UActor>(component->GetOuter());
     
     std::filesystem::path path = ctx.GetMaterialMapDir();
-    if (!std::filesystem::exists(path, err))
+    if (!ctx.DryRun && !std::filesystem::exists(path, err))
     {
       std::filesystem::create_directories(path, err);
     }
-    if (std::filesystem::exists(path, err))
+    if (!ctx.DryRun && std::filesystem::exists(path, err))
     {
       path /= component->GetPackage()->GetPackageName().UTF8() + "_" + (actor ? (UObject*)actor : (UObject*)component)->GetObjectNameString().UTF8();
       path.replace_extension("txt");
@@ -926,22 +966,31 @@ ComponentDataFunc ExportSpeedTreeComponentData = [](T3DFile& f, LevelExportConte
   }
   std::filesystem::path path = ctx.GetSpeedTreeDir() / component->SpeedTree->GetLocalDir().UTF8();
   std::error_code err;
-  if (!std::filesystem::exists(path, err))
+  if (!ctx.DryRun && !std::filesystem::exists(path, err))
   {
     std::filesystem::create_directories(path, err);
   }
-  if (std::filesystem::exists(path, err))
+  if (ctx.DryRun || std::filesystem::exists(path, err))
   {
     path /= component->SpeedTree->GetObjectNameString().UTF8();
     path.replace_extension("spt");
-    if (!std::filesystem::exists(path, err))
+    if (ctx.DryRun)
     {
+      if (!std::filesystem::exists(path, err))
+      {
+        ctx.Report.AddItem(LevelExportReport::SpeedTrees, 0, component->SpeedTree);
+      }
+    }
+    else if (!std::filesystem::exists(path, err))
+    {
+      LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::SpeedTrees);
       void* sptData = nullptr;
       FILE_OFFSET sptDataSize = 0;
       component->SpeedTree->GetSptData(&sptData, &sptDataSize, true);
       std::ofstream s(path, std::ios::out | std::ios::trunc | std::ios::binary);
       s.write((const char*)sptData, sptDataSize);
       free(sptData);
+      ctx.Report.AddItem(LevelExportReport::SpeedTrees, sptDataSize);
     }
     f.AddStaticMesh((std::string(ctx.DataDirName) + "/" + component->SpeedTree->GetLocalDir(true, "/").UTF8()).c_str());
   }
@@ -952,7 +1001,7 @@ ComponentDataFunc ExportSpeedTreeComponentData = [](T3DFile& f, LevelExportConte
   AddCommonPrimitiveComponentParameters(f, ctx, component);
 };
 
-ComponentDataFunc ExportPointLightComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportPointLightComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   UPointLightComponent* component = Cast<UPointLightComponent>(acomp);
   if (!component)
   {
@@ -981,7 +1030,7 @@ ComponentDataFunc ExportPointLightComponentData = [](T3DFile& f, LevelExportCont
   }
 };
 
-ComponentDataFunc ExportSpotLightComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportSpotLightComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   USpotLightComponent* component = Cast<USpotLightComponent>(acomp);
   if (!component)
   {
@@ -1012,7 +1061,7 @@ ComponentDataFunc ExportSpotLightComponentData = [](T3DFile& f, LevelExportConte
   }
 };
 
-ComponentDataFunc ExportDirectionalLightComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportDirectionalLightComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   UDirectionalLightComponent* component = Cast<UDirectionalLightComponent>(acomp);
   if (!component)
   {
@@ -1038,7 +1087,7 @@ ComponentDataFunc ExportDirectionalLightComponentData = [](T3DFile& f, LevelExpo
   }
 };
 
-ComponentDataFunc ExportSkyLightComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportSkyLightComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   USkyLightComponent* component = Cast<USkyLightComponent>(acomp);
   if (!component)
   {
@@ -1069,7 +1118,7 @@ ComponentDataFunc ExportSkyLightComponentData = [](T3DFile& f, LevelExportContex
   }
 };
 
-ComponentDataFunc ExportHeightFogComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportHeightFogComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   UHeightFogComponent* component = Cast<UHeightFogComponent>(acomp);
   if (!component)
   {
@@ -1085,7 +1134,7 @@ ComponentDataFunc ExportHeightFogComponentData = [](T3DFile& f, LevelExportConte
   f.AddLinearColor("FogInscatteringColor", component->LightColor);
 };
 
-ComponentDataFunc ExportVolumeComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportVolumeComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   UBrushComponent* component = Cast<UBrushComponent>(acomp);
   if (!component)
   {
@@ -1156,7 +1205,7 @@ ComponentDataFunc ExportVolumeComponentData = [](T3DFile& f, LevelExportContext&
   }
 };
 
-ComponentDataFunc ExportAudioComponentData = [](T3DFile& f, LevelExportContext& ctx, UActorComponent* acomp) {
+ComponentDataFunc ExportAudioComponentData = [](T3DWriter& f, LevelExportContext& ctx, UActorComponent* acomp) {
   UAmbientSound* sound = acomp->GetTypedOuter<UAmbientSound>();
   if (!sound)
   {
@@ -1170,7 +1219,7 @@ ComponentDataFunc ExportAudioComponentData = [](T3DFile& f, LevelExportContext&
 
   std::vector<USoundNodeWave*> waves;
   cue->GetWaves(waves);
-  ctx.Waves.insert(ctx.Waves.end(), waves.begin(), waves.end());
+  ctx.Waves.insert(waves.begin(), waves.end());
 
   std::string asset = "Game/" + std::string(ctx.DataDirName) + '/';
   FString cueData = asset + cue->ExportCueToText(!Cast<UAmbientSoundNonLoop>(sound), ctx.Config.GlobalScale);
@@ -1280,7 +1329,7 @@ struct T3DComponent {
     , Scale(actor->DrawScale)
   {}
 
-  void Declare(T3DFile& f) const
+  void Declare(T3DWriter& f) const
   {
     f.Begin("Object", Class.UTF8().c_str(), Name.UTF8().c_str());
     for (const auto& p : ChildComponents)
@@ -1320,7 +1369,7 @@ struct T3DComponent {
     Scale = component->Scale;
   }
 
-  void Define(T3DFile& f, LevelExportContext& ctx) const
+  void Define(T3DWriter& f, LevelExportContext& ctx) const
   {
     f.Begin("Object", nullptr, Name.UTF8().c_str());
     if (DataFunc && ActorComponent)
@@ -1388,7 +1437,7 @@ struct T3DComponent {
 
     if (Parent)
     {
-      f.AddCustom("AttachParent", FString::Sprintf("%s'\"%s\"'", Parent->Class.UTF8().c_str(), Parent->Name.UTF8().c_str()).UTF8().c_str());
+      f.AddReference("AttachParent", Parent->Class.UTF8(), Parent->Name.UTF8());
     }
     else if (IsInstance)
     {
@@ -2080,8 +2129,12 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
   ProgressWindow progress(this, "Please wait...");
   progress.SetActionText("Preparing...");
   progress.SetCurrentProgress(-1);
+  if (ctx.DryRun)
+  {
+    ctx.Report.LoadHistory();
+  }
   std::thread([&] {
-    PERF_START(LevelExport);
+    TRACE_START(LevelExport);
     for (UObject* inner : worldInner)
     {
       if (ULevelStreaming* streamedLevel = Cast<ULevelStreaming>(inner))
@@ -2099,31 +2152,50 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
       }
     }
 
-    SendEvent(&progress, UPDATE_MAX_PROGRESS, maxProgress);
+    progress.GetReporter().SetMaxProgress(maxProgress);
 
-    T3DFile file;
+    T3DWriter file;
     if (!ctx.Config.SplitT3D)
     {
       file.InitializeMap();
     }
-    for (ULevel* level : levels)
     {
-      ExportLevel(file, level, ctx, &progress);
+      TRACE_SCOPE("Actors");
+      const auto actorsStart = std::chrono::steady_clock::now();
+      for (ULevel* level : levels)
+      {
+        ExportLevel(file, level, ctx, &progress);
 
-      if (progress.IsCanceled())
+        if (progress.IsCanceled())
+        {
+          SendEvent(&progress, UPDATE_PROGRESS_FINISH);
+          return;
+        }
+      }
+      // Meshes and terrains are exported during the actors pass. Keep their time out of the actors phase.
+      double actorsTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - actorsStart).count();
+      for (LevelExportReport::Phase phase : { LevelExportReport::StaticMeshes, LevelExportReport::SkeletalMeshes, LevelExportReport::SpeedTrees, LevelExportReport::Terrains })
       {
-        SendEvent(&progress, UPDATE_PROGRESS_FINISH);
-        return;
+        actorsTime -= ctx.Report.GetStats(phase).Seconds;
       }
+      ctx.Report.AddTime(LevelExportReport::Actors, std::max(actorsTime, 0.));
     }
     if (!ctx.Config.SplitT3D)
     {
       file.FinalizeMap();
+      ctx.Report.AddBytes(LevelExportReport::Actors, file.GetSize());
       std::filesystem::path dst = std::filesystem::path(ctx.Config.RootDir.WString()) / Level->GetPackage()->GetPackageName().WString();
       dst.replace_extension("t3d");
-      file.Save(dst);
+      if (ctx.DryRun)
+      {
+        file.Discard();
+      }
+      else if (!file.Save(dst))
+      {
+        ctx.Errors.emplace_back("Error! Failed to write " + dst.u8string() + "!");
+      }
     }
-    if (ctx.Config.GetClassEnabled(FMapExportConfig::ActorClass::Terrains) && ctx.TerrainInfo.size())
+    if (ctx.TerrainInfo.size() && ctx.Config.GetClassEnabled(FMapExportConfig::ActorClass::Terrains) && !ctx.DryRun)
     {
       std::ofstream s(std::filesystem::path(ctx.Config.RootDir.WString()) / "Terrains.txt");
       for (const std::string& item : ctx.TerrainInfo)
@@ -2131,7 +2203,7 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
         s << item;
       }
     }
-    if (ctx.ComplexCollisions.size())
+    if (ctx.ComplexCollisions.size() && !ctx.DryRun)
     {
       std::ofstream s(std::filesystem::path(ctx.Config.RootDir.WString()) / "ComplexCollisions.txt");
       for (const std::string& item : ctx.ComplexCollisions)
@@ -2139,7 +2211,7 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
         s << item << '\n';
       }
     }
-    if (ctx.MLODs.size())
+    if (ctx.MLODs.size() && !ctx.DryRun)
     {
       std::ofstream s(std::filesystem::path(ctx.Config.RootDir.WString()) / "MLODs.txt");
       for (const auto& p : ctx.MLODs)
@@ -2153,71 +2225,20 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
     }
     if (ctx.Waves.size())
     {
-      SendEvent(&progress, UPDATE_PROGRESS_DESC, wxString("Saving waves..."));
-      std::vector<USoundNodeWave*> waves;
-      for (UObject* obj : ctx.Waves)
-      {
-        if (USoundNodeWave* wave = Cast<USoundNodeWave>(obj))
-        {
-          wave->Load();
-          if (std::find(waves.begin(), waves.end(), wave) == waves.end())
-          {
-            waves.emplace_back(wave);
-          }
-        }
-      }
-      maxProgress = waves.size();
-      SendEvent(&progress, UPDATE_MAX_PROGRESS, maxProgress);
-      int32 curProgress = 0;
-      for (USoundNodeWave* wave : waves)
+      progress.GetReporter().SetActionText(wxString(ctx.DryRun ? "Resolving waves..." : "Saving waves..."));
+      LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::Waves);
+      ExportWaves(ctx, progress);
+      if (progress.IsCanceled())
       {
-        SendEvent(&progress, UPDATE_PROGRESS, wxString("Exporting: ") + wave->GetObjectNameString().UTF8(), curProgress);
-        if (wave->GetResourceSize())
-        {
-          auto expPath = ctx.GetWaveDir();
-          expPath /= wave->GetLocalDir().UTF8();
-          std::error_code err;
-          std::filesystem::create_directories(expPath, err);
-          expPath += wave->GetObjectNameString() + ".ogg";
-          if (!std::filesystem::exists(expPath) || ctx.Config.OverrideData)
-          {
-            std::ofstream s(expPath, std::ios::binary);
-            s.write((const char*)wave->GetResourceData(), wave->GetResourceSize());
-          }
-        }
+        SendEvent(&progress, UPDATE_PROGRESS_FINISH);
+        return;
       }
     }
 
     if (ctx.CuesMap.size())
     {
-      std::error_code ec;
-      {
-        std::filesystem::path dirp = ctx.GetCueDir();
-        std::filesystem::create_directories(dirp, ec);
-        dirp = dirp.parent_path().parent_path();
-        dirp /= "DO_NOT_COPY_TO_UE4";
-        std::ofstream marker(dirp);
-      }
-      FString cuesList;
-      for (const auto& p : ctx.CuesMap)
-      {
-        std::filesystem::path dirp = ctx.GetCueDir() / p.first->GetLocalDir().UTF8();
-        std::filesystem::create_directories(dirp, ec);
-        dirp /= (p.first->GetObjectNameString() + ".cue").UTF8();
-        if (std::filesystem::exists(dirp, ec) && !ctx.Config.OverrideData)
-        {
-          continue;
-        }
-        cuesList += dirp.wstring();
-        cuesList += "\n";
-        std::ofstream ofs(dirp);
-        ofs << p.second;
-      }
-      if (!std::filesystem::exists(ctx.GetCuesInfoPath(), ec) || ctx.Config.OverrideData)
-      {
-        std::ofstream ofs(ctx.GetCuesInfoPath());
-        ofs << cuesList.UTF8();
-      }
+      LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::Cues);
+      ExportCues(ctx);
     }
 
     if (ctx.Config.Materials || ctx.Config.Textures)
@@ -2229,13 +2250,35 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
       }
     }
 
-    PERF_END(LevelExport);
+    TRACE_END(LevelExport);
+    if (ctx.DryRun)
+    {
+      std::filesystem::path reportPath = std::filesystem::path(ctx.Config.RootDir.WString()) / (Level->GetPackage()->GetPackageName().WString() + L"_DryRun.json");
+      if (!ctx.Report.SaveJson(reportPath, Level->GetPackage()->GetPackageName().UTF8()))
+      {
+        ctx.Errors.emplace_back("Error! Failed to write " + reportPath.u8string() + "!");
+      }
+    }
+    else
+    {
+      ctx.Report.SaveToHistory();
+    }
     SendEvent(&progress, UPDATE_PROGRESS_FINISH);
   }).detach();
 
   progress.ShowModal();
 
-  if (!progress.IsCanceled())
+  if (!progress.IsCanceled() && ctx.DryRun)
+  {
+    std::string summary = ctx.Report.GetSummary();
+    summary += "\n\nThe report was saved to the destination folder.";
+    if (ctx.Errors.size())
+    {
+      summary += "\nSome errors occurred during the dry run: " + std::to_string(ctx.Errors.size());
+    }
+    REDialog::Info(summary, "Dry run");
+  }
+  else if (!progress.IsCanceled())
   {
     if (ctx.Errors.empty())
     {
@@ -2255,52 +2298,41 @@ void LevelEditor::PrepareToExportLevel(LevelExportContext& ctx)
   }
 }
 
-void LevelEditor::ExportLevel(T3DFile& f, ULevel* level, LevelExportContext& ctx, ProgressWindow* progress)
+void LevelEditor::ExportLevel(T3DWriter& f, ULevel* level, LevelExportContext& ctx, ProgressWindow* progress)
 {
-  SendEvent(progress, UPDATE_PROGRESS_DESC, wxString("Preparing: " + level->GetPackage()->GetPackageName().UTF8()));
-  std::vector<UActor*> actors = level->GetActors();
+  progress->GetReporter().SetActionText(wxString("Preparing: " + level->GetPackage()->GetPackageName().UTF8()));
+  const LevelActorClassifier classifier(level);
+  const std::vector<UActor*>& actors = classifier.GetActors();
 
   if (actors.empty())
   {
     ctx.Errors.emplace_back("Warning: " + level->GetPackage()->GetPackageName().UTF8() + " has no actors!");
     return;
   }
-  T3DFile lightF;
-  size_t lightInitialSize = 0;
-  size_t initialSize = 0;
+  std::filesystem::path dst = std::filesystem::path(ctx.Config.RootDir.WString()) / level->GetPackage()->GetPackageName().WString();
+  T3DWriter lightF;
+  uint64 lightInitialSize = 0;
+  uint64 initialSize = 0;
   if (ctx.Config.SplitT3D)
   {
-    f.Clear();
+    // Stream the level straight to disk. The file is discarded if the level has nothing to export.
+    if (!ctx.DryRun)
+    {
+      f.Open(std::filesystem::path(dst).replace_extension("t3d"));
+    }
     f.InitializeMap();
-    initialSize = f.GetBody().size();
+    initialSize = f.GetSize();
   }
   else
   {
     lightF.InitializeMap();
-    lightInitialSize = lightF.GetBody().size();
+    lightInitialSize = lightF.GetSize();
   }
 
-  std::vector<UActor*> skip;
-  if (!ctx.Config.ExportMLods)
-  {
-    for (UActor* actor : actors)
-    {
-      UStaticMeshActor* smActor = Cast<UStaticMeshActor>(actor);
-      if (!smActor || !smActor->StaticMeshComponent || !smActor->StaticMeshComponent->ReplacementPrimitive)
-      {
-        continue;
-      }
-      UActor* mlodActor = Cast<UActor>(smActor->StaticMeshComponent->ReplacementPrimitive->GetOuter());
-      if (!mlodActor || std::find(skip.begin(), skip.end(), mlodActor) != skip.end())
-      {
-        continue;
-      }
-      skip.push_back(mlodActor);
-    }
-  }
-  
-  for (UActor* actor : actors)
+  for (size_t actorIdx = 0; actorIdx < actors.size(); ++actorIdx)
   {
+    UActor* actor = actors[actorIdx];
+    const LevelActorClassifier::ActorKind kind = classifier.GetKind(actorIdx);
     if (progress)
     {
       if (progress->IsCanceled())
@@ -2308,38 +2340,57 @@ void LevelEditor::ExportLevel(T3DFile& f, ULevel* level, LevelExportContext& ctx
         return;
       }
       ctx.CurrentProgress++;
-      SendEvent(progress, UPDATE_PROGRESS, ctx.CurrentProgress);
+      progress->GetReporter().SetCurrentProgress(ctx.CurrentProgress);
       if (actor)
       {
         FString name = level->GetPackage()->GetPackageName() + "\\" + actor->GetObjectNameString();
-        SendEvent(progress, UPDATE_PROGRESS_DESC, wxString(L"Exporting: " + name.WString()));
+        progress->GetReporter().SetActionText(wxString(L"Exporting: " + name.WString()));
       }
     }
     if (!actor)
     {
       continue;
     }
-    if (actor->GetClassName() == UTerrain::StaticClassName())
+    if (kind == LevelActorClassifier::ActorKind::Terrain)
     {
       if (!ctx.Config.GetClassEnabled(FMapExportConfig::ActorClass::Terrains))
       {
         continue;
       }
-      ExportTerrainActor(f, ctx, Cast<UTerrain>(actor));
+      if (ctx.DryRun)
+      {
+        ctx.Report.AddItem(LevelExportReport::Terrains);
+      }
+      else
+      {
+        LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::Terrains);
+        ExportTerrainActor(f, ctx, Cast<UTerrain>(actor));
+        ctx.Report.AddItem(LevelExportReport::Terrains);
+      }
     }
-    if (actor->GetClassName() == ULandscape::StaticClassName())
+    if (kind == LevelActorClassifier::ActorKind::Landscape)
     {
       if (!ctx.Config.GetClassEnabled(FMapExportConfig::ActorClass::Terrains))
       {
         continue;
       }
-      ExportLandscapeActor(f, ctx, Cast<ULandscape>(actor));
+      if (ctx.DryRun)
+      {
+        ctx.Report.AddItem(LevelExportReport::Terrains);
+      }
+      else
+      {
+        LevelExportReport::ScopedTimer timer(ctx.Report, LevelExportReport::Terrains);
+        ExportLandscapeActor(f, ctx, Cast<ULandscape>(actor));
+        ctx.Report.AddItem(LevelExportReport::Terrains);
+      }
     }
-    if (skip.size() && std::find(skip.begin(), skip.end(), actor) != skip.end())
+    if (!ctx.Config.ExportMLods && classifier.IsMLod(actorIdx))
     {
       continue;
     }
-    if (!ctx.Config.SplitT3D && Cast<ULight>(actor))
+    ctx.Report.AddItem(LevelExportReport::Actors);
+    if (!ctx.Config.SplitT3D && kind == LevelActorClassifier::ActorKind::Light)
     {
       ExportActor(lightF, ctx, actor);
     }
@@ -2349,18 +2400,227 @@ void LevelEditor::ExportLevel(T3DFile& f, ULevel* level, LevelExportContext& ctx
     }
   }
 
-  std::filesystem::path dst = std::filesystem::path(ctx.Config.RootDir.WString()) / level->GetPackage()->GetPackageName().WString();
-  if (ctx.Config.SplitT3D && initialSize != f.GetBody().size())
+  if (ctx.Config.SplitT3D)
   {
-    f.FinalizeMap();
-    dst.replace_extension("t3d");
-    f.Save(dst);
+    if (ctx.DryRun)
+    {
+      ctx.Report.AddBytes(LevelExportReport::Actors, f.GetSize() != initialSize ? f.GetSize() : 0);
+      f.Discard();
+    }
+    else if (initialSize != f.GetSize())
+    {
+      f.FinalizeMap();
+      ctx.Report.AddBytes(LevelExportReport::Actors, f.GetSize());
+      if (!f.Close())
+      {
+        ctx.Errors.emplace_back("Error! Failed to write " + std::filesystem::path(dst).replace_extension("t3d").u8string() + "!");
+      }
+    }
+    else
+    {
+      f.Discard();
+    }
   }
-  if (!ctx.Config.SplitT3D && lightInitialSize != lightF.GetBody().size())
+  if (!ctx.Config.SplitT3D && lightInitialSize != lightF.GetSize())
   {
     lightF.FinalizeMap();
-    lightF.Save(dst + "_lights.t3d");
+    ctx.Report.AddBytes(LevelExportReport::Actors, lightF.GetSize());
+    std::filesystem::path lightDst = dst.wstring() + L"_lights.t3d";
+    if (ctx.DryRun)
+    {
+      lightF.Discard();
+    }
+    else if (!lightF.Save(lightDst))
+    {
+      ctx.Errors.emplace_back("Error! Failed to write " + lightDst.u8string() + "!");
+    }
+  }
+}
+
+// Materials referenced by the exported level. Each material interface is a node linked to its parent.
+// Parameters are queried once per node and shared by all instances that reference the node.
+class MaterialGraph {
+public:
+  struct Node {
+    UMaterialInterface* Material = nullptr;
+    Node* Parent = nullptr;
+    // Node is written to the materials list
+    bool Listed = false;
+    // Node's textures are exported
+    bool Sampled = false;
+    // A child needs this node's texture parameters
+    bool Inherited = false;
+    bool DoubleSided = false;
+    std::map<FString, FTextureParameter> TextureParameters;
+    std::map<FString, FLinearColor> VectorParameters;
+    std::map<FString, float> ScalarParameters;
+    std::map<FString, bool> BoolParameters;
+    std::vector<UTexture*> TextureSamples;
+
+    inline bool IsInstance() const
+    {
+      return Cast<UMaterialInstance>(Material) != nullptr;
+    }
+  };
+
+  // Add the material and its parent chain. Returns nullptr if the object is not a material.
+  Node* Add(UObject* obj, bool listed, bool sampled)
+  {
+    UMaterialInterface* material = Cast<UMaterialInterface>(obj);
+    if (!material)
+    {
+      return nullptr;
+    }
+    Node* node = GetNode(material);
+    node->Listed |= listed;
+    node->Sampled |= sampled;
+    if (sampled && node->Parent && Cast<UMaterial>(node->Parent->Material))
+    {
+      node->Parent->Inherited = true;
+    }
+    return node;
+  }
+
+  // Query parameters of all nodes. Getters of the core objects are not thread safe, so nodes are
+  // resolved sequentially. The tick callback returns false to cancel.
+  bool Resolve(const std::function<bool(int32)>& tick)
+  {
+    for (std::unique_ptr<Node>& node : Nodes)
+    {
+      if (!node->Listed && !node->Sampled && !node->Inherited)
+      {
+        continue;
+      }
+      node->TextureParameters = node->Material->GetTextureParameters();
+      if (node->Listed)
+      {
+        if (UMaterialInstance* mi = Cast<UMaterialInstance>(node->Material))
+        {
+          node->VectorParameters = mi->GetVectorParameters();
+          node->ScalarParameters = mi->GetScalarParameters();
+          node->BoolParameters = mi->GetStaticBoolParameters();
+        }
+        else if (UMaterial* mat = Cast<UMaterial>(node->Material))
+        {
+          node->DoubleSided = mat->TwoSided;
+          node->VectorParameters = mat->GetVectorParameters();
+          node->ScalarParameters = mat->GetScalarParameters();
+          node->BoolParameters = mat->GetStaticBoolParameters();
+        }
+      }
+      if (node->Sampled)
+      {
+        node->TextureSamples = node->Material->GetTextureSamples();
+      }
+      if ((node->Listed || node->Sampled) && !tick(1))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Collect unique textures of sampled nodes. Textures are keyed by their local path.
+  // Like Resolve, this runs sequentially because it calls into the core objects.
+  bool CollectTextures(std::map<std::string, UTexture*>& output, const std::function<bool(int32)>& tick)
+  {
+    std::unordered_set<UTexture*> visited;
+    auto addTexture = [&](UTexture* tex) {
+      if (tex && visited.insert(tex).second)
+      {
+        output.emplace(tex->GetLocalDir(true).UTF8(), tex);
+      }
+    };
+    for (const std::unique_ptr<Node>& node : Nodes)
+    {
+      if (!node->Sampled)
+      {
+        continue;
+      }
+      for (const auto& p : node->TextureParameters)
+      {
+        addTexture(p.second.Texture);
+      }
+      // Parent material's textures that are not overridden by the node
+      if (node->Parent && Cast<UMaterial>(node->Parent->Material))
+      {
+        for (const auto& p : node->Parent->TextureParameters)
+        {
+          if (!node->TextureParameters.count(p.first))
+          {
+            addTexture(p.second.Texture);
+          }
+        }
+      }
+      for (UTexture* tex : node->TextureSamples)
+      {
+        addTexture(tex);
+      }
+      if (!tick(2))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Number of progress steps reported by Resolve and, if textures are collected, CollectTextures
+  size_t GetProgressSteps(bool collectTextures) const
+  {
+    size_t steps = 0;
+    for (const std::unique_ptr<Node>& node : Nodes)
+    {
+      if (node->Listed || node->Sampled)
+      {
+        steps++;
+      }
+      if (collectTextures && node->Sampled)
+      {
+        steps += 2;
+      }
+    }
+    return steps;
+  }
+
+private:
+  Node* GetNode(UMaterialInterface* material)
+  {
+    auto it = NodesMap.find(material);
+    if (it != NodesMap.end())
+    {
+      return it->second;
+    }
+    Node* node = Nodes.emplace_back(std::make_unique<Node>()).get();
+    node->Material = material;
+    NodesMap[material] = node;
+    if (UMaterialInterface* parent = Cast<UMaterialInterface>(material->GetParent()))
+    {
+      node->Parent = GetNode(parent);
+    }
+    return node;
+  }
+
+private:
+  std::vector<std::unique_ptr<Node>> Nodes;
+  std::unordered_map<UMaterialInterface*, Node*> NodesMap;
+};
+
+// Approximate size of an exported texture. PNG size depends on the content, assume 2:1 compression.
+uint64 EstimateTextureSize(int32 width, int32 height, uint64 bulkSize, TextureProcessor::TCFormat outputFormat)
+{
+  const uint64 rgbaSize = uint64(width) * height * 4;
+  switch (outputFormat)
+  {
+  case TextureProcessor::TCFormat::DDS:
+    return bulkSize + 148;
+  case TextureProcessor::TCFormat::TGA:
+    return rgbaSize + 18;
+  case TextureProcessor::TCFormat::PNG:
+    return rgbaSize / 2;
+  default:
+    break;
   }
+  return rgbaSize;
 }
 
 bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWindow* progress)
@@ -2370,24 +2630,60 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
     return true;
   }
 
+  MaterialGraph graph;
+  std::vector<MaterialGraph::Node*> usedNodes;
+  std::vector<MaterialGraph::Node*> leafNodes;
+  for (UObject* obj : ctx.UsedMaterials)
+  {
+    if (MaterialGraph::Node* node = graph.Add(obj, ctx.Config.Materials, ctx.Config.Textures))
+    {
+      usedNodes.emplace_back(node);
+    }
+  }
+  if (ctx.Config.Materials)
+  {
+    // Add separate leaf card materials
+    for (UObject* obj : ctx.SptLeafMaterials)
+    {
+      if (MaterialGraph::Node* node = graph.Add(obj, true, false))
+      {
+        leafNodes.emplace_back(node);
+      }
+    }
+  }
+
   if (ctx.Config.Materials)
   {
-    SendEvent(progress, UPDATE_PROGRESS_DESC, wxString("Saving materials..."));
-    SendEvent(progress, UPDATE_PROGRESS, 0);
-    // Use 3x multiplier because collecting textures takes long. 2/3 proportion makes it feel a bit faster
-    SendEvent(progress, UPDATE_MAX_PROGRESS, ctx.UsedMaterials.size() * (ctx.Config.Textures ? 3 : 1)); 
+    progress->GetReporter().SetActionText(wxString("Saving materials..."));
+    progress->GetReporter().SetCurrentProgress(0);
+    // Collecting textures takes long, so it ticks twice per sampled node
+    progress->GetReporter().SetMaxProgress(int32(graph.GetProgressSteps(ctx.Config.Textures)));
   }
   else
   {
-    SendEvent(progress, UPDATE_PROGRESS_DESC, wxString("Preparing textures..."));
-    SendEvent(progress, UPDATE_PROGRESS, -1);
+    progress->GetReporter().SetActionText(wxString("Preparing textures..."));
+    progress->GetReporter().SetCurrentProgress(-1);
   }
 
-  int32 curProgress = 0;
+  std::atomic_int32_t curProgress = 0;
+  auto tick = [&](int32 step) {
+    if (ctx.Config.Materials)
+    {
+      progress->GetReporter().SetCurrentProgress(curProgress += step);
+    }
+    return !progress->IsCanceled();
+  };
+
+  std::optional<LevelExportReport::ScopedTimer> materialsTimer(std::in_place, ctx.Report, LevelExportReport::Materials);
+  if (!graph.Resolve(tick))
+  {
+    SendEvent(progress, UPDATE_PROGRESS_FINISH);
+    return false;
+  }
   
   if (ctx.Config.Materials)
   {
-    if (ctx.MeshDefaultMaterials.size())
+    if (ctx.MeshDefaultMaterials.size() && !ctx.DryRun)
     {
       const std::filesystem::path root = ctx.GetMeshDefaultMaterialsPath();
       std::ofstream s(root);
@@ -2400,7 +2696,7 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
         }
       }
     }
-    if (ctx.SpeedTreeMaterialOverrides.size())
+    if (ctx.SpeedTreeMaterialOverrides.size() && !ctx.DryRun)
     {
       std::filesystem::path root = ctx.GetSpeedTreeMaterialOverridesPath();
       std::ofstream s(root);
@@ -2413,66 +2709,67 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
         }
       }
     }
-    
-    struct MaterialParameters {
-      std::map<FString, FTextureParameter> TextureParameters;
-      std::map<FString, FLinearColor> VectorParameters;
-      std::map<FString, float> ScalarParameters;
-      std::map<FString, bool> BoolParameters;
-      bool DoubleSided = false;
+
+    struct MaterialEntry {
+      MaterialGraph::Node* Node = nullptr;
+      const char* Suffix = "";
+      std::string Text;
     };
-    std::map<std::string, MaterialParameters> masterMaterials;
-    std::map<std::string, MaterialParameters> materialInstances;
-    std::vector<std::string> elements;
+    std::vector<MaterialEntry> entries;
+    entries.reserve(usedNodes.size() + leafNodes.size());
+    for (MaterialGraph::Node* node : usedNodes)
+    {
+      entries.emplace_back().Node = node;
+    }
+    for (MaterialGraph::Node* node : leafNodes)
+    {
+      MaterialEntry& entry = entries.emplace_back();
+      entry.Node = node;
+      entry.Suffix = "_leafs";
+    }
 
-    for (UObject* obj : ctx.UsedMaterials)
+    const std::string gamePrefix = std::string("Game/") + ctx.DataDirName + '/';
+    for (MaterialEntry& entry : entries)
     {
-      SendEvent(progress, UPDATE_PROGRESS, curProgress);
-      if (progress->IsCanceled())
+      const MaterialGraph::Node* node = entry.Node;
+      if (!node->IsInstance())
       {
-        SendEvent(progress, UPDATE_PROGRESS_FINISH);
-        return false;
+        entry.Text = "Material " + gamePrefix + node->Material->GetLocalDir(true, "/").UTF8() + entry.Suffix + '\n';
       }
-      curProgress++;
-      if (UMaterialInstance* mi = Cast<UMaterialInstance>(obj))
+      else if (node->Parent)
       {
-        if (UObject* mat = mi->GetParent())
-        {
-          std::string e = obj->GetClassNameString().UTF8() + ' ';
-          e += "Game/";
-          e += ctx.DataDirName;
-          e += '/' + mat->GetLocalDir(true, "/").UTF8() + ' ';
-          e += "Game/";
-          e += ctx.DataDirName;
-          e += '/' + mi->GetLocalDir(true, "/").UTF8() + '\n';
-          if (std::find(elements.begin(), elements.end(), e) == elements.end())
-          {
-            elements.push_back(e);
-            MaterialParameters params;
-            params.TextureParameters = mi->GetTextureParameters();
-            params.VectorParameters = mi->GetVectorParameters();
-            params.ScalarParameters = mi->GetScalarParameters();
-            params.BoolParameters = mi->GetStaticBoolParameters();
-            materialInstances[e] = params;
-          }
-        }
+        entry.Text = node->Material->GetClassNameString().UTF8() + ' ';
+        entry.Text += gamePrefix + node->Parent->Material->GetLocalDir(true, "/").UTF8() + entry.Suffix + ' ';
+        entry.Text += gamePrefix + node->Material->GetLocalDir(true, "/").UTF8() + entry.Suffix + '\n';
+      }
+    }
+
+    std::map<std::string, const MaterialGraph::Node*> masterMaterials;
+    std::map<std::string, const MaterialGraph::Node*> materialInstances;
+    std::vector<std::string> elements;
+    std::unordered_set<std::string> uniqueElements;
+    for (const MaterialEntry& entry : entries)
+    {
+      if (entry.Text.empty() || !uniqueElements.insert(entry.Text).second)
+      {
+        continue;
       }
-      else if (UMaterial* mat = Cast<UMaterial>(obj))
+      elements.emplace_back(entry.Text);
+      ctx.Report.AddItem(LevelExportReport::Materials);
+      if (ctx.DryRun)
       {
-        std::string e = "Material Game/";
-        e += ctx.DataDirName;
-        e += '/' + mat->GetLocalDir(true, "/").UTF8() + '\n';
-        if (std::find(elements.begin(), elements.end(), e) == elements.end())
-        {
-          elements.push_back(e);
-          MaterialParameters params;
-          params.DoubleSided = mat->TwoSided;
-          params.TextureParameters = mat->GetTextureParameters();
-          params.VectorParameters = mat->GetVectorParameters();
-          params.ScalarParameters = mat->GetScalarParameters();
-          params.BoolParameters = mat->GetStaticBoolParameters();
-          masterMaterials[e] = params;
+        continue;
+      }
+      if (entry.Node->IsInstance())
+      {
+        materialInstances[entry.Text] = entry.Node;
+      }
+      else
+      {
+        masterMaterials[entry.Text] = entry.Node;
 #if TEST_MAT_EXPS_EXPORT
+        if (UMaterial* mat = Cast<UMaterial>(entry.Node->Material))
+        {
           FString out;
           ExportMaterialExpressions(mat, out);
           auto expPath = ctx.GetMaterialExpressionsPath();
@@ -2484,57 +2781,12 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
             std::ofstream s(expPath);
             s << out.WString();
           }
-#endif
-        }
-      }
-    }
-
-    // Add separate leaf card materials
-    for (UObject* obj : ctx.SptLeafMaterials)
-    {
-      if (UMaterial* mat = Cast<UMaterial>(obj))
-      {
-        std::string e = "Material Game/";
-        e += ctx.DataDirName;
-        e += '/' + mat->GetLocalDir(true, "/").UTF8() + "_leafs" + '\n';
-        if (std::find(elements.begin(), elements.end(), e) == elements.end())
-        {
-          elements.push_back(e);
-          MaterialParameters params;
-          params.DoubleSided = mat->TwoSided;
-          params.TextureParameters = mat->GetTextureParameters();
-          params.VectorParameters = mat->GetVectorParameters();
-          params.ScalarParameters = mat->GetScalarParameters();
-          params.BoolParameters = mat->GetStaticBoolParameters();
-          masterMaterials[e] = params;
-        }
-      }
-      else if (UMaterialInstance* mi = Cast<UMaterialInstance>(obj))
-      {
-        if (UMaterialInterface* parent = Cast<UMaterialInterface>(mi->GetParent()))
-        {
-          std::string e = obj->GetClassNameString().UTF8() + ' ';
-          e += "Game/";
-          e += ctx.DataDirName;
-          e += '/' + parent->GetLocalDir(true, "/").UTF8() + "_leafs" + ' ';
-          e += "Game/";
-          e += ctx.DataDirName;
-          e += '/' + mi->GetLocalDir(true, "/").UTF8() + "_leafs" + '\n';
-          if (std::find(elements.begin(), elements.end(), e) == elements.end())
-          {
-            elements.push_back(e);
-            MaterialParameters params;
-            params.TextureParameters = mi->GetTextureParameters();
-            params.VectorParameters = mi->GetVectorParameters();
-            params.ScalarParameters = mi->GetScalarParameters();
-            params.BoolParameters = mi->GetStaticBoolParameters();
-            materialInstances[e] = params;
-          }
         }
+#endif
       }
     }
 
-    if (elements.size())
+    if (elements.size() && !ctx.DryRun)
     {
       const std::filesystem::path root = ctx.GetMaterialsListPath();
       std::ofstream s(root);
@@ -2547,12 +2799,13 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
     if (masterMaterials.size() || materialInstances.size())
     {
       auto DumpMaterial = [&](auto& s, const auto& mat) {
+        const MaterialGraph::Node* node = mat.second;
         s << mat.first;
-        if (mat.second.DoubleSided)
+        if (node->DoubleSided)
         {
           s << "  TwoSided\n";
         }
-        for (auto const& p : mat.second.TextureParameters)
+        for (auto const& p : node->TextureParameters)
         {
           if (UTexture2D* tmp = Cast<UTexture2D>(p.second.Texture))
           {
@@ -2579,15 +2832,15 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
             s << "None\n";
           }
         }
-        for (auto const& p : mat.second.ScalarParameters)
+        for (auto const& p : node->ScalarParameters)
         {
           s << "  Scalar" << VSEP << p.first.UTF8() << VSEP << p.second << '\n';
         }
-        for (auto const& p : mat.second.VectorParameters)
+        for (auto const& p : node->VectorParameters)
         {
           s << "  Vector" << VSEP << p.first.UTF8() << VSEP << p.second.R << VSEP << p.second.G << VSEP << p.second.B << VSEP << p.second.A << '\n';
         }
-        for (auto const& p : mat.second.BoolParameters)
+        for (auto const& p : node->BoolParameters)
         {
           s << "  Bool" << VSEP << p.first.UTF8() << VSEP << (p.second ? "True" : "False") << '\n';
         }
@@ -2602,75 +2855,26 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
       {
         DumpMaterial(s, mat);
       }
+      s.close();
+      ctx.Report.AddBytes(LevelExportReport::Materials, GetFileSize(root));
     }
   }
+  materialsTimer.reset();
   
   if (ctx.Config.Textures)
   {
+    LevelExportReport::ScopedTimer texturesTimer(ctx.Report, LevelExportReport::Textures);
     std::map<std::string, UTexture*> textures;
-    for (UObject* obj : ctx.UsedMaterials)
+    if (!graph.CollectTextures(textures, tick))
     {
-      if (ctx.Config.Materials)
-      {
-        SendEvent(progress, UPDATE_PROGRESS, curProgress);
-        curProgress+=2;
-      }
-      if (progress->IsCanceled())
-      {
-        SendEvent(progress, UPDATE_PROGRESS_FINISH);
-        return false;
-      }
-      if (!obj)
-      {
-        continue;
-      }
-
-      if (UMaterialInterface* mat = Cast<UMaterialInterface>(obj))
-      {
-        auto textureParams = mat->GetTextureParameters();
-        if (UMaterial* parent = Cast<UMaterial>(mat->GetParent()))
-        {
-          auto parentTexParams = parent->GetTextureParameters();
-          for (auto& p : parentTexParams)
-          {
-            if (p.second.Texture && !textureParams.count(p.first))
-            {
-              textureParams[p.first].Texture = p.second.Texture;
-            }
-          }
-        }
-        for (auto& p : textureParams)
-        {
-          if (!p.second.Texture)
-          {
-            continue;
-          }
-          std::string tpath = p.second.Texture->GetLocalDir(true).UTF8();
-          if (!textures.count(tpath))
-          {
-            textures[tpath] = p.second.Texture;
-          }
-        }
-        auto constTextures = mat->GetTextureSamples();
-        for (UTexture* tex : constTextures)
-        {
-          if (!tex)
-          {
-            continue;
-          }
-          std::string tpath = tex->GetLocalDir(true).UTF8();
-          if (!textures.count(tpath))
-          {
-            textures[tpath] = tex;
-          }
-        }
-      }
+      SendEvent(progress, UPDATE_PROGRESS_FINISH);
+      return false;
     }
 
     if (textures.size())
     {
-      SendEvent(progress, UPDATE_PROGRESS, 0);
-      SendEvent(progress, UPDATE_MAX_PROGRESS, textures.size());
+      progress->GetReporter().SetCurrentProgress(0);
+      progress->GetReporter().SetMaxProgress(int32(textures.size()));
       curProgress = 0;
 
       TextureProcessor::TCFormat outputFormat = ctx.GetTextureFormat();
@@ -2726,18 +2930,18 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
           SendEvent(progress, UPDATE_PROGRESS_FINISH);
           return false;
         }
-        SendEvent(progress, UPDATE_PROGRESS, curProgress);
+        progress->GetReporter().SetCurrentProgress(curProgress);
         curProgress++;
         if (!p.second)
         {
           continue;
         }
 
-        SendEvent(progress, UPDATE_PROGRESS_DESC, wxString("Exporting textures: ") + p.second->GetObjectNameString().UTF8());
+        progress->GetReporter().SetActionText(wxString("Exporting textures: ") + p.second->GetObjectNameString().UTF8());
 
         std::error_code err;
         std::filesystem::path path = ctx.GetTextureDir() / p.second->GetLocalDir().UTF8();
-        if (!std::filesystem::exists(path, err))
+        if (!ctx.DryRun && !std::filesystem::exists(path, err))
         {
           std::filesystem::create_directories(path, err);
         }
@@ -2746,25 +2950,9 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
 
         if (UTexture2D* texture = Cast<UTexture2D>(p.second))
         {
-          TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-          switch (texture->Format)
+          TextureProcessor::TCFormat inputFormat = TextureFormats::GetProcessorFormat(texture->Format);
+          if (inputFormat == TextureProcessor::TCFormat::None)
           {
-          case PF_DXT1:
-            inputFormat = TextureProcessor::TCFormat::DXT1;
-            break;
-          case PF_DXT3:
-            inputFormat = TextureProcessor::TCFormat::DXT3;
-            break;
-          case PF_DXT5:
-            inputFormat = TextureProcessor::TCFormat::DXT5;
-            break;
-          case PF_A8R8G8B8:
-            inputFormat = TextureProcessor::TCFormat::ARGB8;
-            break;
-          case PF_G8:
-            inputFormat = TextureProcessor::TCFormat::G8;
-            break;
-          default:
             LogE("Failed to export texture %s. Invalid format!", texture->GetObjectNameString().UTF8().c_str());
             continue;
           }
@@ -2776,21 +2964,19 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
             continue;
           }
 
-          FTexture2DMipMap* mip = nullptr;
-          for (FTexture2DMipMap* mipmap : texture->Mips)
-          {
-            if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-            {
-              mip = mipmap;
-              break;
-            }
-          }
+          FTexture2DMipMap* mip = TextureFormats::GetTopMip(texture);
           if (!mip)
           {
             LogE("Failed to export texture %s. No mipmaps!", texture->GetObjectNameString().UTF8().c_str());
             continue;
           }
 
+          if (ctx.DryRun)
+          {
+            ctx.Report.AddItem(LevelExportReport::Textures, EstimateTextureSize(mip->SizeX, mip->SizeY, mip->Data->GetBulkDataSize(), outputFormat));
+            continue;
+          }
+
           TextureProcessor processor(inputFormat, outputFormat);
 
           processor.SetInputData(mip->Data->GetAllocation(), mip->Data->GetBulkDataSize());
@@ -2808,6 +2994,7 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
               LogE("Failed to export %s: %s", texture->GetObjectNameString().UTF8().c_str(), processor.GetError().c_str());
               continue;
             }
+            ctx.Report.AddItem(LevelExportReport::Textures, GetFileSize(path));
           }
           catch (...)
           {
@@ -2817,83 +3004,32 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
         }
         else if (UTextureCube* cube = Cast<UTextureCube>(p.second))
         {
-          auto faces = cube->GetFaces();
-          bool ok = true;
-          TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-          for (UTexture2D* face : faces)
-          {
-            if (!face)
-            {
-              LogW("Failed to export a texture cube %s. Can't get one of the faces.", p.second->GetObjectPath().UTF8().c_str());
-              ok = false;
-              break;
-            }
-            TextureProcessor::TCFormat f = TextureProcessor::TCFormat::None;
-            switch (face->Format)
-            {
-            case PF_DXT1:
-              f = TextureProcessor::TCFormat::DXT1;
-              break;
-            case PF_DXT3:
-              f = TextureProcessor::TCFormat::DXT3;
-              break;
-            case PF_DXT5:
-              f = TextureProcessor::TCFormat::DXT5;
-              break;
-            case PF_A8R8G8B8:
-              f = TextureProcessor::TCFormat::ARGB8;
-              break;
-            case PF_G8:
-              f = TextureProcessor::TCFormat::G8;
-              break;
-            default:
-              LogE("Failed to export texture cube %s.%s. Invalid face format!", p.second->GetObjectNameString().UTF8().c_str(), face->GetObjectNameString().UTF8().c_str());
-              ok = false;
-              break;
-            }
-            if (inputFormat != TextureProcessor::TCFormat::None && inputFormat != f)
-            {
-              LogE("Failed to export texture cube %s.%s. Faces have different format!", p.second->GetObjectNameString().UTF8().c_str(), face->GetObjectNameString().UTF8().c_str());
-              ok = false;
-              break;
-            }
-            inputFormat = f;
-          }
-
-          if (!ok)
+          TextureCubeInput input(cube);
+          if (!input.IsValid())
           {
+            LogE("%s", input.GetError().c_str());
             continue;
           }
 
           // UE4 accepts texture cubes only in a DDS container with A8R8G8B8 format and proper flags. Export cubes this way regardless of the user's output format.
           path.replace_extension("dds");
-          TextureProcessor processor(inputFormat, TextureProcessor::TCFormat::DDS);
-          for (int32 faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+          if (ctx.DryRun)
           {
-            FTexture2DMipMap* mip = nullptr;
-            for (FTexture2DMipMap* mipmap : faces[faceIdx]->Mips)
+            if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
             {
-              if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-              {
-                mip = mipmap;
-                break;
-              }
+              ctx.Report.AddItem(LevelExportReport::Textures, input.GetDecodedSize());
             }
-            if (!mip)
-            {
-              LogE("Failed to export texture cube face %s.%s. No mipmaps!", cube->GetObjectPath().UTF8().c_str(), faces[faceIdx]->GetObjectNameString().UTF8().c_str());
-              ok = false;
-              break;
-            }
-
-            processor.SetInputCubeFace(faceIdx, mip->Data->GetAllocation(), mip->Data->GetBulkDataSize(), mip->SizeX, mip->SizeY);
+            continue;
           }
-
-          if (!ok)
+          if (!input.Decode(TextureProcessor::TCFormat::DDS))
           {
+            LogE("%s", input.GetError().c_str());
             continue;
           }
 
+          TextureProcessor processor(input.GetProcessorFormat(), TextureProcessor::TCFormat::DDS);
+          input.SetProcessorInput(processor);
+
           processor.SetOutputPath(W2A(path.wstring()));
 
           try
@@ -2903,6 +3039,7 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
               LogE("Failed to export %s: %s", cube->GetObjectPath().UTF8().c_str(), processor.GetError().c_str());
               continue;
             }
+            ctx.Report.AddItem(LevelExportReport::Textures, GetFileSize(path));
           }
           catch (...)
           {
@@ -2916,7 +3053,7 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
         }
       }
 
-      if (textureInfo.size())
+      if (textureInfo.size() && !ctx.DryRun)
       {
         std::ofstream s(ctx.GetTextureInfoPath());
         for (const std::string& i : textureInfo)
@@ -2930,7 +3067,7 @@ bool LevelEditor::ExportMaterialsAndTexture(LevelExportContext& ctx, ProgressWin
   return true;
 }
 
-void AddCommonPrimitiveComponentParameters(T3DFile& f, LevelExportContext& ctx, UPrimitiveComponent* component)
+void AddCommonPrimitiveComponentParameters(T3DWriter& f, LevelExportContext& ctx, UPrimitiveComponent* component)
 {
   if (component->MinDrawDistance)
   {
@@ -3005,30 +3142,40 @@ std::vector<UObject*> SaveMaterialMap(UMeshComponent* component, LevelExportCont
     {
       std::error_code err;
       std::filesystem::path path = ctx.GetMaterialMapDir();
-      if (!std::filesystem::exists(path, err))
+      if (!ctx.DryRun && !std::filesystem::exists(path, err))
       {
         std::filesystem::create_directories(path, err);
       }
-      if (std::filesystem::exists(path, err))
+      if (ctx.DryRun || std::filesystem::exists(path, err))
       {
         path /= component->GetPackage()->GetPackageName().UTF8() + "_" + (actor ? (UObject*)actor : (UObject*)component)->GetObjectNameString().UTF8();
         path.replace_extension("txt");
 
         if (ctx.Config.OverrideData || !std::filesystem::exists(path, err))
         {
-          std::ofstream s(path, std::ios::out);
+          std::string map;
           for (int idx = 0; idx < materialsToSave.size(); ++idx)
           {
-            s << std::to_string(idx + 1) << ". ";
+            map += std::to_string(idx + 1) + ". ";
             if (UObject* mat = materialsToSave[idx])
             {
-              s << mat->GetLocalDir(true).UTF8();
+              map += mat->GetLocalDir(true).UTF8();
             }
             else
             {
-              s << "None";
+              map += "None";
             }
-            s << '\n';
+            map += '\n';
+          }
+          if (ctx.DryRun)
+          {
+            // Material maps are small text files. Count their size with the materials.
+            ctx.Report.AddBytes(LevelExportReport::Materials, map.size());
+          }
+          else
+          {
+            std::ofstream s(path, std::ios::out);
+            s << map;
           }
         }
       }
@@ -3037,7 +3184,7 @@ std::vector<UObject*> SaveMaterialMap(UMeshComponent* component, LevelExportCont
   return materialsToSave;
 }
 
-void ExportActor(T3DFile& f, LevelExportContext& ctx, UActor* untypedActor)
+void ExportActor(T3DWriter& f, LevelExportContext& ctx, UActor* untypedActor)
 {
   if (!untypedActor)
   {
@@ -3318,7 +3465,7 @@ void ExportActor(T3DFile& f, LevelExportContext& ctx, UActor* untypedActor)
     }
     exportItem.AdditionalLayers.emplace_back("RE_Sounds");
     std::vector<USoundNodeWave*> waves = actor->GetAllWaves();
-    ctx.Waves.insert(ctx.Waves.end(), waves.begin(), waves.end());
+    ctx.Waves.insert(waves.begin(), waves.end());
     for (USoundCue* cue : actor->MusicList)
     {
       if (!cue)
@@ -3408,10 +3555,10 @@ void ExportActor(T3DFile& f, LevelExportContext& ctx, UActor* untypedActor)
       f.AddCustomLine(customLine.C_str());
     }
 
-    f.AddCustom("RootComponent", FString::Sprintf("%s'\"%s\"'", exportItem.RootComponent->Class.UTF8().c_str(), exportItem.RootComponent->Name.UTF8().c_str()).UTF8().c_str());
+    f.AddReference("RootComponent", exportItem.RootComponent->Class.UTF8(), exportItem.RootComponent->Name.UTF8());
     for (const auto& p : exportItem.Properties)
     {
-      f.AddCustom(p.first.UTF8().c_str(), FString::Sprintf("%s'\"%s\"'", p.second->Class.UTF8().c_str(), p.second->Name.UTF8().c_str()).UTF8().c_str());
+      f.AddReference(p.first.UTF8(), p.second->Class.UTF8(), p.second->Name.UTF8());
     }
 
     {
@@ -3420,7 +3567,7 @@ void ExportActor(T3DFile& f, LevelExportContext& ctx, UActor* untypedActor)
       {
         if (component.IsInstance)
         {
-          f.AddCustom(FString::Sprintf("InstanceComponents(%d)", inctanceIdx++).UTF8().c_str(), FString::Sprintf("%s'\"%s\"'", component.Class.UTF8().c_str(), component.Name.UTF8().c_str()).UTF8().c_str());
+          f.AddReference("InstanceComponents", inctanceIdx++, component.Class.UTF8(), component.Name.UTF8());
         }
       }
     }
@@ -3435,119 +3582,97 @@ void ExportActor(T3DFile& f, LevelExportContext& ctx, UActor* untypedActor)
     layers.insert(layers.end(), exportItem.AdditionalLayers.begin(), exportItem.AdditionalLayers.end());
     for (int32 idx = 0; idx < layers.size(); ++idx)
     {
-      f.AddString(FString::Sprintf("Layers(%d)", idx).UTF8().c_str(), W2A(layers[idx].WString()).c_str());
+      f.AddString("Layers", idx, W2A(layers[idx].WString()));
     }
   }
   f.End();
 }
 
-void ExportTerrainActor(T3DFile& f, LevelExportContext& ctx, UTerrain* actor)
-{
-  int32 width = 0;
-  int32 height = 0;
+struct TerrainRasterJob {
+  TerrainRasterJob(TerrainRaster&& raster, const std::filesystem::path& path, const char* description)
+    : Raster(std::move(raster))
+    , Path(path)
+    , Description(description)
+  {}
 
-  std::error_code err;
-  std::filesystem::path dst = ctx.GetTerrainDir();
-  dst /= actor->GetPackage()->GetPackageName().UTF8();
-  dst /= actor->GetObjectNameString().UTF8();
-  if (!std::filesystem::exists(dst, err))
-  {
-    std::filesystem::create_directories(dst, err);
-  }
-  dst /= "HeightMap";
-  dst.replace_extension(HasAVX2() ? "png" : "dds");
+  TerrainRaster Raster;
+  std::filesystem::path Path;
+  const char* Description = nullptr;
+  int32 ResampleWidth = 0;
+  int32 ResampleHeight = 0;
+};
 
-  
-  if (ctx.Config.OverrideData || !std::filesystem::exists(dst, err))
-  {
-    if (!std::filesystem::exists(ctx.GetTerrainDir(), err))
+// Resample and encode terrain rasters. Each raster is independent, so PNG encoding runs in parallel.
+void SaveTerrainRasters(LevelExportContext& ctx, UActor* actor, std::vector<TerrainRasterJob>& jobs)
+{
+  std::mutex errorsMutex;
+  std::for_each(std::execution::par, jobs.begin(), jobs.end(), [&](TerrainRasterJob& job) {
+    if (job.ResampleWidth > 0 && job.ResampleHeight > 0 && (job.ResampleWidth != job.Raster.GetWidth() || job.ResampleHeight != job.Raster.GetHeight()))
     {
-      std::filesystem::create_directories(ctx.GetTerrainDir(), err);
+      job.Raster = job.Raster.Resampled(job.ResampleWidth, job.ResampleHeight);
     }
-    uint16* heights = nullptr;
-    actor->GetHeightMap(heights, width, height, ctx.Config.ResampleTerrain);
-    if (heights)
+    std::string error;
+    const bool saved = job.Path.extension() == ".tga" ? job.Raster.SaveTga(job.Path, error) : job.Raster.SavePng(job.Path, error);
+    if (!saved)
     {
-      TextureProcessor processor(TextureProcessor::TCFormat::G16, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-      processor.SetOutputPath(W2A(dst.wstring()));
-      processor.SetInputData(heights, width * height * sizeof(uint16));
-      processor.SetInputDataDimensions(width, height);
-      free(heights);
-
-      if (!processor.Process())
-      {
-        ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " heightmap: " + processor.GetError());
-        LogW("Failed to export %s heights: %s", actor->GetObjectPath().UTF8().c_str(), processor.GetError().c_str());
-      }
+      std::scoped_lock<std::mutex> l(errorsMutex);
+      ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " " + job.Description + ": " + error);
+      LogW("Failed to export %s %s: %s", actor->GetObjectPath().UTF8().c_str(), job.Description, error.c_str());
     }
-  }
+    // Release the memory as soon as the file is written
+    job.Raster = TerrainRaster();
+  });
+}
 
-  dst = ctx.GetTerrainDir();
-  dst /= actor->GetPackage()->GetPackageName().UTF8();
-  dst /= actor->GetObjectNameString().UTF8();
+void ExportTerrainActor(T3DWriter& f, LevelExportContext& ctx, UTerrain* actor)
+{
+  std::error_code err;
+  const std::filesystem::path terrainDir = ctx.GetTerrainDir() / actor->GetPackage()->GetPackageName().UTF8() / actor->GetObjectNameString().UTF8();
+  std::filesystem::path dst = terrainDir / "WeightMaps";
   if (!std::filesystem::exists(dst, err))
   {
     std::filesystem::create_directories(dst, err);
   }
-  dst /= "VisibilityMap";
-  dst.replace_extension(HasAVX2() ? "png" : "dds");
 
-  if (actor->HasVisibilityData() && (ctx.Config.OverrideData || !std::filesystem::exists(dst, err)))
-  {
-    if (!std::filesystem::exists(ctx.GetTerrainDir(), err))
+  auto GetLayerMapIndex = [&](int32 idx) {
+    int32 layerMapIndex = actor->Layers[idx].AlphaMapIndex;
+    if (!actor->GetAlphaMapsCount())
     {
-      std::filesystem::create_directories(ctx.GetTerrainDir(), err);
+      layerMapIndex = idx;
     }
-    uint8* visibility = nullptr;
-    width = 0;
-    height = 0;
-    actor->GetVisibilityMap(visibility, width, height, ctx.Config.ResampleTerrain);
-    if (visibility)
-    {
-      TextureProcessor processor(TextureProcessor::TCFormat::G8, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-      processor.SetOutputPath(W2A(dst.wstring()));
-      processor.SetInputData(visibility, width * height);
-      processor.SetInputDataDimensions(width, height);
-      free(visibility);
+    return layerMapIndex;
+  };
 
-      if (!processor.Process())
+  auto GetWeightsSize = [&](int32& width, int32& height) {
+    for (int32 idx = 0; idx < actor->Layers.size(); ++idx)
+    {
+      int32 layerMapIndex = GetLayerMapIndex(idx);
+      void* data = nullptr;
+      if (layerMapIndex != INDEX_NONE && actor->GetWeightMapChannel(layerMapIndex, data, width, height))
       {
-        ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " visibility mask: " + processor.GetError());
-        LogW("Failed to export %s visibility: %s", actor->GetObjectPath().UTF8().c_str(), processor.GetError().c_str());
+        free(data);
+        return;
       }
     }
-  }
-
-  dst = ctx.GetTerrainDir();
-  dst /= actor->GetPackage()->GetPackageName().UTF8();
-  dst /= actor->GetObjectNameString().UTF8();
-  dst /= "WeightMaps";
-
-  if (!std::filesystem::exists(dst, err))
-  {
-    std::filesystem::create_directories(dst, err);
-  }
+  };
 
+  // Weight maps define the resolution of the resampled height and visibility maps
+  int32 weightsWidth = 0;
+  int32 weightsHeight = 0;
+  std::vector<TerrainRasterJob> jobs;
   if (ctx.Config.SplitTerrainWeights)
   {
     for (int32 idx = 0; idx < actor->Layers.size(); ++idx)
     {
       const FTerrainLayer& layer = actor->Layers[idx];
-      int32 layerMapIndex = layer.AlphaMapIndex;
-      if (actor->GetAlphaMapsCount())
+      int32 layerMapIndex = GetLayerMapIndex(idx);
+      if (layerMapIndex == INDEX_NONE)
       {
-        if (layerMapIndex == INDEX_NONE)
-        {
-          continue;
-        }
-      }
-      else
-      {
-        layerMapIndex = idx;
+        continue;
       }
       std::filesystem::path texPath = dst / (std::to_string(idx + 1) + '_' + layer.Name.UTF8());
-      texPath.replace_extension(HasAVX2() ? "png" : "dds");
-      if (ctx.Config.OverrideData || !std::filesystem::exists(texPath))
+      texPath.replace_extension("png");
+      if (ctx.Config.OverrideData || !std::filesystem::exists(texPath, err))
       {
         void* data = nullptr;
         int32 width = 0;
@@ -3556,22 +3681,66 @@ void ExportTerrainActor(T3DFile& f, LevelExportContext& ctx, UTerrain* actor)
         {
           continue;
         }
-        TextureProcessor processor(TextureProcessor::TCFormat::G8, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-        processor.SetOutputPath(W2A(texPath.wstring()));
-        processor.SetInputData(data, width * height);
-        processor.SetInputDataDimensions(width, height);
-        free(data);
+        weightsWidth = width;
+        weightsHeight = height;
+        jobs.emplace_back(TerrainRaster::Adopt(data, width, height, 1), texPath, "weightmap");
+      }
+    }
+  }
 
-        if (!processor.Process())
-        {
-          ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap: " + processor.GetError());
-          LogW("Failed to export %s weightmap: %s", actor->GetObjectPath().UTF8().c_str(), processor.GetError().c_str());
-        }
+  std::filesystem::path heightsPath = terrainDir / "HeightMap";
+  heightsPath.replace_extension("png");
+  std::filesystem::path visibilityPath = terrainDir / "VisibilityMap";
+  visibilityPath.replace_extension("png");
+  const bool needsHeights = ctx.Config.OverrideData || !std::filesystem::exists(heightsPath, err);
+  const bool needsVisibility = actor->HasVisibilityData() && (ctx.Config.OverrideData || !std::filesystem::exists(visibilityPath, err));
+
+  if (ctx.Config.ResampleTerrain && !weightsWidth && (needsHeights || needsVisibility))
+  {
+    GetWeightsSize(weightsWidth, weightsHeight);
+  }
+
+  int32 heightsWidth = 0;
+  int32 heightsHeight = 0;
+  if (needsHeights)
+  {
+    uint16* heights = nullptr;
+    int32 width = 0;
+    int32 height = 0;
+    actor->GetHeightMap(heights, width, height, false);
+    if (heights)
+    {
+      heightsWidth = width;
+      heightsHeight = height;
+      TerrainRasterJob& job = jobs.emplace_back(TerrainRaster::Adopt(heights, width, height, sizeof(uint16)), heightsPath, "heightmap");
+      if (ctx.Config.ResampleTerrain)
+      {
+        job.ResampleWidth = weightsWidth;
+        job.ResampleHeight = weightsHeight;
       }
     }
   }
-  else
+
+  if (needsVisibility)
+  {
+    uint8* visibility = nullptr;
+    int32 width = 0;
+    int32 height = 0;
+    actor->GetVisibilityMap(visibility, width, height, false);
+    if (visibility)
+    {
+      TerrainRasterJob& job = jobs.emplace_back(TerrainRaster::Adopt(visibility, width, height, 1), visibilityPath, "visibility mask");
+      if (ctx.Config.ResampleTerrain)
+      {
+        job.ResampleWidth = weightsWidth;
+        job.ResampleHeight = weightsHeight;
+      }
+    }
+  }
+
+  if (!ctx.Config.SplitTerrainWeights)
   {
+    // Combined weight maps are decoded here and written as TGA with the other rasters
     std::vector<UTerrainWeightMapTexture*> maps = actor->GetWeightMaps();
     for (UTerrainWeightMapTexture* map : maps)
     {
@@ -3581,69 +3750,43 @@ void ExportTerrainActor(T3DFile& f, LevelExportContext& ctx, UTerrain* actor)
       }
 
       std::filesystem::path texPath = dst / map->GetObjectNameString().UTF8();
-      texPath.replace_extension(HasAVX2() ? "tga" : "dds");
-
-      if (ctx.Config.OverrideData || !std::filesystem::exists(texPath))
+      texPath.replace_extension("tga");
+      if (!ctx.Config.OverrideData && std::filesystem::exists(texPath, err))
       {
-        map->Load();
-
-        TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-        switch (map->Format)
-        {
-        case PF_A8R8G8B8:
-          inputFormat = TextureProcessor::TCFormat::ARGB8;
-          break;
-        case PF_DXT1:
-          inputFormat = TextureProcessor::TCFormat::DXT1;
-          break;
-        case PF_DXT3:
-          inputFormat = TextureProcessor::TCFormat::DXT3;
-          break;
-        case PF_DXT5:
-          inputFormat = TextureProcessor::TCFormat::DXT5;
-          break;
-        default:
-          break;
-        }
-
-        if (inputFormat == TextureProcessor::TCFormat::None)
-        {
-          ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap " + map->GetObjectNameString().UTF8() + ". Unsupported pixel format.");
-          LogW("Failed to export %s weightmap %s: unsupported pixel format.", actor->GetObjectPath().UTF8().c_str(), map->GetObjectNameString().UTF8());
-          continue;
-        }
+        continue;
+      }
 
-        FTexture2DMipMap* mip = nullptr;
-        for (FTexture2DMipMap* mipmap : map->Mips)
-        {
-          if (!mipmap->Data)
-          {
-            continue;
-          }
-          mip = mipmap;
-          break;
-        }
-        if (!mip)
-        {
-          ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap " + map->GetObjectNameString().UTF8() + ". No mipmaps.");
-          LogW("Failed to export %s weightmap %s: mo mips.", actor->GetObjectPath().UTF8().c_str(), map->GetObjectNameString().UTF8());
-          continue;
-        }
+      map->Load();
+      TextureDecoder::Format format = TextureDecoder::GetFormat(map->Format);
+      if (format == TextureDecoder::Format::Unknown)
+      {
+        ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap " + map->GetObjectNameString().UTF8() + ". Unsupported pixel format.");
+        LogW("Failed to export %s weightmap %s: unsupported pixel format.", actor->GetObjectPath().UTF8().c_str(), map->GetObjectNameString().UTF8().c_str());
+        continue;
+      }
 
-        TextureProcessor processor(inputFormat, HasAVX2() ? TextureProcessor::TCFormat::TGA : TextureProcessor::TCFormat::DDS);
-        processor.SetOutputPath(W2A(texPath.wstring()));
-        processor.SetInputData(mip->Data->GetAllocation(), mip->Data->GetBulkDataSize());
-        processor.SetInputDataDimensions(mip->SizeX, mip->SizeY);
+      FTexture2DMipMap* mip = TextureFormats::GetTopMip(map);
+      if (!mip)
+      {
+        ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap " + map->GetObjectNameString().UTF8() + ". No mipmaps.");
+        LogW("Failed to export %s weightmap %s: no mips.", actor->GetObjectPath().UTF8().c_str(), map->GetObjectNameString().UTF8().c_str());
+        continue;
+      }
 
-        if (!processor.Process())
-        {
-          ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap " + map->GetObjectNameString().UTF8() + ". " + processor.GetError());
-          LogW("Failed to export %s weightmap %s: %s", actor->GetObjectPath().UTF8().c_str(), map->GetObjectNameString().UTF8(), processor.GetError().c_str());
-        }
+      void* pixels = malloc(size_t(mip->SizeX) * mip->SizeY * 4);
+      if (!pixels || !TextureDecoder::Decode(format, mip->Data->GetAllocation(), mip->Data->GetBulkDataSize(), mip->SizeX, mip->SizeY, (uint8*)pixels))
+      {
+        free(pixels);
+        ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap " + map->GetObjectNameString().UTF8() + ". Failed to decode the texture.");
+        LogW("Failed to export %s weightmap %s: failed to decode the texture.", actor->GetObjectPath().UTF8().c_str(), map->GetObjectNameString().UTF8().c_str());
+        continue;
       }
+      jobs.emplace_back(TerrainRaster::Adopt(pixels, mip->SizeX, mip->SizeY, 4), texPath, "weightmap");
     }
   }
 
+  SaveTerrainRasters(ctx, actor, jobs);
+
   dst = ctx.GetTerrainDir();
   dst /= actor->GetPackage()->GetPackageName().UTF8();
   dst /= actor->GetObjectNameString().UTF8();
@@ -3669,8 +3812,27 @@ void ExportTerrainActor(T3DFile& f, LevelExportContext& ctx, UTerrain* actor)
     FVector scale = actor->DrawScale3D * actor->DrawScale * ctx.Config.GlobalScale;
     if (ctx.Config.ResampleTerrain)
     {
-      scale.X *= actor->GetHeightMapRatioX();
-      scale.Y *= actor->GetHeightMapRatioY();
+      // The maps may have been exported by a previous run. Their sizes are needed for the ratio.
+      if (!weightsWidth)
+      {
+        GetWeightsSize(weightsWidth, weightsHeight);
+      }
+      if (!heightsWidth)
+      {
+        // The height map has a sample per terrain vertex
+        heightsWidth = actor->NumVerticesX;
+        heightsHeight = actor->NumVerticesY;
+      }
+      // Ratio of the resampling applied to the height map. Terrains without weight maps are not
+      // resampled. Corners are aligned, so sample spacing scales with the number of intervals.
+      if (heightsWidth > 1 && weightsWidth > 1)
+      {
+        scale.X *= float(heightsWidth - 1) / float(weightsWidth - 1);
+      }
+      if (heightsHeight > 1 && weightsHeight > 1)
+      {
+        scale.Y *= float(heightsHeight - 1) / float(weightsHeight - 1);
+      }
     }
     ctx.TerrainInfo.emplace_back(actor->GetPackage()->GetPackageName().UTF8() + '_' + actor->GetObjectNameString().UTF8() + '\n');
     ctx.TerrainInfo.emplace_back(FString::Sprintf("\tLocation: (X=%06f,Y=%06f,Z=%06f)\n", loc.X, loc.Y, loc.Z).UTF8().c_str());
@@ -3778,90 +3940,51 @@ void ExportTerrainActor(T3DFile& f, LevelExportContext& ctx, UTerrain* actor)
   }
 }
 
-void ExportLandscapeActor(T3DFile& f, LevelExportContext& ctx, ULandscape* actor)
+void ExportLandscapeActor(T3DWriter& f, LevelExportContext& ctx, ULandscape* actor)
 {
-  int32 width = 0;
-  int32 height = 0;
-
   std::error_code err;
-  std::filesystem::path dst = ctx.GetTerrainDir();
-  dst /= actor->GetPackage()->GetPackageName().UTF8();
-  dst /= actor->GetObjectNameString().UTF8();
+  const std::filesystem::path landscapeDir = ctx.GetTerrainDir() / actor->GetPackage()->GetPackageName().UTF8() / actor->GetObjectNameString().UTF8();
+  std::filesystem::path dst = landscapeDir / "WeightMaps";
   if (!std::filesystem::exists(dst, err))
   {
     std::filesystem::create_directories(dst, err);
   }
-  dst /= "HeightMap";
-  dst.replace_extension(HasAVX2() ? "png" : "dds");
-
 
-  if (ctx.Config.OverrideData || !std::filesystem::exists(dst, err))
+  std::vector<TerrainRasterJob> jobs;
+  std::filesystem::path heightsPath = landscapeDir / "HeightMap";
+  heightsPath.replace_extension("png");
+  if (ctx.Config.OverrideData || !std::filesystem::exists(heightsPath, err))
   {
-    if (!std::filesystem::exists(ctx.GetTerrainDir(), err))
-    {
-      std::filesystem::create_directories(ctx.GetTerrainDir(), err);
-    }
     UTextureBitmapInfo bitmap;
     actor->GetHeightMapData(bitmap);
     if (!bitmap.Allocation)
     {
       return;
     }
-    TextureProcessor processor(TextureProcessor::TCFormat::G16, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-    processor.SetOutputPath(W2A(dst.wstring()));
-    processor.SetInputData(bitmap.Allocation, bitmap.Size);
-    processor.SetInputDataDimensions(bitmap.Width, bitmap.Height);
-    if (!processor.Process())
-    {
-      ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " heightmap: " + processor.GetError());
-      LogW("Failed to export %s heights: %s", actor->GetObjectPath().UTF8().c_str(), processor.GetError().c_str());
-      free(bitmap.Allocation);
-      return;
-    }
-    free(bitmap.Allocation);
-  }
-
-  dst = ctx.GetTerrainDir();
-  dst /= actor->GetPackage()->GetPackageName().UTF8();
-  dst /= actor->GetObjectNameString().UTF8();
-  dst /= "WeightMaps";
-
-  if (!std::filesystem::exists(dst, err))
-  {
-    std::filesystem::create_directories(dst, err);
+    jobs.emplace_back(TerrainRaster::Adopt(bitmap.Allocation, bitmap.Width, bitmap.Height, sizeof(uint16)), heightsPath, "heightmap");
   }
 
+  for (int32 idx = 0; idx < actor->Layers.size(); ++idx)
   {
-    for (int32 idx = 0; idx < actor->Layers.size(); ++idx)
+    const auto& layer = actor->Layers[idx];
+    std::filesystem::path texPath = dst / layer.LayerName.String().UTF8();
+    texPath.replace_extension("png");
+    if (!ctx.Config.OverrideData && std::filesystem::exists(texPath, err))
     {
-      const auto& layer = actor->Layers[idx];
-      UTextureBitmapInfo bitmap;
-      actor->GetWeighMapData(layer.LayerName, bitmap);
-      if (!bitmap.Allocation)
-      {
-        continue;
-      }
-      std::filesystem::path texPath = dst / layer.LayerName.String().UTF8();
-      texPath.replace_extension(HasAVX2() ? "png" : "dds");
-      if (ctx.Config.OverrideData || !std::filesystem::exists(texPath))
-      {
-        TextureProcessor processor(TextureProcessor::TCFormat::G8, HasAVX2() ? TextureProcessor::TCFormat::PNG : TextureProcessor::TCFormat::DDS);
-        processor.SetOutputPath(W2A(texPath.wstring()));
-        processor.SetInputData(bitmap.Allocation, bitmap.Size);
-        processor.SetInputDataDimensions(bitmap.Width, bitmap.Height);
-        if (!processor.Process())
-        {
-          ctx.Errors.emplace_back("Error: Failed to export " + GetActorName(actor) + " weightmap: " + processor.GetError());
-          LogW("Failed to export %s weightmap: %s", actor->GetObjectPath().UTF8().c_str(), processor.GetError().c_str());
-        }
-      }
-      free(bitmap.Allocation);
+      continue;
     }
+    UTextureBitmapInfo bitmap;
+    actor->GetWeighMapData(layer.LayerName, bitmap);
+    if (!bitmap.Allocation)
+    {
+      continue;
+    }
+    jobs.emplace_back(TerrainRaster::Adopt(bitmap.Allocation, bitmap.Width, bitmap.Height, 1), texPath, "weightmap");
   }
 
-  dst = ctx.GetTerrainDir();
-  dst /= actor->GetPackage()->GetPackageName().UTF8();
-  dst /= actor->GetObjectNameString().UTF8();
+  SaveTerrainRasters(ctx, actor, jobs);
+
+  dst = landscapeDir;
 
   if (!std::filesystem::exists(dst, err))
   {
@@ -3924,4 +4047,153 @@ void ExportLandscapeActor(T3DFile& f, LevelExportContext& ctx, ULandscape* actor
       }
     }
   }
-}
\ No newline at end of file
+}
+
+bool WriteFileData(const std::filesystem::path& path, const void* data, size_t size)
+{
+  std::ofstream s;
+  // The data is written in one call. Skip the stream buffer to avoid an extra copy.
+  s.rdbuf()->pubsetbuf(nullptr, 0);
+  s.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!s.is_open())
+  {
+    return false;
+  }
+  s.write((const char*)data, size);
+  return s.good();
+}
+
+void ExportWaves(LevelExportContext& ctx, ProgressWindow& progress)
+{
+  std::vector<USoundNodeWave*> waves;
+  waves.reserve(ctx.Waves.size());
+  for (UObject* obj : ctx.Waves)
+  {
+    if (USoundNodeWave* wave = Cast<USoundNodeWave>(obj))
+    {
+      waves.emplace_back(wave);
+    }
+  }
+
+  // Each wave is written right after it's loaded, so only one sound payload is pending at a time
+  progress.GetReporter().SetMaxProgress((int32)waves.size());
+  int32 curProgress = 0;
+  std::unordered_set<std::wstring> dirs;
+  for (USoundNodeWave* wave : waves)
+  {
+    if (progress.IsCanceled())
+    {
+      return;
+    }
+    progress.GetReporter().SetActionText(wxString(ctx.DryRun ? "Resolving: " : "Exporting: ") + wave->GetObjectNameString().UTF8());
+    progress.GetReporter().SetCurrentProgress(++curProgress);
+    std::filesystem::path path = ctx.GetWaveDir() / wave->GetLocalDir().UTF8();
+    if (!ctx.DryRun && dirs.insert(path.wstring()).second)
+    {
+      std::error_code err;
+      std::filesystem::create_directories(path, err);
+    }
+    path /= (wave->GetObjectNameString() + ".ogg").WString();
+    std::error_code err;
+    // Don't load the sound data if the file will be skipped anyway
+    if (!ctx.Config.OverrideData && std::filesystem::exists(path, err))
+    {
+      continue;
+    }
+    if (ctx.DryRun)
+    {
+      // The serialized object is the sound payload plus a few properties. Good enough for an estimate.
+      ctx.Report.AddItem(LevelExportReport::Waves, wave->GetSerialSize());
+      continue;
+    }
+    wave->Load();
+    const int32 size = wave->GetResourceSize();
+    if (!size)
+    {
+      continue;
+    }
+    const void* data = wave->GetResourceData();
+    if (!data || !WriteFileData(path, data, size))
+    {
+      ctx.Errors.emplace_back("Error! Failed to save " + wave->GetObjectPath().UTF8() + " to " + path.u8string());
+      continue;
+    }
+    ctx.Report.AddItem(LevelExportReport::Waves, size);
+  }
+}
+
+void ExportCues(LevelExportContext& ctx)
+{
+  std::error_code ec;
+  if (ctx.DryRun)
+  {
+    for (const auto& p : ctx.CuesMap)
+    {
+      std::filesystem::path path = ctx.GetCueDir() / p.first->GetLocalDir().UTF8() / (p.first->GetObjectNameString() + ".cue").UTF8();
+      if (ctx.Config.OverrideData || !std::filesystem::exists(path, ec))
+      {
+        ctx.Report.AddItem(LevelExportReport::Cues, p.second.size());
+      }
+    }
+    return;
+  }
+  {
+    std::filesystem::path dirp = ctx.GetCueDir();
+    std::filesystem::create_directories(dirp, ec);
+    dirp = dirp.parent_path().parent_path();
+    dirp /= "DO_NOT_COPY_TO_UE4";
+    std::ofstream marker(dirp);
+  }
+
+  struct CueExportJob {
+    const std::string* Data = nullptr;
+    std::filesystem::path Path;
+    bool Saved = false;
+  };
+  std::vector<CueExportJob> jobs;
+  jobs.reserve(ctx.CuesMap.size());
+  std::unordered_set<std::wstring> dirs;
+  for (const auto& p : ctx.CuesMap)
+  {
+    CueExportJob& job = jobs.emplace_back();
+    job.Data = &p.second;
+    job.Path = ctx.GetCueDir() / p.first->GetLocalDir().UTF8();
+    if (dirs.insert(job.Path.wstring()).second)
+    {
+      std::filesystem::create_directories(job.Path, ec);
+    }
+    job.Path /= (p.first->GetObjectNameString() + ".cue").UTF8();
+  }
+
+  std::for_each(std::execution::par, jobs.begin(), jobs.end(), [&](CueExportJob& job) {
+    std::error_code err;
+    if (std::filesystem::exists(job.Path, err) && !ctx.Config.OverrideData)
+    {
+      return;
+    }
+    // Text mode, so the cues get the platform line endings
+    std::ofstream s(job.Path);
+    s << *job.Data;
+    job.Saved = s.good();
+    if (job.Saved)
+    {
+      ctx.Report.AddItem(LevelExportReport::Cues, job.Data->size());
+    }
+  });
+
+  // Keep the list in the map order
+  FString cuesList;
+  for (const CueExportJob& job : jobs)
+  {
+    if (job.Saved)
+    {
+      cuesList += job.Path.wstring();
+      cuesList += "\n";
+    }
+  }
+  if (!std::filesystem::exists(ctx.GetCuesInfoPath(), ec) || ctx.Config.OverrideData)
+  {
+    std::ofstream ofs(ctx.GetCuesInfoPath());
+    ofs << cuesList.UTF8();
+  }
+}
@@ -1,5 +1,7 @@
 #include "PrefabEditor.h"
 #include "../Windows/PackageWindow.h"
+#include "../Misc/OSGMeshBuffers.h"
+#include "../Misc/TextureCache.h"
 
 #include <osgViewer/ViewerEventHandlers>
 #include <osgGA/TrackballManipulator>
@@ -183,55 +185,30 @@ osg::MatrixTransform* CreateStaticMesh(UStaticMeshComponent* component)
 
   const FStaticMeshRenderData* model = mesh->GetLod(0);
 
-  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
-  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array(osg::Array::BIND_PER_VERTEX);
-
-  std::vector<FStaticVertex> uvertices = model->GetVertices();
-  for (auto& uvertex : uvertices)
-  {
-    FVector normal = uvertex.TangentZ;
-    normals->push_back(osg::Vec3(normal.X, -normal.Y, normal.Z));
-    vertices->push_back(osg::Vec3(uvertex.Position.X, -uvertex.Position.Y, uvertex.Position.Z));
-    uvs->push_back(osg::Vec2(uvertex.UVs[0].X, uvertex.UVs[0].Y));
-  }
+  OSGMeshBuffers buffers(model);
 
   osg::Geode* geode = new osg::Geode;
   std::vector<FStaticMeshElement> elements = model->GetElements();
-  const FRawIndexBuffer& indexContainer = model->IndexBuffer;
   for (const FStaticMeshElement& section : elements)
   {
     if (!section.NumTriangles)
     {
       continue;
     }
-    osg::Geometry* geo = new osg::Geometry;
-    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
-    for (uint32 faceIndex = 0; faceIndex < section.NumTriangles; ++faceIndex)
+    osg::ref_ptr<osg::Geometry> geo = buffers.CreateSection(section.FirstIndex, section.NumTriangles);
+    if (!geo)
     {
-      indices->push_back(indexContainer.GetIndex(section.FirstIndex + (faceIndex * 3) + 0));
-      indices->push_back(indexContainer.GetIndex(section.FirstIndex + (faceIndex * 3) + 1));
-      indices->push_back(indexContainer.GetIndex(section.FirstIndex + (faceIndex * 3) + 2));
+      continue;
     }
-    geo->addPrimitiveSet(indices.get());
-    geo->setVertexArray(vertices.get());
-    geo->setNormalArray(normals.get());
-    geo->setTexCoordArray(0, uvs.get());
 
     if (UMaterialInterface* material = Cast<UMaterialInterface>(section.Material))
     {
       if (UTexture2D* tex = material->GetDiffuseTexture())
       {
-        osg::ref_ptr<osg::Image> img = new osg::Image;
-        UTextureBitmapInfo info(64);
-        if (tex->GetBitmapData(info) && info.IsValid())
+        if (osg::ref_ptr<osg::Texture2D> osgtex = TextureCache::Get().GetTexture(tex, 64))
         {
-          img->setImage(info.Width, info.Height, 0, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
+          geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex);
         }
-        osg::ref_ptr<osg::Texture2D> osgtex = new osg::Texture2D(img);
-        osgtex->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::REPEAT);
-        osgtex->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::REPEAT);
-        geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex.get());
         if (material->GetBlendMode() == EBlendMode::BLEND_Masked)
         {
           geo->getOrCreateStateSet()->setAttributeAndModes(new osg::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
@@ -284,36 +261,17 @@ osg::MatrixTransform* CreateSkelMesh(USkeletalMeshComponent* component)
 
   const FStaticLODModel* model = mesh->GetLod(0);
 
-  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
-  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array(osg::Array::BIND_PER_VERTEX);
-
-  std::vector<FSoftSkinVertex> uvertices = model->GetVertices();
-  for (int32 idx = 0; idx < uvertices.size(); ++idx)
-  {
-    FVector normal = uvertices[idx].TangentZ;
-    normals->push_back(osg::Vec3(normal.X, -normal.Y, normal.Z));
-    vertices->push_back(osg::Vec3(uvertices[idx].Position.X, -uvertices[idx].Position.Y, uvertices[idx].Position.Z));
-    uvs->push_back(osg::Vec2(uvertices[idx].UVs[0].X, uvertices[idx].UVs[0].Y));
-  }
+  OSGMeshBuffers buffers(model);
 
   osg::Geode* geode = new osg::Geode;
   std::vector<const FSkelMeshSection*> sections = model->GetSections();
-  const FMultiSizeIndexContainer* indexContainer = model->GetIndexContainer();
   for (const FSkelMeshSection* section : sections)
   {
-    osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
-    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
-    for (uint32 faceIndex = 0; faceIndex < section->NumTriangles; ++faceIndex)
+    osg::ref_ptr<osg::Geometry> geo = buffers.CreateSection(section->BaseIndex, section->NumTriangles);
+    if (!geo)
     {
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 0));
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 1));
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 2));
+      continue;
     }
-    geo->addPrimitiveSet(indices.get());
-    geo->setVertexArray(vertices.get());
-    geo->setNormalArray(normals.get());
-    geo->setTexCoordArray(0, uvs.get());
 
     // TODO: Use MaterialMap to remap section materials to the global materials list
     if (mesh->GetMaterials().size() > section->MaterialIndex)
@@ -322,16 +280,10 @@ osg::MatrixTransform* CreateSkelMesh(USkeletalMeshComponent* component)
       {
         if (UTexture2D* tex = material->GetDiffuseTexture())
         {
-          osg::ref_ptr<osg::Image> img = new osg::Image;
-          UTextureBitmapInfo info;
-          if (tex->GetBitmapData(info) && info.IsValid())
+          if (osg::ref_ptr<osg::Texture2D> osgtex = TextureCache::Get().GetTexture(tex))
           {
-            img->setImage(info.Width, info.Height, 0, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
+            geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex);
           }
-          osg::ref_ptr<osg::Texture2D> osgtex = new osg::Texture2D(img);
-          osgtex->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::REPEAT);
-          osgtex->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::REPEAT);
-          geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex.get());
           if (material->GetBlendMode() == EBlendMode::BLEND_Masked)
           {
             geo->getOrCreateStateSet()->setAttributeAndModes(new osg::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
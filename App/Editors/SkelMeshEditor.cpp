@@ -4,6 +4,10 @@
 #include "../Windows/ProgressWindow.h"
 #include "../Windows/MaterialMapperDialog.h"
 #include "../Misc/AConfiguration.h"
+#include "../Misc/ATrace.h"
+#include "../Misc/OSGMeshBuffers.h"
+#include "../Misc/TextureCache.h"
+#include "../Misc/TextureFormats.h"
 #include "../App.h"
 #include <wx/valnum.h>
 
@@ -645,6 +649,7 @@ void SkelMeshEditor::OnExportClicked(wxCommandEvent&)
     std::thread([&] {
       try
       {
+        TRACE_SCOPE("SkelMeshExport");
         r = utils->ExportSkeletalMesh((USkeletalMesh*)Object, ctx);
       }
       catch (const std::exception& e)
@@ -666,6 +671,7 @@ void SkelMeshEditor::OnExportClicked(wxCommandEvent&)
   {
     try
     {
+      TRACE_SCOPE("SkelMeshExport");
       r = utils->ExportSkeletalMesh((USkeletalMesh*)Object, ctx);
     }
     catch (const std::exception& e)
@@ -765,38 +771,14 @@ void SkelMeshEditor::OnExportClicked(wxCommandEvent&)
 
         if (UTexture2D* texture = Cast<UTexture2D>(p.second))
         {
-          TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-          switch (texture->Format)
+          TextureProcessor::TCFormat inputFormat = TextureFormats::GetProcessorFormat(texture->Format);
+          if (inputFormat == TextureProcessor::TCFormat::None)
           {
-          case PF_DXT1:
-            inputFormat = TextureProcessor::TCFormat::DXT1;
-            break;
-          case PF_DXT3:
-            inputFormat = TextureProcessor::TCFormat::DXT3;
-            break;
-          case PF_DXT5:
-            inputFormat = TextureProcessor::TCFormat::DXT5;
-            break;
-          case PF_A8R8G8B8:
-            inputFormat = TextureProcessor::TCFormat::ARGB8;
-            break;
-          case PF_G8:
-            inputFormat = TextureProcessor::TCFormat::G8;
-            break;
-          default:
             LogE("Failed to export texture %s. Invalid format!", texture->GetObjectNameString().UTF8().c_str());
             continue;
           }
 
-          FTexture2DMipMap* mip = nullptr;
-          for (FTexture2DMipMap* mipmap : texture->Mips)
-          {
-            if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-            {
-              mip = mipmap;
-              break;
-            }
-          }
+          FTexture2DMipMap* mip = TextureFormats::GetTopMip(texture);
           if (!mip)
           {
             LogE("Failed to export texture %s. No mipmaps!", texture->GetObjectNameString().UTF8().c_str());
@@ -824,83 +806,24 @@ void SkelMeshEditor::OnExportClicked(wxCommandEvent&)
         }
         else if (UTextureCube* cube = Cast<UTextureCube>(p.second))
         {
-          auto faces = cube->GetFaces();
-          bool ok = true;
-          TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-          for (UTexture2D* face : faces)
-          {
-            if (!face)
-            {
-              LogW("Failed to export a texture cube %s. Can't get one of the faces.", p.second->GetObjectPath().UTF8().c_str());
-              ok = false;
-              break;
-            }
-            TextureProcessor::TCFormat f = TextureProcessor::TCFormat::None;
-            switch (face->Format)
-            {
-            case PF_DXT1:
-              f = TextureProcessor::TCFormat::DXT1;
-              break;
-            case PF_DXT3:
-              f = TextureProcessor::TCFormat::DXT3;
-              break;
-            case PF_DXT5:
-              f = TextureProcessor::TCFormat::DXT5;
-              break;
-            case PF_A8R8G8B8:
-              f = TextureProcessor::TCFormat::ARGB8;
-              break;
-            case PF_G8:
-              f = TextureProcessor::TCFormat::G8;
-              break;
-            default:
-              LogE("Failed to export texture cube %s.%s. Invalid face format!", p.second->GetObjectPath().UTF8().c_str(), face->GetObjectNameString().UTF8().c_str());
-              ok = false;
-              break;
-            }
-            if (inputFormat != TextureProcessor::TCFormat::None && inputFormat != f)
-            {
-              LogE("Failed to export texture cube %s.%s. Faces have different format!", p.second->GetObjectPath().UTF8().c_str(), face->GetObjectNameString().UTF8().c_str());
-              ok = false;
-              break;
-            }
-            inputFormat = f;
-          }
-
-          if (!ok)
+          TextureCubeInput input(cube);
+          if (!input.IsValid())
           {
+            LogE("%s", input.GetError().c_str());
             continue;
           }
 
           // UE4 accepts texture cubes only in a DDS container with A8R8G8B8 format and proper flags. Export cubes this way regardless of the user's output format.
           path.replace_extension("dds");
-          TextureProcessor processor(inputFormat, TextureProcessor::TCFormat::DDS);
-          for (int32 faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
-          {
-            FTexture2DMipMap* mip = nullptr;
-            for (FTexture2DMipMap* mipmap : faces[faceIdx]->Mips)
-            {
-              if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-              {
-                mip = mipmap;
-                break;
-              }
-            }
-            if (!mip)
-            {
-              LogE("Failed to export texture cube face %s.%s. No mipmaps!", cube->GetObjectPath().UTF8().c_str(), faces[faceIdx]->GetObjectNameString().UTF8().c_str());
-              ok = false;
-              break;
-            }
-
-            processor.SetInputCubeFace(faceIdx, mip->Data->GetAllocation(), mip->Data->GetBulkDataSize(), mip->SizeX, mip->SizeY);
-          }
-
-          if (!ok)
+          if (!input.Decode(TextureProcessor::TCFormat::DDS))
           {
+            LogE("%s", input.GetError().c_str());
             continue;
           }
 
+          TextureProcessor processor(input.GetProcessorFormat(), TextureProcessor::TCFormat::DDS);
+          input.SetProcessorInput(processor);
+
           processor.SetOutputPath(W2A(path.wstring()));
 
           try
@@ -1078,35 +1001,16 @@ void SkelMeshEditor::CreateRenderModel()
   osg::ref_ptr<osgAnimation::Skeleton> skeleton = CreateSkeleton(Mesh->GetReferenceSkeleton());
   const FStaticLODModel* model = Mesh->GetLod(0);
 
-  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
-  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array(osg::Array::BIND_PER_VERTEX);
-
-  std::vector<FSoftSkinVertex> uvertices = model->GetVertices();
-  for (int32 idx = 0; idx < uvertices.size(); ++idx)
-  {
-    FVector normal = uvertices[idx].TangentZ;
-    normals->push_back(osg::Vec3(normal.X, -normal.Y, normal.Z));
-    vertices->push_back(osg::Vec3(uvertices[idx].Position.X, -uvertices[idx].Position.Y, uvertices[idx].Position.Z));
-    uvs->push_back(osg::Vec2(uvertices[idx].UVs[0].X, uvertices[idx].UVs[0].Y));
-  }
+  OSGMeshBuffers buffers(model);
 
   std::vector<const FSkelMeshSection*> sections = model->GetSections();
-  const FMultiSizeIndexContainer* indexContainer = model->GetIndexContainer();
   for (const FSkelMeshSection* section : sections)
   {
-    osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
-    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
-    for (uint32 faceIndex = 0; faceIndex < section->NumTriangles; ++faceIndex)
+    osg::ref_ptr<osg::Geometry> geo = buffers.CreateSection(section->BaseIndex, section->NumTriangles);
+    if (!geo)
     {
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 0));
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 1));
-      indices->push_back(indexContainer->GetIndex(section->BaseIndex + (faceIndex * 3) + 2));
+      continue;
     }
-    geo->addPrimitiveSet(indices.get());
-    geo->setVertexArray(vertices.get());
-    geo->setNormalArray(normals.get());
-    geo->setTexCoordArray(0, uvs.get());
 
     // TODO: Use MaterialMap to remap section materials to the global materials list
     if (Mesh->GetMaterials().size() > section->MaterialIndex)
@@ -1115,16 +1019,10 @@ void SkelMeshEditor::CreateRenderModel()
       {
         if (UTexture2D* tex = material->GetDiffuseTexture())
         {
-          osg::ref_ptr<osg::Image> img = new osg::Image;
-          UTextureBitmapInfo info;
-          if (tex->GetBitmapData(info) && info.IsValid())
+          if (osg::ref_ptr<osg::Texture2D> osgtex = TextureCache::Get().GetTexture(tex))
           {
-            img->setImage(info.Width, info.Height, 0, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
+            geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex);
           }
-          osg::ref_ptr<osg::Texture2D> osgtex = new osg::Texture2D(img);
-          osgtex->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::REPEAT);
-          osgtex->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::REPEAT);
-          geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, osgtex.get());
           if (material->GetBlendMode() == EBlendMode::BLEND_Masked)
           {
             geo->getOrCreateStateSet()->setAttributeAndModes(new osg::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
@@ -12,6 +12,9 @@
 #include "../Windows/TextureImporter.h"
 #include "../Windows/ProgressWindow.h"
 #include "../Windows/REDialogs.h"
+#include "../Misc/ATrace.h"
+#include "../Misc/TextureCache.h"
+#include "../Misc/TextureFormats.h"
 
 #include <Tera/Utils/ALog.h>
 #include <Tera/Cast.h>
@@ -34,6 +37,10 @@ TextureEditor::TextureEditor(wxPanel* parent, PackageWindow* window)
 
 TextureEditor::~TextureEditor()
 {
+  if (Tiles)
+  {
+    Tiles->Stop();
+  }
   if (Renderer)
   {
     delete Renderer;
@@ -52,6 +59,10 @@ void TextureEditor::OnObjectLoaded()
 
 void TextureEditor::OnTick()
 {
+  if (Renderer && Tiles && Tiles->HasPendingUpdates())
+  {
+    Renderer->requestRedraw();
+  }
   if (Renderer && Renderer->isRealized() && Renderer->checkNeedToDoFrame())
   {
     Renderer->frame();
@@ -170,59 +181,85 @@ void TextureEditor::CreateRenderer()
 
 void TextureEditor::CreateRenderTexture()
 {
-  if (!Image)
+  if (Tiles)
   {
-    Image = new osg::Image;
+    Tiles->Stop();
+    Tiles = nullptr;
   }
 
-  UTextureBitmapInfo info;
-  if (!Texture->GetBitmapData(info) || !info.IsValid())
+  int32 sizeX = 0;
+  int32 sizeY = 0;
+  osg::ref_ptr<osg::Texture2D> texture = nullptr;
+  if (TiledTexture::IsSupported(Texture))
   {
+    // Big textures are cut into tiles on demand instead of being decoded at once
+    Tiles = new TiledTexture(Texture);
     Image = nullptr;
-    return;
-    
+    sizeX = Tiles->GetSizeX();
+    sizeY = Tiles->GetSizeY();
+  }
+  else
+  {
+    texture = TextureCache::Get().GetTexture(Texture);
+    if (!texture)
+    {
+      Image = nullptr;
+      return;
+    }
+    Image = texture->getImage();
+    sizeX = Image->s();
+    sizeY = Image->t();
   }
-  Image->setImage(info.Width, info.Height, 0, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
 
-  const float minV = std::min(std::max(GetSize().x, Image->s()), std::max(GetSize().y, Image->t()));
+  const float minV = std::min(std::max(GetSize().x, sizeX), std::max(GetSize().y, sizeY));
   const float canvasSizeX = GetSize().x / minV;
   const float canvasSizeY = GetSize().y / minV;
-  const float textureSizeX = Image->s() / minV;
-  const float textureSizeY = Image->t() / minV;
+  const float textureSizeX = sizeX / minV;
+  const float textureSizeY = sizeY / minV;
 
-  // Texture plane
-  osg::ref_ptr<osg::Vec3Array> verticies = new osg::Vec3Array;
-  verticies->push_back(osg::Vec3(textureSizeX * -.5, 0.0f, textureSizeY * -.5));
-  verticies->push_back(osg::Vec3(textureSizeX * .5, 0.0f, textureSizeY * -.5));
-  verticies->push_back(osg::Vec3(textureSizeX * .5, 0.0f, textureSizeY * .5));
-  verticies->push_back(osg::Vec3(textureSizeX * -.5, 0.0f, textureSizeY * .5));
+  Root = new osg::Geode;
+  Root->getOrCreateStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
 
-  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
-  normals->push_back(osg::Vec3(0.0f, -1.0f, 0.0f));
+  if (Tiles)
+  {
+    osg::ref_ptr<osg::Geode> tiles = Tiles->CreateNode(textureSizeX, textureSizeY);
+    tiles->getOrCreateStateSet()->setAttribute(Mask);
+    Root->addChild(tiles);
+  }
+  else
+  {
+    // Texture plane
+    osg::ref_ptr<osg::Vec3Array> verticies = new osg::Vec3Array;
+    verticies->push_back(osg::Vec3(textureSizeX * -.5, 0.0f, textureSizeY * -.5));
+    verticies->push_back(osg::Vec3(textureSizeX * .5, 0.0f, textureSizeY * -.5));
+    verticies->push_back(osg::Vec3(textureSizeX * .5, 0.0f, textureSizeY * .5));
+    verticies->push_back(osg::Vec3(textureSizeX * -.5, 0.0f, textureSizeY * .5));
 
-  osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array;
-  uvs->push_back(osg::Vec2(0.0f, 1.0f));
-  uvs->push_back(osg::Vec2(1.0f, 1.0f));
-  uvs->push_back(osg::Vec2(1.0f, 0.0f));
-  uvs->push_back(osg::Vec2(0.0f, 0.0f));
+    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+    normals->push_back(osg::Vec3(0.0f, -1.0f, 0.0f));
 
-  osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array;
-  colors->push_back(osg::Vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array;
+    uvs->push_back(osg::Vec2(0.0f, 1.0f));
+    uvs->push_back(osg::Vec2(1.0f, 1.0f));
+    uvs->push_back(osg::Vec2(1.0f, 0.0f));
+    uvs->push_back(osg::Vec2(0.0f, 0.0f));
 
-  osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
-  geo->setVertexArray(verticies.get());
-  geo->setNormalArray(normals.get());
-  geo->setNormalBinding(osg::Geometry::BIND_OVERALL);
-  geo->setTexCoordArray(0, uvs.get());
-  geo->setColorArray(colors);
-  geo->setColorBinding(osg::Geometry::BIND_OVERALL);
-  geo->addPrimitiveSet(new osg::DrawArrays(GL_QUADS, 0, 4));
-  geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, new osg::Texture2D(Image));
-  geo->getOrCreateStateSet()->setAttribute(Mask);
+    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array;
+    colors->push_back(osg::Vec4(1.0f, 1.0f, 1.0f, 1.0f));
 
-  Root = new osg::Geode;
-  Root->getOrCreateStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
-  Root->addDrawable(geo.get());
+    osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
+    geo->setVertexArray(verticies.get());
+    geo->setNormalArray(normals.get());
+    geo->setNormalBinding(osg::Geometry::BIND_OVERALL);
+    geo->setTexCoordArray(0, uvs.get());
+    geo->setColorArray(colors);
+    geo->setColorBinding(osg::Geometry::BIND_OVERALL);
+    geo->addPrimitiveSet(new osg::DrawArrays(GL_QUADS, 0, 4));
+    geo->getOrCreateStateSet()->setTextureAttributeAndModes(0, texture);
+    geo->getOrCreateStateSet()->setAttribute(Mask);
+
+    Root->addDrawable(geo.get());
+  }
 
   Renderer->setSceneData(Root.get());
   Renderer->getCamera()->setViewport(0, 0, GetSize().x, GetSize().y);
@@ -231,7 +268,7 @@ void TextureEditor::CreateRenderTexture()
 
   // Texture border
 
-  verticies = new osg::Vec3Array;
+  osg::ref_ptr<osg::Vec3Array> verticies = new osg::Vec3Array;
   verticies->push_back(osg::Vec3(textureSizeX * -.5, -0.1f, textureSizeY * -.5));
   verticies->push_back(osg::Vec3(textureSizeX * .5, -0.1f, textureSizeY * -.5));
 
@@ -244,13 +281,13 @@ void TextureEditor::CreateRenderTexture()
   verticies->push_back(osg::Vec3(textureSizeX * -.5, -0.1f, textureSizeY * .5));
   verticies->push_back(osg::Vec3(textureSizeX * -.5, -0.1f, textureSizeY * -.5));
 
-  normals = new osg::Vec3Array;
+  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
   normals->push_back(osg::Vec3(0.0f, -1.0f, 0.0f));
 
-  colors = new osg::Vec4Array;
+  osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array;
   colors->push_back(osg::Vec4(1.0f, 1.0f, 1.0f, 1.0f));
 
-  geo = new osg::Geometry;
+  osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
 
   geo->setVertexArray(verticies.get());
   geo->setNormalArray(normals.get());
@@ -267,28 +304,29 @@ void TextureEditor::CreateRenderTexture()
 
 void TextureEditor::OnImportClicked(wxCommandEvent&)
 {
+  if (Tiles)
+  {
+    // Workers read mip data that the import replaces
+    Tiles->Stop();
+  }
   TextureImporter importer(this, Texture);
   if (importer.Run())
   {
+    TextureCache::Get().Invalidate(Texture);
     CreateRenderTexture();
     SendEvent(Window, UPDATE_PROPERTIES);
   }
+  else if (Tiles)
+  {
+    CreateRenderTexture();
+  }
 }
 
 void TextureEditor::OnExportClicked(wxCommandEvent&)
 {
   LogI("Export a texture...");
 
-  FTexture2DMipMap* mip = nullptr;
-  for (FTexture2DMipMap* mipmap : Texture->Mips)
-  {
-    if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-    {
-      mip = mipmap;
-      break;
-    }
-  }
-
+  FTexture2DMipMap* mip = TextureFormats::GetTopMip(Texture);
   if (!mip)
   {
     LogE("Export canceled: This texture object has no mipmaps!");
@@ -309,30 +347,9 @@ void TextureEditor::OnExportClicked(wxCommandEvent&)
   }
   ext.MakeLower();
 
-  TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
+  TextureProcessor::TCFormat inputFormat = TextureFormats::GetProcessorFormat(Texture->Format);
   TextureProcessor::TCFormat outputFormat = TextureProcessor::TCFormat::None;
-
-  if (Texture->Format == PF_DXT1)
-  {
-    inputFormat = TextureProcessor::TCFormat::DXT1;
-  }
-  else if (Texture->Format == PF_DXT3)
-  {
-    inputFormat = TextureProcessor::TCFormat::DXT3;
-  }
-  else if (Texture->Format == PF_DXT5)
-  {
-    inputFormat = TextureProcessor::TCFormat::DXT5;
-  }
-  else if (Texture->Format == PF_A8R8G8B8)
-  {
-    inputFormat = TextureProcessor::TCFormat::ARGB8;
-  }
-  else if (Texture->Format == PF_G8)
-  {
-    inputFormat = TextureProcessor::TCFormat::G8;
-  }
-  else
+  if (inputFormat == TextureProcessor::TCFormat::None)
   {
     std::string msg = std::string("Format ") + PixelFormatToString(Texture->Format).String() + " is not supported!";
     REDialog::Error(msg);
@@ -367,6 +384,7 @@ void TextureEditor::OnExportClicked(wxCommandEvent&)
   std::string err;
   try
   {
+    TRACE_SCOPE("TextureProcess");
     if (!(result = processor.Process()))
     {
       err = processor.GetError();
@@ -507,44 +525,11 @@ void TextureCubeEditor::OnExportClicked(wxCommandEvent&)
     return;
   }
 
-  auto faces = cube->GetFaces();
-  TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-  for (UTexture2D* face : faces)
+  TextureCubeInput input(cube);
+  if (!input.IsValid())
   {
-    if (!face)
-    {
-      REDialog::Error("Failed to load the cube face!");
-      return;
-    }
-
-    TextureProcessor::TCFormat f = TextureProcessor::TCFormat::None;
-    switch (face->Format)
-    {
-    case PF_DXT1:
-      f = TextureProcessor::TCFormat::DXT1;
-      break;
-    case PF_DXT3:
-      f = TextureProcessor::TCFormat::DXT3;
-      break;
-    case PF_DXT5:
-      f = TextureProcessor::TCFormat::DXT5;
-      break;
-    case PF_A8R8G8B8:
-      f = TextureProcessor::TCFormat::ARGB8;
-      break;
-    case PF_G8:
-      f = TextureProcessor::TCFormat::G8;
-      break;
-    default:
-      REDialog::Error(wxString::Format("Failed to export texture cube %s.%s. Invalid face format!", cube->GetObjectPath().UTF8().c_str(), face->GetObjectNameString().UTF8().c_str()));
-      return;
-    }
-    if (inputFormat != TextureProcessor::TCFormat::None && inputFormat != f)
-    {
-      REDialog::Error(wxString::Format("Failed to export texture cube %s.%s. Faces have different format!", cube->GetObjectPath().UTF8().c_str(), face->GetObjectNameString().UTF8().c_str()));
-      return;
-    }
-    inputFormat = f;
+    REDialog::Error(input.GetError());
+    return;
   }
 
   wxString path = TextureImporterOptions::SaveImageDialog(Window, Object->GetObjectNameString().WString());
@@ -580,33 +565,22 @@ void TextureCubeEditor::OnExportClicked(wxCommandEvent&)
     return;
   }
 
-  TextureProcessor processor(inputFormat, outputFormat);
-  for (int32 faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+  if (!input.Decode(outputFormat))
   {
-    FTexture2DMipMap* mip = nullptr;
-    for (FTexture2DMipMap* mipmap : faces[faceIdx]->Mips)
-    {
-      if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-      {
-        mip = mipmap;
-        break;
-      }
-    }
-    if (!mip)
-    {
-      REDialog::Error(wxString::Format("Failed to export texture cube face %s.%s. No mipmaps!", cube->GetObjectPath().UTF8().c_str(), faces[faceIdx]->GetObjectNameString().UTF8().c_str()));
-      return;
-    }
-
-    processor.SetInputCubeFace(faceIdx, mip->Data->GetAllocation(), mip->Data->GetBulkDataSize(), mip->SizeX, mip->SizeY);
+    REDialog::Error(input.GetError());
+    return;
   }
 
+  TextureProcessor processor(input.GetProcessorFormat(), outputFormat);
+  input.SetProcessorInput(processor);
+
   processor.SetOutputPath(W2A(path.ToStdWstring()));
 
   bool result = false;
   std::string err;
   try
   {
+    TRACE_SCOPE("TextureProcess");
     if (!(result = processor.Process()))
     {
       err = processor.GetError();
@@ -700,100 +674,99 @@ void TextureCubeEditor::CreateRenderer()
 
 void TextureCubeEditor::CreateRenderTexture()
 {
-  if (!HasAVX2())
-  {
-    LogE("Failed to render cube: a CPU with AVX2 instructions is rquired!");
-    return;
-  }
-  if (!Image)
-  {
-    Image = new osg::Image;
-  }
-
   std::array<UTexture2D*, 6> faces = Cube->GetFaces();
-  TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-  for (auto& face : faces)
+  TextureDecoder::Format format = TextureDecoder::Format::Unknown;
+  for (UTexture2D* face : faces)
   {
     if (!face)
     {
       LogE("Failed to render cube: missing a cube face");
+      Image = nullptr;
       return;
     }
-    TextureProcessor::TCFormat f = TextureProcessor::TCFormat::None;
-    switch (face->Format)
+    TextureDecoder::Format faceFormat = TextureDecoder::GetFormat(face->Format);
+    if (faceFormat == TextureDecoder::Format::Unknown)
     {
-    case PF_DXT1:
-      f = TextureProcessor::TCFormat::DXT1;
-      break;
-    case PF_DXT3:
-      f = TextureProcessor::TCFormat::DXT3;
-      break;
-    case PF_DXT5:
-      f = TextureProcessor::TCFormat::DXT5;
-      break;
-    case PF_A8R8G8B8:
-      f = TextureProcessor::TCFormat::ARGB8;
-      break;
-    case PF_G8:
-      f = TextureProcessor::TCFormat::G8;
-      break;
+      LogE("Failed to render cube: format %s is not supported", PixelFormatToString(face->Format).String().c_str());
+      Image = nullptr;
+      return;
     }
-    if (inputFormat != TextureProcessor::TCFormat::None && inputFormat != f)
+    if (format != TextureDecoder::Format::Unknown && format != faceFormat)
     {
-      LogE("Failed to render cube: format %d is not supported", (int)inputFormat);
+      LogE("Failed to render cube: faces have different formats");
       Image = nullptr;
       return;
     }
-    inputFormat = f;
+    format = faceFormat;
   }
 
-  TextureProcessor processor(inputFormat, TextureProcessor::TCFormat::ARGB8);
+  // Unfold faces into the vertical cross nvtt's UnfoldCube produced: +Y on top, -X +Z +X in the middle,
+  // -Y and -Z at the bottom. -Z is rotated by 180 degrees.
+  static const int32 facePositions[6][2] = { { 2, 1 }, { 0, 1 }, { 1, 0 }, { 1, 2 }, { 1, 1 }, { 1, 3 } };
+  static const int32 rotatedFace = 5;
+  int32 faceSizeX = 0;
+  int32 faceSizeY = 0;
+  uint8* cross = nullptr;
+  std::vector<uint8> facePixels;
   for (int32 idx = 0; idx < faces.size(); ++idx)
   {
     UTextureBitmapInfo info;
     if (!faces[idx]->GetBitmapData(info) || !info.IsValid())
     {
+      free(cross);
       Image = nullptr;
       LogE("Failed to render cube: failed to load bitmap");
       return;
     }
-    processor.SetInputCubeFace(idx, info.Allocation, info.Size, info.Width, info.Height);
-  }
-
-  if (!processor.UnfoldCube())
-  {
-    Image = nullptr;
-    LogE("Failed to render cube: %s", processor.GetError().c_str());
-    return;
-  }
-
-  auto& mips = processor.GetOutputMips();
-  if (mips.empty())
-  {
-    LogE("Failed to render cube: texture processor outputed no mips");
-    Image = nullptr;
-    return;
-  }
-
-  bool hasVaildImage = false;
-  for (auto& mip : mips)
-  {
-    if (mip.SizeX && mip.SizeY && mip.Data)
+    if (!cross)
     {
-      void* data = malloc(mip.Size);
-      memcpy(data, mip.Data, mip.Size);
-      Image->setImage(mip.SizeX, mip.SizeY, 0, Cube->SRGB ? GL_SRGB8_ALPHA8_EXT : GL_RGBA, GL_BGRA, GL_UNSIGNED_BYTE, (uint8*)data, osg::Image::AllocationMode::USE_MALLOC_FREE);
-      hasVaildImage = true;
-      break;
+      faceSizeX = info.Width;
+      faceSizeY = info.Height;
+      cross = (uint8*)calloc(size_t(faceSizeX) * 3 * faceSizeY * 4, 4);
+      facePixels.resize(size_t(faceSizeX) * faceSizeY * 4);
+    }
+    else if (info.Width != faceSizeX || info.Height != faceSizeY)
+    {
+      free(cross);
+      Image = nullptr;
+      LogE("Failed to render cube: faces have different sizes");
+      return;
+    }
+    if (!TextureDecoder::Decode(format, info.Allocation, info.Size, info.Width, info.Height, facePixels.data()))
+    {
+      free(cross);
+      Image = nullptr;
+      LogE("Failed to render cube: failed to decode a face");
+      return;
+    }
+    const size_t crossPitch = size_t(faceSizeX) * 3 * 4;
+    const size_t facePitch = size_t(faceSizeX) * 4;
+    uint8* dst = cross + size_t(facePositions[idx][1]) * faceSizeY * crossPitch + facePositions[idx][0] * facePitch;
+    if (idx == rotatedFace)
+    {
+      const uint32* src = (const uint32*)facePixels.data();
+      for (int32 y = 0; y < faceSizeY; ++y)
+      {
+        uint32* row = (uint32*)(dst + y * crossPitch);
+        const uint32* srcRow = src + size_t(faceSizeY - 1 - y) * faceSizeX;
+        for (int32 x = 0; x < faceSizeX; ++x)
+        {
+          row[x] = srcRow[faceSizeX - 1 - x];
+        }
+      }
+      continue;
+    }
+    for (int32 y = 0; y < faceSizeY; ++y)
+    {
+      memcpy(dst + y * crossPitch, facePixels.data() + y * facePitch, facePitch);
     }
   }
 
-  if (mips.empty())
+  if (!Image)
   {
-    LogE("Failed to render cube: texture processor outputed no vaild mips");
-    Image = nullptr;
-    return;
+    Image = new osg::Image;
   }
+  Image->setImage(faceSizeX * 3, faceSizeY * 4, 0, Cube->SRGB ? GL_SRGB8_ALPHA8_EXT : GL_RGBA, GL_BGRA, GL_UNSIGNED_BYTE, cross, osg::Image::AllocationMode::USE_MALLOC_FREE);
 
   const float minV = std::min(std::max(GetSize().x, Image->s()), std::max(GetSize().y, Image->t()));
   const float canvasSizeX = GetSize().x / minV;
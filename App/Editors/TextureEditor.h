@@ -4,6 +4,7 @@
 #include <Tera/UTexture.h>
 
 #include "../CustomViews/OSGView.h"
+#include "../Misc/TiledTexture.h"
 
 class TextureEditor : public GenericEditor {
 public:
@@ -38,6 +39,8 @@ protected:
  protected:
   UTexture2D* Texture = nullptr;
   osg::ref_ptr<osg::Image> Image = nullptr;
+  // Used instead of Image for textures that don't fit a single quad
+  osg::ref_ptr<TiledTexture> Tiles = nullptr;
   osg::ref_ptr<osg::Geode> Root = nullptr;
   osg::ref_ptr<osg::ColorMask> Mask = nullptr;
   OSGCanvas* Canvas = nullptr;
@@ -387,6 +387,9 @@ FStream& operator<<(FStream& s, FAppConfig& c)
       case FAppConfig::CFG_LastBakeMod:
         s << c.LastBakeMod;
         break;
+      case FAppConfig::CFG_TextureCacheBudget:
+        s << c.TextureCacheBudget;
+        break;
       case FAppConfig::CFG_End:
         UpdateConfigValues(c);
         return s;
@@ -440,6 +443,7 @@ FStream& operator<<(FStream& s, FAppConfig& c)
     SerializeKeyValue(FAppConfig::CFG_ShowImports, c.ShowImports);
 
     SerializeKeyValue(FAppConfig::CFG_LastBakeMod, c.LastBakeMod);
+    SerializeKeyValue(FAppConfig::CFG_TextureCacheBudget, c.TextureCacheBudget);
 
     // Log
     SerializeKey(FAppConfig::CFG_LogBegin);
@@ -250,6 +250,7 @@ struct FAppConfig
     CFG_LastDcClient,
     CFG_ShowImports,
     CFG_LastBakeMod,
+    CFG_TextureCacheBudget,
 
     // Log
     CFG_LogBegin = 100,
@@ -349,6 +350,8 @@ struct FAppConfig
   bool ShowImports = false;
   // CFG_LastBakeMod
   FString LastBakeMod;
+  // CFG_TextureCacheBudget: Decoded texture cache size in megabytes
+  int32 TextureCacheBudget = 512;
 
   // Fast accessor to the last opened GPK file path
   FString GetLastFilePackagePath() const
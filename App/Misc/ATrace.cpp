@@ -0,0 +1,142 @@
+#include "ATrace.h"
+
+#include <Tera/Utils/ALog.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+  struct TraceEvent {
+    const char* Name = nullptr;
+    int64 Start = 0;
+    // Duration of a span or the counter total
+    int64 Value = 0;
+    int8 Counter = -1;
+  };
+
+  struct ThreadBuffer {
+    uint32 ThreadId = 0;
+    // Only contended while saving
+    std::mutex Mutex;
+    std::vector<TraceEvent> Events;
+  };
+
+  const char* CounterNames[] = { "BytesRead", "BytesDecompressed", "BytesWritten" };
+  static_assert(sizeof(CounterNames) / sizeof(*CounterNames) == size_t(ATrace::Counter::Count), "Counter names mismatch");
+
+  std::mutex BuffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+  std::atomic<uint64> CounterTotals[size_t(ATrace::Counter::Count)];
+  const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+  ThreadBuffer* GetThreadBuffer()
+  {
+    // Buffers live until exit, so events of finished threads are kept
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer)
+    {
+      std::scoped_lock<std::mutex> l(BuffersMutex);
+      Buffers.emplace_back(std::make_unique<ThreadBuffer>());
+      buffer = Buffers.back().get();
+      buffer->ThreadId = uint32(Buffers.size());
+    }
+    return buffer;
+  }
+
+  void WriteEscaped(std::ofstream& s, const char* str)
+  {
+    for (; *str; ++str)
+    {
+      if (*str == '"' || *str == '\\')
+      {
+        s << '\\';
+      }
+      s << *str;
+    }
+  }
+}
+
+std::atomic_bool ATrace::Enabled = false;
+
+void ATrace::SetEnabled(bool enabled)
+{
+  Enabled = enabled;
+}
+
+int64 ATrace::Now()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count();
+}
+
+void ATrace::AddSpan(const char* name, int64 start, int64 end)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::scoped_lock<std::mutex> l(buffer->Mutex);
+  TraceEvent& e = buffer->Events.emplace_back();
+  e.Name = name;
+  e.Start = start;
+  e.Value = end - start;
+}
+
+void ATrace::AddCount(Counter counter, uint64 value)
+{
+  const uint64 total = CounterTotals[size_t(counter)].fetch_add(value) + value;
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::scoped_lock<std::mutex> l(buffer->Mutex);
+  TraceEvent& e = buffer->Events.emplace_back();
+  e.Name = CounterNames[size_t(counter)];
+  e.Start = Now();
+  e.Value = int64(total);
+  e.Counter = int8(counter);
+}
+
+bool ATrace::Save(const std::wstring& path)
+{
+  std::ofstream s(std::filesystem::path(path), std::ios::out | std::ios::trunc);
+  if (!s.is_open())
+  {
+    LogE("Failed to save the trace: can't create the file!");
+    return false;
+  }
+  s << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  std::scoped_lock<std::mutex> l(BuffersMutex);
+  for (const auto& buffer : Buffers)
+  {
+    std::scoped_lock<std::mutex> bl(buffer->Mutex);
+    for (const TraceEvent& e : buffer->Events)
+    {
+      if (!first)
+      {
+        s << ",\n";
+      }
+      first = false;
+      s << "{\"name\":\"";
+      WriteEscaped(s, e.Name);
+      if (e.Counter >= 0)
+      {
+        s << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->ThreadId << ",\"ts\":" << e.Start << ",\"args\":{\"" << e.Name << "\":" << e.Value << "}}";
+      }
+      else
+      {
+        s << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->ThreadId << ",\"ts\":" << e.Start << ",\"dur\":" << e.Value << "}";
+      }
+    }
+  }
+  s << "\n]}\n";
+  return s.good();
+}
+
+void ATraceSpan::End()
+{
+  if (Start < 0)
+  {
+    return;
+  }
+  ATrace::AddSpan(Name, Start, ATrace::Now());
+  Start = -1;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <Tera/Core.h>
+#include <Tera/Utils/APerfSamples.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Nested spans and byte counters recorded to per-thread buffers and saved as Chrome trace JSON
+// (chrome://tracing, Perfetto). Recording is off unless the app runs with --trace, so a disabled
+// span costs a single atomic load.
+class ATrace {
+public:
+  enum class Counter : uint8 {
+    BytesRead = 0,
+    BytesDecompressed,
+    BytesWritten,
+    Count
+  };
+
+  static void SetEnabled(bool enabled);
+
+  static bool IsEnabled()
+  {
+    return Enabled.load(std::memory_order_relaxed);
+  }
+
+  // Microseconds since the first call
+  static int64 Now();
+
+  // Name must be a string literal or outlive the trace
+  static void AddSpan(const char* name, int64 start, int64 end);
+
+  static void AddCount(Counter counter, uint64 value);
+
+  // Write recorded events. Returns false if the file can't be created.
+  static bool Save(const std::wstring& path);
+
+private:
+  static std::atomic_bool Enabled;
+};
+
+class ATraceSpan {
+public:
+  ATraceSpan(const char* name)
+    : Name(name)
+  {
+    if (ATrace::IsEnabled())
+    {
+      Start = ATrace::Now();
+    }
+  }
+
+  ~ATraceSpan()
+  {
+    End();
+  }
+
+  void End();
+
+private:
+  const char* Name = nullptr;
+  int64 Start = -1;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+// Span until the end of the scope
+#define TRACE_SCOPE(name) ATraceSpan TRACE_CONCAT(_traceSpan, __LINE__)(name)
+// Span with an explicit end. PERF_START/PERF_END still log the duration when the core enables them.
+#define TRACE_START(name) PERF_START(name); ATraceSpan _traceSpan_##name(#name)
+#define TRACE_END(name) _traceSpan_##name.End(); PERF_END(name)
+
+#define TRACE_BYTES_READ(size) if (ATrace::IsEnabled()) ATrace::AddCount(ATrace::Counter::BytesRead, uint64(size))
+#define TRACE_BYTES_DECOMPRESSED(size) if (ATrace::IsEnabled()) ATrace::AddCount(ATrace::Counter::BytesDecompressed, uint64(size))
+#define TRACE_BYTES_WRITTEN(size) if (ATrace::IsEnabled()) ATrace::AddCount(ATrace::Counter::BytesWritten, uint64(size))
@@ -1,5 +1,7 @@
 #include "BulkImportOperation.h"
 #include "../App.h"
+#include "ATrace.h"
+#include "TextureFormats.h"
 
 #include <filesystem>
 
@@ -268,6 +270,7 @@ void BulkImportOperation::AddError(const wxString& source, const wxString& error
 
 void BulkImportOperation::ImportTexture(FPackage* package, UTexture2D* texture, const wxString& source)
 {
+  TRACE_SCOPE("TextureImport");
   if (!texture)
   {
     AddError(package->GetPackageName().WString(), "Object is not a texture!");
@@ -305,27 +308,14 @@ void BulkImportOperation::ImportTexture(FPackage* package, UTexture2D* texture,
     texture->CompressionSettings == TC_NormalmapUncompressed ||
     texture->CompressionSettings == TC_NormalmapBC5;
 
-  switch ((processorFormat = texture->Format))
+  processorFormat = texture->Format;
+  const TextureProcessor::TCFormat outputFormat = TextureFormats::GetProcessorFormat(processorFormat);
+  if (outputFormat == TextureProcessor::TCFormat::None)
   {
-  case PF_DXT1:
-    processor.SetOutputFormat(TextureProcessor::TCFormat::DXT1);
-    break;
-  case PF_DXT3:
-    processor.SetOutputFormat(TextureProcessor::TCFormat::DXT3);
-    break;
-  case PF_DXT5:
-    processor.SetOutputFormat(TextureProcessor::TCFormat::DXT5);
-    break;
-  case PF_A8R8G8B8:
-    processor.SetOutputFormat(TextureProcessor::TCFormat::ARGB8);
-    break;
-  case PF_G8:
-    processor.SetOutputFormat(TextureProcessor::TCFormat::G8);
-    break;
-  default:
     AddError(package->GetPackageName().WString(), wxString("Can't import to textures with 0x") + std::to_string(texture->Format) + " pixel format.");
     return;
   }
+  processor.SetOutputFormat(outputFormat);
 
   processor.SetSrgb(texture->SRGB);
   processor.SetNormal(isNormal);
@@ -0,0 +1,204 @@
+#include "ExportNameIndex.h"
+
+#include <Tera/FObjectResource.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+  inline uint32 MakeTrigram(const std::string& str, size_t pos)
+  {
+    return (uint32(uint8(str[pos])) << 16) | (uint32(uint8(str[pos + 1])) << 8) | uint32(uint8(str[pos + 2]));
+  }
+
+  inline bool IsCancelled(const std::atomic_bool* cancel, size_t iteration)
+  {
+    return cancel && (iteration & 0x3FF) == 0 && cancel->load(std::memory_order_relaxed);
+  }
+}
+
+bool ExportNameIndex::IsSearchable(FObjectExport* exp)
+{
+  return !exp->Outer || exp->Outer->GetClassName() == NAME_Package || exp->Outer->GetClassName() == "Level";
+}
+
+void ExportNameIndex::AddEntry(FObjectExport* exp)
+{
+  const uint32 entryIdx = uint32(Entries.size());
+  Entry& entry = Entries.emplace_back();
+  entry.Export = exp;
+  entry.Name = exp->GetObjectNameString().ToUpper().UTF8();
+  for (size_t pos = 0; pos + 3 <= entry.Name.size(); ++pos)
+  {
+    std::vector<uint32>& list = Trigrams[MakeTrigram(entry.Name, pos)];
+    // Names may repeat a trigram
+    if (list.empty() || list.back() != entryIdx)
+    {
+      list.push_back(entryIdx);
+    }
+  }
+}
+
+bool ExportNameIndex::Build(const std::vector<FObjectExport*>& rootExports, const std::atomic_bool* cancel)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  if (Built)
+  {
+    return true;
+  }
+  size_t iteration = 0;
+  bool cancelled = false;
+  std::function<void(FObjectExport*)> visit;
+  visit = [&](FObjectExport* exp) {
+    if (cancelled || (cancelled = IsCancelled(cancel, ++iteration)))
+    {
+      return;
+    }
+    if (IsSearchable(exp))
+    {
+      AddEntry(exp);
+    }
+    for (FObjectExport* inner : exp->Inner)
+    {
+      visit(inner);
+    }
+  };
+  for (FObjectExport* exp : rootExports)
+  {
+    visit(exp);
+  }
+  if (cancelled)
+  {
+    Entries.clear();
+    Trigrams.clear();
+    return false;
+  }
+  Built = true;
+  return true;
+}
+
+void ExportNameIndex::Add(FObjectExport* exp)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  if (Built && exp && IsSearchable(exp))
+  {
+    AddEntry(exp);
+  }
+}
+
+void ExportNameIndex::Remove(PACKAGE_INDEX index)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  for (Entry& entry : Entries)
+  {
+    if (entry.Export && entry.Export->ObjectIndex == index)
+    {
+      // Keep the slot so posting lists stay valid
+      entry.Export = nullptr;
+      entry.Name.clear();
+    }
+  }
+}
+
+ExportNameIndex::Result ExportNameIndex::Find(const FString& search, const Result* previous, const std::atomic_bool* cancel) const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  Result result;
+  result.Search = search.ToUpper().UTF8();
+  result.EntryCount = uint32(Entries.size());
+
+  auto verify = [&](uint32 entryIdx) {
+    const Entry& entry = Entries[entryIdx];
+    if (entry.Export && entry.Name.find(result.Search) != std::string::npos)
+    {
+      result.Entries.push_back(entryIdx);
+    }
+  };
+
+  if (previous && !previous->Cancelled && previous->Search.size() && result.Search.find(previous->Search) != std::string::npos)
+  {
+    // Matches of the new search are a subset of the previous matches and entries added since
+    size_t iteration = 0;
+    for (uint32 entryIdx : previous->Entries)
+    {
+      if (IsCancelled(cancel, iteration++))
+      {
+        result.Cancelled = true;
+        return result;
+      }
+      verify(entryIdx);
+    }
+    for (uint32 entryIdx = previous->EntryCount; entryIdx < result.EntryCount; ++entryIdx)
+    {
+      verify(entryIdx);
+    }
+    return result;
+  }
+
+  if (result.Search.size() < 3)
+  {
+    // Too short for trigrams
+    for (uint32 entryIdx = 0; entryIdx < result.EntryCount; ++entryIdx)
+    {
+      if (IsCancelled(cancel, entryIdx))
+      {
+        result.Cancelled = true;
+        return result;
+      }
+      verify(entryIdx);
+    }
+    return result;
+  }
+
+  std::vector<const std::vector<uint32>*> lists;
+  for (size_t pos = 0; pos + 3 <= result.Search.size(); ++pos)
+  {
+    auto it = Trigrams.find(MakeTrigram(result.Search, pos));
+    if (it == Trigrams.end())
+    {
+      return result;
+    }
+    lists.push_back(&it->second);
+  }
+  std::sort(lists.begin(), lists.end(), [](const std::vector<uint32>* a, const std::vector<uint32>* b) {
+    return a->size() < b->size();
+  });
+  lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+  // Intersect starting with the shortest list
+  std::vector<uint32> candidates = *lists.front();
+  std::vector<uint32> tmp;
+  for (size_t idx = 1; idx < lists.size() && candidates.size(); ++idx)
+  {
+    if (cancel && cancel->load(std::memory_order_relaxed))
+    {
+      result.Cancelled = true;
+      return result;
+    }
+    tmp.clear();
+    std::set_intersection(candidates.begin(), candidates.end(), lists[idx]->begin(), lists[idx]->end(), std::back_inserter(tmp));
+    candidates.swap(tmp);
+  }
+  // Trigrams don't guarantee their order in the name
+  for (uint32 entryIdx : candidates)
+  {
+    verify(entryIdx);
+  }
+  return result;
+}
+
+std::vector<FObjectExport*> ExportNameIndex::GetExports(const Result& result) const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  std::vector<FObjectExport*> exports;
+  exports.reserve(result.Entries.size());
+  for (uint32 entryIdx : result.Entries)
+  {
+    if (entryIdx < Entries.size() && Entries[entryIdx].Export)
+    {
+      exports.push_back(Entries[entryIdx].Export);
+    }
+  }
+  return exports;
+}
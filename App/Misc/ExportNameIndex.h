@@ -0,0 +1,64 @@
+#pragma once
+#include <Tera/Core.h>
+#include <Tera/FString.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FObjectExport;
+
+// Trigram index over names of exports that the package search can match (top level exports and
+// exports of levels). Queries intersect posting lists of the search trigrams and verify only the
+// candidates. A query that extends the previous one narrows the previous result instead.
+class ExportNameIndex {
+public:
+  struct Result {
+    // Upper case search
+    std::string Search;
+    // Entry indices in index order
+    std::vector<uint32> Entries;
+    // Number of indexed entries at the time of the query
+    uint32 EntryCount = 0;
+    bool Cancelled = false;
+  };
+
+  // Index exports of the tree. Safe to call from a worker thread.
+  // Returns false if cancelled. The partial index is dropped, so the next call starts over.
+  bool Build(const std::vector<FObjectExport*>& rootExports, const std::atomic_bool* cancel = nullptr);
+
+  bool IsBuilt() const
+  {
+    return Built;
+  }
+
+  // Index an export added after the build
+  void Add(FObjectExport* exp);
+
+  // Drop a removed export
+  void Remove(PACKAGE_INDEX index);
+
+  // Find exports whose name contains the search. Pass the previous result to refine it.
+  Result Find(const FString& search, const Result* previous = nullptr, const std::atomic_bool* cancel = nullptr) const;
+
+  // Exports of a result. Removed exports are skipped.
+  std::vector<FObjectExport*> GetExports(const Result& result) const;
+
+private:
+  struct Entry {
+    FObjectExport* Export = nullptr;
+    std::string Name;
+  };
+
+  static bool IsSearchable(FObjectExport* exp);
+  void AddEntry(FObjectExport* exp);
+
+private:
+  std::vector<Entry> Entries;
+  // Three name bytes to ascending entry indices
+  std::unordered_map<uint32, std::vector<uint32>> Trigrams;
+  std::atomic_bool Built = false;
+  mutable std::mutex Mutex;
+};
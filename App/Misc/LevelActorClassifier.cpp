@@ -0,0 +1,114 @@
+#include "LevelActorClassifier.h"
+
+#include <Tera/Cast.h>
+#include <Tera/UActor.h>
+#include <Tera/ULevel.h>
+#include <Tera/UStaticMesh.h>
+#include <Tera/USkeletalMesh.h>
+#include <Tera/UPrefab.h>
+#include <Tera/UTerrain.h>
+#include <Tera/ULandscape.h>
+#include <Tera/ULight.h>
+
+LevelActorClassifier::LevelActorClassifier(ULevel* level)
+{
+  if (!level)
+  {
+    return;
+  }
+  Actors = level->GetActors();
+  const size_t count = Actors.size();
+  Kinds.resize(count, ActorKind::Other);
+  Hidden.resize(count, false);
+  MLods.resize(count, false);
+  Replacements.resize(count, -1);
+  Indices.reserve(count);
+
+  for (size_t idx = 0; idx < count; ++idx)
+  {
+    UActor* actor = Actors[idx];
+    if (!actor)
+    {
+      Hidden[idx] = true;
+      continue;
+    }
+    Indices[actor] = (int32)idx;
+    Hidden[idx] = actor->bHidden;
+    if (Cast<UStaticMeshActor>(actor))
+    {
+      Kinds[idx] = ActorKind::StaticMesh;
+    }
+    else if (Cast<UInterpActor>(actor))
+    {
+      Kinds[idx] = ActorKind::Interp;
+    }
+    else if (Cast<USkeletalMeshActor>(actor))
+    {
+      Kinds[idx] = ActorKind::SkeletalMesh;
+    }
+    else if (Cast<UPrefabInstance>(actor))
+    {
+      Kinds[idx] = ActorKind::Prefab;
+    }
+    else if (actor->GetClassName() == UTerrain::StaticClassName())
+    {
+      Kinds[idx] = ActorKind::Terrain;
+    }
+    else if (actor->GetClassName() == ULandscape::StaticClassName())
+    {
+      Kinds[idx] = ActorKind::Landscape;
+    }
+    else if (Cast<ULight>(actor))
+    {
+      Kinds[idx] = ActorKind::Light;
+    }
+  }
+
+  // Resolve MLODs after all actors got their indices
+  for (size_t idx = 0; idx < count; ++idx)
+  {
+    if (Kinds[idx] != ActorKind::StaticMesh && Kinds[idx] != ActorKind::Interp && Kinds[idx] != ActorKind::SkeletalMesh)
+    {
+      continue;
+    }
+    const int32 mlodIdx = IndexOf(GetReplacementActor(Actors[idx]));
+    if (mlodIdx < 0 || mlodIdx == (int32)idx)
+    {
+      continue;
+    }
+    Replacements[idx] = mlodIdx;
+    if (!MLods[mlodIdx])
+    {
+      MLods[mlodIdx] = true;
+      MLodCount++;
+    }
+  }
+}
+
+UActor* LevelActorClassifier::GetReplacementActor(UActor* actor)
+{
+  UObject* replacement = nullptr;
+  if (UStaticMeshActor* staticActor = Cast<UStaticMeshActor>(actor))
+  {
+    replacement = staticActor->StaticMeshComponent ? staticActor->StaticMeshComponent->ReplacementPrimitive : nullptr;
+  }
+  else if (UInterpActor* interpActor = Cast<UInterpActor>(actor))
+  {
+    replacement = interpActor->StaticMeshComponent ? interpActor->StaticMeshComponent->ReplacementPrimitive : nullptr;
+  }
+  else if (USkeletalMeshActor* skelActor = Cast<USkeletalMeshActor>(actor))
+  {
+    replacement = skelActor->SkeletalMeshComponent ? skelActor->SkeletalMeshComponent->ReplacementPrimitive : nullptr;
+  }
+  return replacement ? Cast<UActor>(replacement->GetOuter()) : nullptr;
+}
+
+int32 LevelActorClassifier::IndexOf(UActor* actor) const
+{
+  if (!actor)
+  {
+    return -1;
+  }
+  auto it = Indices.find(actor);
+  return it == Indices.end() ? -1 : it->second;
+}
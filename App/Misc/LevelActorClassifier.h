@@ -0,0 +1,84 @@
+#pragma once
+#include <Tera/Core.h>
+
+#include <unordered_map>
+#include <vector>
+
+class UActor;
+class ULevel;
+
+// Single pass over the actors of a level shared by the level viewer and the exporter.
+// Class, visibility and MLOD relations are resolved once, so per-actor checks are O(1)
+// instead of scanning a skip list for every actor.
+class LevelActorClassifier {
+public:
+  enum class ActorKind : uint8 {
+    Other = 0,
+    StaticMesh,
+    SkeletalMesh,
+    Interp,
+    Prefab,
+    Terrain,
+    Landscape,
+    Light
+  };
+
+  LevelActorClassifier(ULevel* level);
+
+  // Returns the actor that replaces the actor's mesh at distance or nullptr
+  static UActor* GetReplacementActor(UActor* actor);
+
+  inline const std::vector<UActor*>& GetActors() const
+  {
+    return Actors;
+  }
+
+  inline size_t Size() const
+  {
+    return Actors.size();
+  }
+
+  inline UActor* GetActor(size_t idx) const
+  {
+    return Actors[idx];
+  }
+
+  inline ActorKind GetKind(size_t idx) const
+  {
+    return Kinds[idx];
+  }
+
+  inline bool IsHidden(size_t idx) const
+  {
+    return Hidden[idx];
+  }
+
+  // The actor is an MLOD that replaces other actors of the level
+  inline bool IsMLod(size_t idx) const
+  {
+    return MLods[idx];
+  }
+
+  // Index of the actor's MLOD or -1
+  inline int32 GetReplacementIndex(size_t idx) const
+  {
+    return Replacements[idx];
+  }
+
+  // Returns -1 if the actor doesn't belong to the level
+  int32 IndexOf(UActor* actor) const;
+
+  inline size_t GetMLodCount() const
+  {
+    return MLodCount;
+  }
+
+private:
+  std::vector<UActor*> Actors;
+  std::vector<ActorKind> Kinds;
+  std::vector<bool> Hidden;
+  std::vector<bool> MLods;
+  std::vector<int32> Replacements;
+  std::unordered_map<UActor*, int32> Indices;
+  size_t MLodCount = 0;
+};
@@ -0,0 +1,252 @@
+#include "LevelExportReport.h"
+
+#include <wx/stdpaths.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+  std::filesystem::path GetHistoryPath()
+  {
+    return std::filesystem::path(wxStandardPaths::Get().GetUserLocalDataDir().ToStdWstring()) / "LevelExport.stats";
+  }
+
+  std::string EscapeJson(const std::string& str)
+  {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str)
+    {
+      switch (c)
+      {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20)
+        {
+          continue;
+        }
+        result += c;
+      }
+    }
+    return result;
+  }
+}
+
+LevelExportReport::LevelExportReport(const LevelExportReport& a)
+{
+  std::scoped_lock<std::mutex> l(a.Mutex);
+  Stats = a.Stats;
+  History = a.History;
+  Keys = a.Keys;
+}
+
+LevelExportReport& LevelExportReport::operator=(const LevelExportReport& a)
+{
+  if (this != &a)
+  {
+    std::scoped_lock<std::mutex, std::mutex> l(Mutex, a.Mutex);
+    Stats = a.Stats;
+    History = a.History;
+    Keys = a.Keys;
+  }
+  return *this;
+}
+
+const char* LevelExportReport::GetPhaseName(Phase phase)
+{
+  switch (phase)
+  {
+  case Actors:
+    return "Actors";
+  case StaticMeshes:
+    return "StaticMeshes";
+  case SkeletalMeshes:
+    return "SkeletalMeshes";
+  case SpeedTrees:
+    return "SpeedTrees";
+  case Terrains:
+    return "Terrains";
+  case Waves:
+    return "Waves";
+  case Cues:
+    return "Cues";
+  case Materials:
+    return "Materials";
+  case Textures:
+    return "Textures";
+  default:
+    break;
+  }
+  return "Unknown";
+}
+
+bool LevelExportReport::AddItem(Phase phase, uint64 bytes, const void* key)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  if (key && !Keys[phase].insert(key).second)
+  {
+    return false;
+  }
+  Stats[phase].Items++;
+  Stats[phase].Bytes += bytes;
+  return true;
+}
+
+void LevelExportReport::AddBytes(Phase phase, uint64 bytes)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  Stats[phase].Bytes += bytes;
+}
+
+void LevelExportReport::AddTime(Phase phase, double seconds)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  Stats[phase].Seconds += seconds;
+}
+
+LevelExportReport::PhaseStats LevelExportReport::GetStats(Phase phase) const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  return Stats[phase];
+}
+
+void LevelExportReport::LoadHistory()
+{
+  std::ifstream s(GetHistoryPath());
+  std::string name;
+  PhaseStats item;
+  std::scoped_lock<std::mutex> l(Mutex);
+  while (s >> name >> item.Items >> item.Bytes >> item.Seconds)
+  {
+    for (int32 idx = 0; idx < PhaseCount; ++idx)
+    {
+      if (name == GetPhaseName((Phase)idx))
+      {
+        History[idx] = item;
+        break;
+      }
+    }
+  }
+}
+
+void LevelExportReport::SaveToHistory() const
+{
+  std::array<PhaseStats, PhaseCount> total;
+  {
+    std::scoped_lock<std::mutex> l(Mutex);
+    total = History;
+    for (int32 idx = 0; idx < PhaseCount; ++idx)
+    {
+      total[idx].Items += Stats[idx].Items;
+      total[idx].Bytes += Stats[idx].Bytes;
+      total[idx].Seconds += Stats[idx].Seconds;
+    }
+  }
+  std::ofstream s(GetHistoryPath(), std::ios::out | std::ios::trunc);
+  s << std::setprecision(9);
+  for (int32 idx = 0; idx < PhaseCount; ++idx)
+  {
+    s << GetPhaseName((Phase)idx) << ' ' << total[idx].Items << ' ' << total[idx].Bytes << ' ' << total[idx].Seconds << '\n';
+  }
+}
+
+double LevelExportReport::EstimateSeconds(Phase phase) const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  if (!History[phase].Items)
+  {
+    return 0.;
+  }
+  return History[phase].Seconds / History[phase].Items * Stats[phase].Items;
+}
+
+uint64 LevelExportReport::EstimateBytes(Phase phase) const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  if (Stats[phase].Bytes || !History[phase].Items)
+  {
+    return Stats[phase].Bytes;
+  }
+  return uint64((double)History[phase].Bytes / History[phase].Items * Stats[phase].Items);
+}
+
+bool LevelExportReport::SaveJson(const std::filesystem::path& path, const std::string& levelName) const
+{
+  std::ofstream s(path, std::ios::out | std::ios::trunc);
+  if (!s.is_open())
+  {
+    return false;
+  }
+  uint64 totalItems = 0;
+  uint64 totalBytes = 0;
+  double totalSeconds = 0.;
+  s << std::fixed << std::setprecision(3);
+  s << "{\n";
+  s << "  \"level\": \"" << EscapeJson(levelName) << "\",\n";
+  s << "  \"phases\": [\n";
+  for (int32 idx = 0; idx < PhaseCount; ++idx)
+  {
+    const Phase phase = (Phase)idx;
+    const PhaseStats stats = GetStats(phase);
+    const uint64 bytes = EstimateBytes(phase);
+    const double seconds = EstimateSeconds(phase);
+    uint64 historyItems = 0;
+    {
+      std::scoped_lock<std::mutex> l(Mutex);
+      historyItems = History[idx].Items;
+    }
+    totalItems += stats.Items;
+    totalBytes += bytes;
+    totalSeconds += seconds;
+    s << "    {\n";
+    s << "      \"name\": \"" << GetPhaseName(phase) << "\",\n";
+    s << "      \"items\": " << stats.Items << ",\n";
+    s << "      \"estimatedBytes\": " << bytes << ",\n";
+    s << "      \"estimatedSeconds\": " << seconds << ",\n";
+    s << "      \"historyItems\": " << historyItems << "\n";
+    s << "    }" << (idx + 1 < PhaseCount ? "," : "") << '\n';
+  }
+  s << "  ],\n";
+  s << "  \"totalItems\": " << totalItems << ",\n";
+  s << "  \"totalEstimatedBytes\": " << totalBytes << ",\n";
+  s << "  \"totalEstimatedSeconds\": " << totalSeconds << '\n';
+  s << "}\n";
+  return s.good();
+}
+
+std::string LevelExportReport::GetSummary() const
+{
+  std::stringstream s;
+  s << std::fixed << std::setprecision(1);
+  uint64 totalBytes = 0;
+  double totalSeconds = 0.;
+  for (int32 idx = 0; idx < PhaseCount; ++idx)
+  {
+    const Phase phase = (Phase)idx;
+    const PhaseStats stats = GetStats(phase);
+    if (!stats.Items)
+    {
+      continue;
+    }
+    const uint64 bytes = EstimateBytes(phase);
+    const double seconds = EstimateSeconds(phase);
+    totalBytes += bytes;
+    totalSeconds += seconds;
+    s << GetPhaseName(phase) << ": " << stats.Items << " items, ~" << bytes / (1024. * 1024.) << " MB, ~" << seconds << " s\n";
+  }
+  s << "\nTotal: ~" << totalBytes / (1024. * 1024.) << " MB, ~" << totalSeconds / 60. << " min";
+  return s.str();
+}
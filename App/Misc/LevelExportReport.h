@@ -0,0 +1,90 @@
+#pragma once
+#include <Tera/Core.h>
+#include "ATrace.h"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+// Per-phase statistics of a level export. Real exports append their timings and output sizes to
+// a history file. Dry runs count items and use the history to estimate time and size of each phase.
+class LevelExportReport {
+public:
+  enum Phase : int32 {
+    Actors = 0,
+    StaticMeshes,
+    SkeletalMeshes,
+    SpeedTrees,
+    Terrains,
+    Waves,
+    Cues,
+    Materials,
+    Textures,
+    PhaseCount
+  };
+
+  struct PhaseStats {
+    uint64 Items = 0;
+    uint64 Bytes = 0;
+    double Seconds = 0.;
+  };
+
+  // Measures the time of a phase or an item until destroyed. The time is traced as a span named after the phase.
+  class ScopedTimer {
+  public:
+    ScopedTimer(LevelExportReport& report, Phase phase)
+      : Report(report)
+      , TimerPhase(phase)
+      , Start(std::chrono::steady_clock::now())
+      , Span(GetPhaseName(phase))
+    {}
+
+    ~ScopedTimer()
+    {
+      Report.AddTime(TimerPhase, std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count());
+    }
+
+  private:
+    LevelExportReport& Report;
+    Phase TimerPhase = Actors;
+    std::chrono::steady_clock::time_point Start;
+    ATraceSpan Span;
+  };
+
+  LevelExportReport() = default;
+  LevelExportReport(const LevelExportReport& a);
+  LevelExportReport& operator=(const LevelExportReport& a);
+
+  static const char* GetPhaseName(Phase phase);
+
+  // Add an item to the phase. If a key is provided, the item is counted once per key.
+  // Returns false if the key was already added. Thread safe.
+  bool AddItem(Phase phase, uint64 bytes = 0, const void* key = nullptr);
+  // Add measured bytes to the phase without counting an item
+  void AddBytes(Phase phase, uint64 bytes);
+  void AddTime(Phase phase, double seconds);
+
+  PhaseStats GetStats(Phase phase) const;
+
+  // Load accumulated statistics of previous real exports
+  void LoadHistory();
+  // Add this export to the history
+  void SaveToHistory() const;
+
+  // Estimated phase duration based on the history
+  double EstimateSeconds(Phase phase) const;
+  // Measured bytes or an estimation based on the history if the phase can't be measured in a dry run
+  uint64 EstimateBytes(Phase phase) const;
+
+  bool SaveJson(const std::filesystem::path& path, const std::string& levelName) const;
+  std::string GetSummary() const;
+
+private:
+  std::array<PhaseStats, PhaseCount> Stats;
+  std::array<PhaseStats, PhaseCount> History;
+  std::array<std::unordered_set<const void*>, PhaseCount> Keys;
+  mutable std::mutex Mutex;
+};
@@ -0,0 +1,145 @@
+#include "OSGMeshBuffers.h"
+
+#include <immintrin.h>
+
+namespace
+{
+  // Negate Y of 4 packed XYZ vectors(12 floats)
+  inline void FlipY4(float* xyz)
+  {
+    const __m128 flip0 = _mm_castsi128_ps(_mm_setr_epi32(0, (int)0x80000000, 0, 0));
+    const __m128 flip1 = _mm_castsi128_ps(_mm_setr_epi32((int)0x80000000, 0, 0, (int)0x80000000));
+    const __m128 flip2 = _mm_castsi128_ps(_mm_setr_epi32(0, 0, (int)0x80000000, 0));
+    _mm_storeu_ps(xyz + 0, _mm_xor_ps(_mm_loadu_ps(xyz + 0), flip0));
+    _mm_storeu_ps(xyz + 4, _mm_xor_ps(_mm_loadu_ps(xyz + 4), flip1));
+    _mm_storeu_ps(xyz + 8, _mm_xor_ps(_mm_loadu_ps(xyz + 8), flip2));
+  }
+
+  template <typename TVertex>
+  inline void CopyVertex(const TVertex& vertex, float* position, float* normal, osg::Vec2& uv)
+  {
+    position[0] = vertex.Position.X;
+    position[1] = vertex.Position.Y;
+    position[2] = vertex.Position.Z;
+    const FVector tangentZ = vertex.TangentZ;
+    normal[0] = tangentZ.X;
+    normal[1] = tangentZ.Y;
+    normal[2] = tangentZ.Z;
+    uv.set(vertex.UVs[0].X, vertex.UVs[0].Y);
+  }
+}
+
+OSGMeshBuffers::OSGMeshBuffers(const FStaticMeshRenderData* model)
+{
+  if (!model)
+  {
+    return;
+  }
+  ConvertVertices(model->GetVertices());
+  StaticIndices = &model->IndexBuffer;
+}
+
+OSGMeshBuffers::OSGMeshBuffers(const FStaticLODModel* model)
+{
+  if (!model)
+  {
+    return;
+  }
+  ConvertVertices(model->GetVertices());
+  SkelIndices = model->GetIndexContainer();
+}
+
+template <typename TVertex>
+void OSGMeshBuffers::ConvertVertices(const std::vector<TVertex>& vertices)
+{
+  const size_t count = vertices.size();
+  Vertices = new osg::Vec3Array(count);
+  Normals = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX, count);
+  UVs = new osg::Vec2Array(osg::Array::BIND_PER_VERTEX, count);
+  if (!count)
+  {
+    return;
+  }
+
+  float* positions = (float*)&Vertices->front();
+  float* normals = (float*)&Normals->front();
+  osg::Vec2* uvs = &UVs->front();
+
+  // Copy 4 vertices and flip them while they are still in the cache
+  const size_t blockEnd = count & ~size_t(3);
+  size_t idx = 0;
+  for (; idx < blockEnd; idx += 4)
+  {
+    for (size_t sub = idx; sub < idx + 4; ++sub)
+    {
+      CopyVertex(vertices[sub], positions + sub * 3, normals + sub * 3, uvs[sub]);
+    }
+    FlipY4(positions + idx * 3);
+    FlipY4(normals + idx * 3);
+  }
+  for (; idx < count; ++idx)
+  {
+    CopyVertex(vertices[idx], positions + idx * 3, normals + idx * 3, uvs[idx]);
+    positions[idx * 3 + 1] = -positions[idx * 3 + 1];
+    normals[idx * 3 + 1] = -normals[idx * 3 + 1];
+  }
+
+  VertexBuffer = new osg::VertexBufferObject;
+  Vertices->setVertexBufferObject(VertexBuffer);
+  Normals->setVertexBufferObject(VertexBuffer);
+  UVs->setVertexBufferObject(VertexBuffer);
+  IndexBuffer = new osg::ElementBufferObject;
+}
+
+template <typename TIndex>
+void OSGMeshBuffers::ReadIndices(uint32 firstIndex, uint32 count, TIndex* out) const
+{
+  if (StaticIndices)
+  {
+    for (uint32 idx = 0; idx < count; ++idx)
+    {
+      out[idx] = (TIndex)StaticIndices->GetIndex(firstIndex + idx);
+    }
+  }
+  else if (SkelIndices)
+  {
+    for (uint32 idx = 0; idx < count; ++idx)
+    {
+      out[idx] = (TIndex)SkelIndices->GetIndex(firstIndex + idx);
+    }
+  }
+}
+
+osg::ref_ptr<osg::Geometry> OSGMeshBuffers::CreateSection(uint32 firstIndex, uint32 numTriangles) const
+{
+  if (!IsValid() || !numTriangles)
+  {
+    return nullptr;
+  }
+
+  const uint32 count = numTriangles * 3;
+  osg::ref_ptr<osg::DrawElements> indices;
+  if (Vertices->size() <= 0x10000)
+  {
+    // Most meshes fit 16-bit indices, which halves the index buffer
+    osg::ref_ptr<osg::DrawElementsUShort> shortIndices = new osg::DrawElementsUShort(GL_TRIANGLES, count);
+    ReadIndices(firstIndex, count, &shortIndices->front());
+    indices = shortIndices;
+  }
+  else
+  {
+    osg::ref_ptr<osg::DrawElementsUInt> intIndices = new osg::DrawElementsUInt(GL_TRIANGLES, count);
+    ReadIndices(firstIndex, count, &intIndices->front());
+    indices = intIndices;
+  }
+  indices->setElementBufferObject(IndexBuffer);
+
+  osg::ref_ptr<osg::Geometry> geo = new osg::Geometry;
+  geo->addPrimitiveSet(indices);
+  geo->setVertexArray(Vertices);
+  geo->setNormalArray(Normals);
+  geo->setTexCoordArray(0, UVs);
+  geo->setUseDisplayList(false);
+  geo->setUseVertexBufferObjects(true);
+  return geo;
+}
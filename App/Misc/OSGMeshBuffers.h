@@ -0,0 +1,44 @@
+#pragma once
+#include <Tera/Core.h>
+#include <Tera/UStaticMesh.h>
+#include <Tera/USkeletalMesh.h>
+
+#include <osg/Array>
+#include <osg/BufferObject>
+#include <osg/Geometry>
+
+// OSG vertex and index buffers of a mesh LOD shared by all of its sections.
+// Vertices are converted in a single pass into exactly sized arrays with the Y axis flipped.
+// Positions, normals and UVs stay separate arrays: osg::Array has no stride, so they can't be
+// interleaved. The copy is a plain per-vertex loop over the core vertex types, only the Y flip is
+// vectorized. The arrays share one VBO and section indices share one EBO, so a LOD is uploaded as
+// two buffers.
+class OSGMeshBuffers {
+public:
+  OSGMeshBuffers(const FStaticMeshRenderData* model);
+  OSGMeshBuffers(const FStaticLODModel* model);
+
+  inline bool IsValid() const
+  {
+    return Vertices && Vertices->size();
+  }
+
+  // Create a geometry that draws numTriangles starting at firstIndex with the shared arrays
+  osg::ref_ptr<osg::Geometry> CreateSection(uint32 firstIndex, uint32 numTriangles) const;
+
+private:
+  template <typename TVertex>
+  void ConvertVertices(const std::vector<TVertex>& vertices);
+
+  template <typename TIndex>
+  void ReadIndices(uint32 firstIndex, uint32 count, TIndex* out) const;
+
+private:
+  osg::ref_ptr<osg::Vec3Array> Vertices;
+  osg::ref_ptr<osg::Vec3Array> Normals;
+  osg::ref_ptr<osg::Vec2Array> UVs;
+  osg::ref_ptr<osg::VertexBufferObject> VertexBuffer;
+  osg::ref_ptr<osg::ElementBufferObject> IndexBuffer;
+  const FRawIndexBuffer* StaticIndices = nullptr;
+  const FMultiSizeIndexContainer* SkelIndices = nullptr;
+};
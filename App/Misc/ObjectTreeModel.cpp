@@ -5,67 +5,9 @@
 #include <Tera/Core.h>
 #include <Tera/FObjectResource.h>
 
-#include "../resource.h"
+#include <algorithm>
 
-inline int GetSuitableExportsCount(FObjectExport* exp, const std::vector<FString>& filter, bool recursivly)
-{
-  int result = 0;
-  if (std::find_if(filter.begin(), filter.end(), [&](const FString& cls) { return cls.ToUpper() == exp->GetClassNameString().ToUpper(); }) != filter.end())
-  {
-    result++;
-  }
-  else
-  {
-    bool contains = false;
-    for (FObjectExport* child : exp->Inner)
-    {
-      int tmp = GetSuitableExportsCount(child, filter, true);
-      if (recursivly)
-      {
-        result += tmp;
-      }
-      if (tmp)
-      {
-        contains = true;
-      }
-    }
-    if (contains)
-    {
-      result++;
-    }
-  }
-  return result;
-}
-
-inline int GetSuitableExportsCount(FObjectExport* exp, const FString& filter, bool recursivly)
-{
-  int result = 0;
-  if (exp->GetObjectNameString().ToUpper().Contains(filter.ToUpper()) && (!exp->Outer || exp->Outer->GetClassName() == NAME_Package || exp->Outer->GetClassName() == "Level"))
-  {
-    result++;
-  }
-  else
-  {
-    bool contains = false;
-    for (FObjectExport* child : exp->Inner)
-    {
-      int tmp = GetSuitableExportsCount(child, filter, true);
-      if (recursivly)
-      {
-        result += tmp;
-      }
-      if (tmp)
-      {
-        contains = true;
-      }
-    }
-    if (contains)
-    {
-      result++;
-    }
-  }
-  return result;
-}
+#include "../resource.h"
 
 enum ClassIco : int {
   IcoPackage = 0,
@@ -189,173 +131,237 @@ ClassIco ObjectClassToClassIco(const wxString& className)
   return IcoGeneric;
 }
 
-ObjectTreeNode::ObjectTreeNode(const std::string& name, std::vector<FObjectExport*> exps, const std::vector<FString>& allowedClasses)
+ObjectTreeFilter::ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports)
 {
-  Name = A2W(name);
-  for (FObjectExport* exp : exps)
-  {
-    if (allowedClasses.empty() || GetSuitableExportsCount(exp, allowedClasses, true))
-    {
-      ObjectTreeNode* child = new ObjectTreeNode(this, exp, allowedClasses);
-      Children.Add(child);
-    }
-  }
+  AllVisible = true;
+  Build(rootExports, [](FObjectExport*) { return true; }, nullptr);
 }
 
-ObjectTreeNode::ObjectTreeNode(const std::string& name, std::vector<FObjectExport*> exps, const FString& search)
+ObjectTreeFilter::ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports, const std::vector<FString>& allowedClasses)
 {
-  Name = A2W(name);
-  for (FObjectExport* exp : exps)
+  if (allowedClasses.empty())
   {
-    if (search.Empty() || GetSuitableExportsCount(exp, search, true))
-    {
-      ObjectTreeNode* child = new ObjectTreeNode(this, exp, search);
-      Children.Add(child);
-    }
+    AllVisible = true;
+    Build(rootExports, [](FObjectExport*) { return true; }, nullptr);
+    return;
+  }
+  std::vector<FString> upperClasses;
+  for (const FString& cls : allowedClasses)
+  {
+    upperClasses.emplace_back(cls.ToUpper());
   }
+  Build(rootExports, [&](FObjectExport* exp) {
+    const FString upperClass = exp->GetClassNameString().ToUpper();
+    return std::find(upperClasses.begin(), upperClasses.end(), upperClass) != upperClasses.end();
+  }, nullptr);
 }
 
-ObjectTreeNode::ObjectTreeNode(std::vector<FObjectImport*> imps)
+ObjectTreeFilter::ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports, const FString& search, const std::atomic_bool* cancel)
 {
-  Name = wxT("Imports");
-  for (FObjectImport* imp : imps)
+  if (search.Empty())
   {
-    ObjectTreeNode* child = new ObjectTreeNode(this, imp);
-    Children.Add(child);
+    AllVisible = true;
+    Build(rootExports, [](FObjectExport*) { return true; }, cancel);
+    return;
   }
+  const FString upperSearch = search.ToUpper();
+  Build(rootExports, [&](FObjectExport* exp) {
+    if (exp->Outer && exp->Outer->GetClassName() != NAME_Package && exp->Outer->GetClassName() != "Level")
+    {
+      return false;
+    }
+    return exp->GetObjectNameString().ToUpper().Contains(upperSearch);
+  }, cancel);
 }
 
-ObjectTreeNode::ObjectTreeNode(ObjectTreeNode* parent, FObjectExport* exp, const std::vector<FString>& allowedClasses)
-  : Export(exp)
-  , Parent(parent)
+ObjectTreeFilter::ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports, const std::vector<FObjectExport*>& matches, const std::atomic_bool* cancel)
 {
-  Resource = (FObjectResource*)exp;
-  for (FObjectExport* expChild : exp->Inner)
+  std::vector<bool> matched;
+  for (FObjectExport* exp : matches)
   {
-    if (allowedClasses.empty() || GetSuitableExportsCount(expChild, allowedClasses, true))
+    if (exp->ObjectIndex > 0)
     {
-      ObjectTreeNode* child = new ObjectTreeNode(this, expChild, allowedClasses);
-      Children.Add(child);
+      if (size_t(exp->ObjectIndex) > matched.size())
+      {
+        matched.resize(exp->ObjectIndex, false);
+      }
+      matched[exp->ObjectIndex - 1] = true;
     }
   }
+  Build(rootExports, [&](FObjectExport* exp) {
+    return exp->ObjectIndex > 0 && size_t(exp->ObjectIndex) <= matched.size() && matched[exp->ObjectIndex - 1];
+  }, cancel);
 }
 
-ObjectTreeNode::ObjectTreeNode(ObjectTreeNode* parent, FObjectExport* exp, const FString& search)
-  : Export(exp)
-  , Parent(parent)
+void ObjectTreeFilter::Build(const std::vector<FObjectExport*>& rootExports, const std::function<bool(FObjectExport*)>& matches, const std::atomic_bool* cancel)
 {
-  Resource = (FObjectResource*)exp;
-  for (FObjectExport* expChild : exp->Inner)
-  {
-    if (search.Empty() || GetSuitableExportsCount(expChild, search, true))
+  // Visible flags depend on inners, so flags are set after the subtree is visited
+  std::function<uint8(FObjectExport*)> visit;
+  visit = [&](FObjectExport* exp) -> uint8 {
+    if (Cancelled || (cancel && (Exports.size() & 0x3FF) == 0 && cancel->load(std::memory_order_relaxed)))
     {
-      ObjectTreeNode* child = new ObjectTreeNode(this, expChild, search);
-      Children.Add(child);
+      Cancelled = true;
+      return 0;
     }
+    Exports.push_back(exp);
+    uint8 flags = 0;
+    if (matches(exp))
+    {
+      flags |= Match | Visible;
+      if (exp->GetClassName() != NAME_Package)
+      {
+        MatchCount++;
+      }
+    }
+    for (FObjectExport* inner : exp->Inner)
+    {
+      if (visit(inner) & Visible)
+      {
+        flags |= Visible;
+      }
+    }
+    if (exp->ObjectIndex > 0)
+    {
+      const size_t idx = size_t(exp->ObjectIndex) - 1;
+      if (idx >= ExportFlags.size())
+      {
+        ExportFlags.resize(idx + 1, 0);
+        ExportsByIndex.resize(idx + 1, nullptr);
+      }
+      ExportFlags[idx] = flags;
+      ExportsByIndex[idx] = exp;
+    }
+    return flags;
+  };
+  for (FObjectExport* exp : rootExports)
+  {
+    visit(exp);
   }
 }
 
-ObjectTreeNode::ObjectTreeNode(ObjectTreeNode* parent, FObjectImport* imp)
-  : Import(imp)
-  , Parent(parent)
+uint8 ObjectTreeFilter::GetFlags(const FObjectExport* exp) const
 {
-  Resource = (FObjectResource*)imp;
-  for (FObjectImport* impChild : imp->Inner)
+  const size_t idx = size_t(exp->ObjectIndex) - 1;
+  if (exp->ObjectIndex <= 0 || idx >= ExportFlags.size() || ExportsByIndex[idx] != exp)
   {
-    ObjectTreeNode* child = new ObjectTreeNode(this, impChild);
-    Children.Add(child);
+    // Added after the filter was built
+    return Match | Visible;
   }
+  return ExportFlags[idx];
 }
 
-wxString ObjectTreeNode::GetObjectName() const
+bool ObjectTreeFilter::IsVisible(const FObjectExport* exp) const
 {
-  if (Resource)
+  return AllVisible || (GetFlags(exp) & Visible);
+}
+
+bool ObjectTreeFilter::IsMatch(const FObjectExport* exp) const
+{
+  return AllVisible || (GetFlags(exp) & Match);
+}
+
+FObjectExport* ObjectTreeFilter::GetExport(PACKAGE_INDEX index) const
+{
+  if (index <= 0 || size_t(index) > ExportsByIndex.size())
   {
-    if (Resource->ObjectIndex > 0)
-    {
-      // TODO: Need to notify PackageWindow about new changes
-      bool isDirty = (((FObjectExport*)Resource)->ObjectFlags & RF_Marked);
-      return isDirty ? L"*" + Resource->GetObjectNameString().WString() : Resource->GetObjectNameString().WString();
-    }
-    return Resource->GetObjectNameString().WString();
+    return nullptr;
   }
-  return Name;
+  return ExportsByIndex[size_t(index) - 1];
 }
 
-wxString ObjectTreeNode::GetClassName() const
+ObjectTreeNode::ObjectTreeNode(const std::string& name, const std::vector<FObjectExport*>& exps, const ObjectTreeFilter* filter)
+  : Filter(filter)
+  , RootExports(exps)
 {
-  return Resource ? Resource->GetClassNameString().WString() : Name;
+  Name = A2W(name);
 }
 
-PACKAGE_INDEX ObjectTreeNode::GetObjectIndex() const
+ObjectTreeNode::ObjectTreeNode(const std::vector<FObjectImport*>& imps)
+  : RootImports(imps)
 {
-  return Resource ? Resource->ObjectIndex : CustomObjectIndex;
+  Name = wxT("Imports");
 }
 
-void ObjectTreeNode::Append(ObjectTreeNode* child)
+ObjectTreeNode::ObjectTreeNode(ObjectTreeNode* parent, FObjectExport* exp)
+  : Export(exp)
+  , Filter(parent->Filter)
+  , Parent(parent)
 {
-  Children.Add(child);
+  Resource = (FObjectResource*)exp;
+}
+
+ObjectTreeNode::ObjectTreeNode(ObjectTreeNode* parent, FObjectImport* imp)
+  : Import(imp)
+  , Parent(parent)
+{
+  Resource = (FObjectResource*)imp;
 }
 
-ObjectTreeNode* ObjectTreeNode::FindItemByObjectIndex(PACKAGE_INDEX index)
+void ObjectTreeNode::LoadChildren()
 {
-  if (index > 0)
+  ChildrenLoaded = true;
+  const std::vector<FObjectExport*>& exps = Export ? Export->Inner : RootExports;
+  for (FObjectExport* exp : exps)
   {
-    if (Export && Export->ObjectIndex == index)
+    if (!Filter || Filter->IsVisible(exp))
     {
-      return this;
+      Children.Add(new ObjectTreeNode(this, exp));
     }
   }
-  else if (index < 0)
+  const std::vector<FObjectImport*>& imps = Import ? Import->Inner : RootImports;
+  for (FObjectImport* imp : imps)
   {
-    if (Import && Import->ObjectIndex == index)
-    {
-      return this;
-    }
+    Children.Add(new ObjectTreeNode(this, imp));
   }
-  for (ObjectTreeNode* child : Children)
+}
+
+ObjectTreeNodePtrArray& ObjectTreeNode::GetChildren()
+{
+  if (!ChildrenLoaded)
   {
-    if (ObjectTreeNode* result = child->FindItemByObjectIndex(index))
-    {
-      return result;
-    }
+    LoadChildren();
   }
-  return nullptr;
+  return Children;
 }
 
-ObjectTreeNode* ObjectTreeNode::FindItemByName(const FString& name)
+bool ObjectTreeNode::HasChildren() const
 {
-  const FString upper = name.ToUpper();
-  if (Export)
+  if (ChildrenLoaded)
+  {
+    return Children.GetCount();
+  }
+  const std::vector<FObjectExport*>& exps = Export ? Export->Inner : RootExports;
+  for (FObjectExport* exp : exps)
   {
-    if (Export->GetClassName() != NAME_Package && Export->GetObjectNameString().ToUpper() == upper)
+    if (!Filter || Filter->IsVisible(exp))
     {
-      return this;
+      return true;
     }
   }
-  for (ObjectTreeNode* child : Children)
+  return Import ? Import->Inner.size() : RootImports.size();
+}
+
+ObjectTreeNode* ObjectTreeNode::FindChild(FObjectResource* resource)
+{
+  for (ObjectTreeNode* child : GetChildren())
   {
-    if (ObjectTreeNode* result = child->FindItemByName(name))
+    if (child->Resource == resource)
     {
-      return result;
+      return child;
     }
   }
   return nullptr;
 }
 
-ObjectTreeNode* ObjectTreeNode::FindFirstItemMatch(const FString& name)
+ObjectTreeNode* ObjectTreeNode::FindLoadedItem(PACKAGE_INDEX index)
 {
-  const FString upper = name.ToUpper();
-  if (Export)
+  if (index > 0 ? (Export && Export->ObjectIndex == index) : (Import && Import->ObjectIndex == index))
   {
-    if (Export->GetClassName() != NAME_Package && Export->GetObjectNameString().ToUpper().Contains(upper))
-    {
-      return this;
-    }
+    return this;
   }
   for (ObjectTreeNode* child : Children)
   {
-    if (ObjectTreeNode* result = child->FindFirstItemMatch(name))
+    if (ObjectTreeNode* result = child->FindLoadedItem(index))
     {
       return result;
     }
@@ -363,24 +369,85 @@ ObjectTreeNode* ObjectTreeNode::FindFirstItemMatch(const FString& name)
   return nullptr;
 }
 
+wxString ObjectTreeNode::GetObjectName() const
+{
+  if (Resource)
+  {
+    if (Resource->ObjectIndex > 0)
+    {
+      // TODO: Need to notify PackageWindow about new changes
+      bool isDirty = (((FObjectExport*)Resource)->ObjectFlags & RF_Marked);
+      return isDirty ? L"*" + Resource->GetObjectNameString().WString() : Resource->GetObjectNameString().WString();
+    }
+    return Resource->GetObjectNameString().WString();
+  }
+  return Name;
+}
+
+wxString ObjectTreeNode::GetClassName() const
+{
+  return Resource ? Resource->GetClassNameString().WString() : Name;
+}
+
+PACKAGE_INDEX ObjectTreeNode::GetObjectIndex() const
+{
+  return Resource ? Resource->ObjectIndex : CustomObjectIndex;
+}
+
+void ObjectTreeNode::Append(ObjectTreeNode* child)
+{
+  Children.Add(child);
+}
+
 ObjectTreeModel::ObjectTreeModel(const std::string& packageName, std::vector<FObjectExport*>& rootExports, std::vector<FObjectImport*>& rootImports, const std::vector<FString>& allowedClasses)
 {
   Filter = allowedClasses;
-  RootExport = new ObjectTreeNode(packageName, rootExports, allowedClasses);
+  TreeFilter = std::make_unique<ObjectTreeFilter>(rootExports, allowedClasses);
+  RootExport = new ObjectTreeNode(packageName, rootExports, TreeFilter.get());
   if (rootImports.size())
   {
     RootImport = new ObjectTreeNode(rootImports);
+    BuildImportIndex(rootImports);
   }
   BuildIcons();
 }
 
 ObjectTreeModel::ObjectTreeModel(const std::string& packageName, std::vector<FObjectExport*>& rootExports, std::vector<FObjectImport*>& rootImports, const FString& search)
+  : ObjectTreeModel(packageName, rootExports, rootImports, std::make_unique<ObjectTreeFilter>(rootExports, search), search)
+{}
+
+ObjectTreeModel::ObjectTreeModel(const std::string& packageName, std::vector<FObjectExport*>& rootExports, std::vector<FObjectImport*>& rootImports, std::unique_ptr<ObjectTreeFilter> filter, const FString& search)
 {
   SearchName = search;
-  RootExport = new ObjectTreeNode(packageName, rootExports, search);
+  TreeFilter = std::move(filter);
+  RootExport = new ObjectTreeNode(packageName, rootExports, TreeFilter.get());
   BuildIcons();
 }
 
+void ObjectTreeModel::BuildImportIndex(std::vector<FObjectImport*>& rootImports)
+{
+  std::function<void(FObjectImport*)> visit;
+  visit = [&](FObjectImport* imp) {
+    if (imp->ObjectIndex < 0)
+    {
+      const size_t idx = size_t(-imp->ObjectIndex) - 1;
+      if (idx >= ImportsByIndex.size())
+      {
+        ImportsByIndex.resize(idx + 1, nullptr);
+      }
+      ImportsByIndex[idx] = imp;
+    }
+    for (FObjectImport* inner : imp->Inner)
+    {
+      visit(inner);
+    }
+  };
+  for (FObjectImport* imp : rootImports)
+  {
+    visit(imp);
+  }
+}
+
 void ObjectTreeModel::BuildIcons()
 {
   IconList = new wxImageList(16, 16, true, 2);
@@ -463,7 +530,15 @@ void ObjectTreeModel::GetValue(wxVariant& variant, const wxDataViewItem& item, u
 bool ObjectTreeModel::IsEnabled(const wxDataViewItem& item, unsigned int col) const
 {
   ObjectTreeNode* node = (ObjectTreeNode*)item.GetID();
-  return Filter.empty() || std::find_if(Filter.begin(), Filter.end(), [&](const FString& cls) { return cls.ToUpper() == node->GetClassName().Upper().ToStdWstring(); }) != Filter.end();
+  if (Filter.empty())
+  {
+    return true;
+  }
+  if (FObjectExport* exp = node->GetExport())
+  {
+    return TreeFilter->IsMatch(exp);
+  }
+  return std::find_if(Filter.begin(), Filter.end(), [&](const FString& cls) { return cls.ToUpper() == node->GetClassName().Upper().ToStdWstring(); }) != Filter.end();
 }
 
 wxDataViewItem ObjectTreeModel::GetParent(const wxDataViewItem& item) const
@@ -484,7 +559,7 @@ bool ObjectTreeModel::IsContainer(const wxDataViewItem& item) const
   {
     return true;
   }
-  return node->GetChildren().GetCount();
+  return node->HasChildren();
 }
 
 unsigned int ObjectTreeModel::GetChildren(const wxDataViewItem& parent, wxDataViewItemArray& array) const
@@ -499,28 +574,94 @@ unsigned int ObjectTreeModel::GetChildren(const wxDataViewItem& parent, wxDataVi
     }
     return array.size();
   }
-  if (!node->GetChildren().GetCount())
-  {
-    return 0;
-  }
-  unsigned int count = node->GetChildren().GetCount();
+  ObjectTreeNodePtrArray& children = node->GetChildren();
+  unsigned int count = children.GetCount();
   for (unsigned int pos = 0; pos < count; pos++)
   {
-    ObjectTreeNode* child = node->GetChildren().Item(pos);
-    array.Add(wxDataViewItem((void*)child));
+    array.Add(wxDataViewItem((void*)children.Item(pos)));
   }
   return count;
 }
 
+ObjectTreeNode* ObjectTreeModel::FindLoadedItem(PACKAGE_INDEX index)
+{
+  if (index > 0)
+  {
+    return RootExport->FindLoadedItem(index);
+  }
+  else if (index < 0 && RootImport)
+  {
+    return RootImport->FindLoadedItem(index);
+  }
+  return nullptr;
+}
+
 ObjectTreeNode* ObjectTreeModel::FindItemByObjectIndex(PACKAGE_INDEX index)
 {
+  if (ObjectTreeNode* loaded = FindLoadedItem(index))
+  {
+    return loaded;
+  }
+
+  // Create nodes from the root down to the object
+  std::vector<FObjectResource*> path;
+  ObjectTreeNode* node = nullptr;
   if (index > 0)
   {
-    return RootExport->FindItemByObjectIndex(index);
+    node = RootExport;
+    for (FObjectExport* exp = TreeFilter->GetExport(index); exp; exp = TreeFilter->GetExport(exp->OuterIndex))
+    {
+      path.push_back((FObjectResource*)exp);
+    }
   }
   else if (index < 0 && RootImport)
   {
-    return RootImport->FindItemByObjectIndex(index);
+    node = RootImport;
+    PACKAGE_INDEX impIndex = index;
+    while (impIndex < 0 && size_t(-impIndex) <= ImportsByIndex.size())
+    {
+      FObjectImport* imp = ImportsByIndex[size_t(-impIndex) - 1];
+      if (!imp)
+      {
+        break;
+      }
+      path.push_back((FObjectResource*)imp);
+      impIndex = imp->OuterIndex;
+    }
+  }
+  if (path.empty())
+  {
+    return nullptr;
+  }
+  for (auto it = path.rbegin(); node && it != path.rend(); ++it)
+  {
+    node = node->FindChild(*it);
+  }
+  return node;
+}
+
+ObjectTreeNode* ObjectTreeModel::FindItemByName(const FString& name)
+{
+  const FString upper = name.ToUpper();
+  for (FObjectExport* exp : TreeFilter->GetExports())
+  {
+    if (TreeFilter->IsVisible(exp) && exp->GetClassName() != NAME_Package && exp->GetObjectNameString().ToUpper() == upper)
+    {
+      return FindItemByObjectIndex(exp->ObjectIndex);
+    }
+  }
+  return nullptr;
+}
+
+ObjectTreeNode* ObjectTreeModel::FindFirstItemMatch(const FString& name)
+{
+  const FString upper = name.ToUpper();
+  for (FObjectExport* exp : TreeFilter->GetExports())
+  {
+    if (TreeFilter->IsVisible(exp) && exp->GetClassName() != NAME_Package && exp->GetObjectNameString().ToUpper().Contains(upper))
+    {
+      return FindItemByObjectIndex(exp->ObjectIndex);
+    }
   }
   return nullptr;
 }
@@ -534,14 +675,19 @@ ObjectTreeDataViewCtrl::ObjectTreeDataViewCtrl(wxWindow* parent, wxWindowID id,
 void ObjectTreeDataViewCtrl::AddExportObject(FObjectExport* exp, bool select)
 {
   ObjectTreeModel* model = (ObjectTreeModel*)GetModel();
-  if (!exp || !model || model->FindItemByObjectIndex(exp->ObjectIndex))
+  if (!exp || !model || model->FindLoadedItem(exp->ObjectIndex))
   {
     return;
   }
   if (ObjectTreeNode* parentNode = exp->GetOuter() ? model->FindItemByObjectIndex(exp->OuterIndex) : model->GetRootExport())
   {
-    ObjectTreeNode* itemNode = new ObjectTreeNode(parentNode, exp, FString());
-    parentNode->GetChildren().Add(itemNode);
+    // Unloaded parents pick up the export from their inners
+    ObjectTreeNode* itemNode = parentNode->AreChildrenLoaded() ? nullptr : parentNode->FindChild((FObjectResource*)exp);
+    if (!itemNode)
+    {
+      itemNode = new ObjectTreeNode(parentNode, exp);
+      parentNode->Append(itemNode);
+    }
     wxDataViewItem parent = wxDataViewItem((void*)parentNode);
     wxDataViewItem item = wxDataViewItem((void*)itemNode);
     model->ItemAdded(parent, item);
@@ -556,14 +702,18 @@ void ObjectTreeDataViewCtrl::AddExportObject(FObjectExport* exp, bool select)
 void ObjectTreeDataViewCtrl::AddImportObject(FObjectImport* imp)
 {
   ObjectTreeModel* model = (ObjectTreeModel*)GetModel();
-  if (!imp || !model || model->FindItemByObjectIndex(imp->ObjectIndex))
+  if (!imp || !model || model->FindLoadedItem(imp->ObjectIndex))
   {
     return;
   }
   if (ObjectTreeNode* parentNode = imp->GetOuter() ? model->FindItemByObjectIndex(imp->OuterIndex) : model->GetRootImport())
   {
-    ObjectTreeNode* itemNode = new ObjectTreeNode(parentNode, imp);
-    parentNode->GetChildren().Add(itemNode);
+    ObjectTreeNode* itemNode = parentNode->AreChildrenLoaded() ? nullptr : parentNode->FindChild((FObjectResource*)imp);
+    if (!itemNode)
+    {
+      itemNode = new ObjectTreeNode(parentNode, imp);
+      parentNode->Append(itemNode);
+    }
     wxDataViewItem parent = wxDataViewItem((void*)parentNode);
     wxDataViewItem item = wxDataViewItem((void*)itemNode);
     model->ItemAdded(parent, item);
@@ -577,11 +727,11 @@ void ObjectTreeDataViewCtrl::RemoveExp(PACKAGE_INDEX idx)
   {
     return;
   }
-  if (ObjectTreeNode* node = model->FindItemByObjectIndex(idx))
+  if (ObjectTreeNode* node = model->FindLoadedItem(idx))
   {
     if (ObjectTreeNode* parent = node->GetParent())
     {
-      parent->GetChildren().Remove(node);
+      parent->GetLoadedChildren().Remove(node);
     }
     model->ItemDeleted(wxDataViewItem(node->GetParent()), wxDataViewItem(node));
   }
@@ -595,12 +745,12 @@ void ObjectTreeDataViewCtrl::ExpandAll()
     {
       return;
     }
-    ObjectTreeNodePtrArray& children = item->GetChildren();
-    if (children.size())
+    if (!item->HasChildren())
     {
-      Expand(wxDataViewItem(item));
+      return;
     }
-    for (ObjectTreeNode* child : children)
+    Expand(wxDataViewItem(item));
+    for (ObjectTreeNode* child : item->GetChildren())
     {
       expFunc(child);
     }
@@ -619,9 +769,8 @@ void ObjectTreeDataViewCtrl::SaveTreeState()
     {
       return;
     }
-    ObjectTreeNodePtrArray& children = item->GetChildren();
     Expanded[item->GetObjectIndex()] = IsExpanded(wxDataViewItem(item));
-    for (ObjectTreeNode* child : children)
+    for (ObjectTreeNode* child : item->GetLoadedChildren())
     {
       expFunc(child);
     }
@@ -641,12 +790,13 @@ void ObjectTreeDataViewCtrl::RestoreTreeState()
     {
       return;
     }
-    ObjectTreeNodePtrArray& children = item->GetChildren();
-    if (Expanded[item->GetObjectIndex()])
+    auto it = Expanded.find(item->GetObjectIndex());
+    if (it == Expanded.end() || !it->second)
     {
-      Expand(wxDataViewItem(item));
+      return;
     }
-    for (ObjectTreeNode* child : children)
+    Expand(wxDataViewItem(item));
+    for (ObjectTreeNode* child : item->GetChildren())
     {
       expFunc(child);
     }
@@ -671,25 +821,7 @@ void ObjectTreeDataViewCtrl::SelectObject(PACKAGE_INDEX idx)
 int32 ObjectTreeDataViewCtrl::SuitableObjectsCount()
 {
   ObjectTreeModel* model = (ObjectTreeModel*)GetModel();
-  ObjectTreeNode* root = model->GetRootExport();
-  std::function<int32(ObjectTreeNode*)> GetChildrenCntRecursive;
-  GetChildrenCntRecursive = [&](ObjectTreeNode* node) {
-    int32 result = 0;
-    if (node)
-    {
-      if (model->IsEnabled(wxDataViewItem(node), 0) && node->GetClassName() != NAME_Package)
-      {
-        result++;
-      }
-      ObjectTreeNodePtrArray& children = node->GetChildren();
-      for (ObjectTreeNode* child : children)
-      {
-        result += GetChildrenCntRecursive(child);
-      }
-    }
-    return result;
-  };
-  return GetChildrenCntRecursive(root);
+  return model ? model->GetMatchCount() : 0;
 }
 
 bool ObjectTreeDataViewCtrl::HasFilter()
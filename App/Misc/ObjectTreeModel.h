@@ -1,5 +1,8 @@
 #pragma once
 #include <wx/dataview.h>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -16,16 +19,73 @@ typedef signed int PACKAGE_INDEX;
 
 WX_DEFINE_ARRAY_PTR(ObjectTreeNode*, ObjectTreeNodePtrArray);
 
-class ObjectTreeNode {
+// Per export visibility of a class filter or a name search. It's computed in a single pass over the
+// export tree, so nodes can be created lazily and the search can run on a worker thread.
+class ObjectTreeFilter {
 public:
+  // Everything is visible
+  ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports);
+  // Exports of allowed classes and their outers are visible
+  ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports, const std::vector<FString>& allowedClasses);
+  // Top level exports with a matching name and their outers are visible. The pass stops early if cancel is set.
+  ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports, const FString& search, const std::atomic_bool* cancel = nullptr);
+  // Exports found in advance, e.g. by ExportNameIndex, and their outers are visible
+  ObjectTreeFilter(const std::vector<FObjectExport*>& rootExports, const std::vector<FObjectExport*>& matches, const std::atomic_bool* cancel = nullptr);
+
+  // The export or one of its inners passed the filter
+  bool IsVisible(const FObjectExport* exp) const;
+
+  // The export itself passed the filter
+  bool IsMatch(const FObjectExport* exp) const;
+
+  // Number of matching exports that are not packages
+  int32 GetMatchCount() const
+  {
+    return MatchCount;
+  }
+
+  FObjectExport* GetExport(PACKAGE_INDEX index) const;
+
+  // All exports in tree order
+  const std::vector<FObjectExport*>& GetExports() const
+  {
+    return Exports;
+  }
+
+  bool IsCancelled() const
+  {
+    return Cancelled;
+  }
 
-  ObjectTreeNode(const std::string& name, std::vector<FObjectExport*> exps, const std::vector<FString>& allowedClasses);
-  ObjectTreeNode(const std::string& name, std::vector<FObjectExport*> exps, const FString& search);
-  ObjectTreeNode(std::vector<FObjectImport*> imps);
+private:
+  enum Flags : uint8 {
+    Match = 1,
+    Visible = 2
+  };
+
+  void Build(const std::vector<FObjectExport*>& rootExports, const std::function<bool(FObjectExport*)>& matches, const std::atomic_bool* cancel);
+
+  uint8 GetFlags(const FObjectExport* exp) const;
+
+private:
+  // Exports in tree order
+  std::vector<FObjectExport*> Exports;
+  // Flags by ObjectIndex - 1
+  std::vector<uint8> ExportFlags;
+  std::vector<FObjectExport*> ExportsByIndex;
+  int32 MatchCount = 0;
+  bool Cancelled = false;
+  bool AllVisible = false;
+};
 
-  ObjectTreeNode(ObjectTreeNode* parent, FObjectExport* exp, const std::vector<FString>& allowedClasses);
-  ObjectTreeNode(ObjectTreeNode* parent, FObjectExport* exp, const FString& search);
+class ObjectTreeNode {
+public:
+  // Export root
+  ObjectTreeNode(const std::string& name, const std::vector<FObjectExport*>& exps, const ObjectTreeFilter* filter);
+  // Import root
+  ObjectTreeNode(const std::vector<FObjectImport*>& imps);
 
+  ObjectTreeNode(ObjectTreeNode* parent, FObjectExport* exp);
   ObjectTreeNode(ObjectTreeNode* parent, FObjectImport* imp);
 
   ~ObjectTreeNode()
@@ -52,27 +112,54 @@ public:
     return Parent;
   }
 
-  ObjectTreeNodePtrArray& GetChildren()
+  // Children are created on the first call
+  ObjectTreeNodePtrArray& GetChildren();
+
+  // Children created so far. Use to walk the tree without creating nodes.
+  ObjectTreeNodePtrArray& GetLoadedChildren()
   {
     return Children;
   }
 
-  void Append(ObjectTreeNode* child);
+  bool AreChildrenLoaded() const
+  {
+    return ChildrenLoaded;
+  }
 
-  ObjectTreeNode* FindItemByObjectIndex(PACKAGE_INDEX index);
-  ObjectTreeNode* FindItemByName(const FString& name);
-  ObjectTreeNode* FindFirstItemMatch(const FString& name);
+  // Check for visible children without creating them
+  bool HasChildren() const;
+
+  // Find a direct child. Creates children if needed.
+  ObjectTreeNode* FindChild(FObjectResource* resource);
+
+  // Search nodes created so far
+  ObjectTreeNode* FindLoadedItem(PACKAGE_INDEX index);
+
+  void Append(ObjectTreeNode* child);
 
   FObjectExport* GetExport()
   {
     return Export;
   }
 
+  FObjectImport* GetImport()
+  {
+    return Import;
+  }
+
+private:
+  void LoadChildren();
+
 private:
   FObjectExport* Export = nullptr;
   FObjectImport* Import = nullptr;
   FObjectResource* Resource = nullptr;
   PACKAGE_INDEX CustomObjectIndex = 0;
+  const ObjectTreeFilter* Filter = nullptr;
+  // Children of the root nodes
+  std::vector<FObjectExport*> RootExports;
+  std::vector<FObjectImport*> RootImports;
+  bool ChildrenLoaded = false;
 
   ObjectTreeNode* Parent = nullptr;
   ObjectTreeNodePtrArray Children;
@@ -84,6 +171,9 @@ public:
   ObjectTreeModel(const std::string& packageName, std::vector<FObjectExport*>& rootExports, std::vector<FObjectImport*>& rootImports, const std::vector<FString>& allowedClasses);
   
   ObjectTreeModel(const std::string& packageName, std::vector<FObjectExport*>& rootExports, std::vector<FObjectImport*>& rootImports, const FString& search);
+
+  // Use a filter computed in advance, e.g. by a background search
+  ObjectTreeModel(const std::string& packageName, std::vector<FObjectExport*>& rootExports, std::vector<FObjectImport*>& rootImports, std::unique_ptr<ObjectTreeFilter> filter, const FString& search);
   
   ~ObjectTreeModel()
   {
@@ -122,7 +212,17 @@ public:
 
   unsigned int GetChildren(const wxDataViewItem& parent, wxDataViewItemArray& array) const override;
 
+  // Creates nodes on the path to the object. Returns nullptr if the object is hidden by the filter.
   ObjectTreeNode* FindItemByObjectIndex(PACKAGE_INDEX index);
+  // Search nodes created so far
+  ObjectTreeNode* FindLoadedItem(PACKAGE_INDEX index);
+  ObjectTreeNode* FindItemByName(const FString& name);
+  ObjectTreeNode* FindFirstItemMatch(const FString& name);
+
+  int32 GetMatchCount() const
+  {
+    return TreeFilter->GetMatchCount();
+  }
 
   ObjectTreeNode* GetRootExport() const
   {
@@ -146,9 +246,13 @@ public:
 
 protected:
   void BuildIcons();
+  void BuildImportIndex(std::vector<FObjectImport*>& rootImports);
 
 private:
   std::vector<FString> Filter;
+  std::unique_ptr<ObjectTreeFilter> TreeFilter;
+  // Imports by -ObjectIndex - 1
+  std::vector<FObjectImport*> ImportsByIndex;
   FString SearchName;
   ObjectTreeNode* RootExport = nullptr;
   ObjectTreeNode* RootImport = nullptr;
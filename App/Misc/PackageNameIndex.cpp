@@ -0,0 +1,50 @@
+#include "PackageNameIndex.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+  inline bool LessNoCase(const wxString& a, const wxString& b)
+  {
+    return a.CmpNoCase(b) < 0;
+  }
+}
+
+void PackageNameIndex::Build(std::vector<wxString>&& names)
+{
+  Names = std::move(names);
+  std::sort(Names.begin(), Names.end(), LessNoCase);
+  Names.shrink_to_fit();
+}
+
+bool PackageNameIndex::Contains(const wxString& name) const
+{
+  auto it = std::lower_bound(Names.begin(), Names.end(), name, LessNoCase);
+  return it != Names.end() && !it->CmpNoCase(name);
+}
+
+std::pair<std::vector<wxString>::const_iterator, std::vector<wxString>::const_iterator> PackageNameIndex::FindPrefix(const wxString& prefix) const
+{
+  auto first = std::lower_bound(Names.begin(), Names.end(), prefix, LessNoCase);
+  // Names that start with the prefix follow it in the sorted order
+  auto last = std::partition_point(first, Names.end(), [&](const wxString& name) {
+    return !name.Left(prefix.length()).CmpNoCase(prefix);
+  });
+  return { first, last };
+}
+
+bool PackageNameCompleter::Start(const wxString& prefix)
+{
+  if (prefix.empty())
+  {
+    return false;
+  }
+  std::tie(Current, End) = Index->FindPrefix(prefix);
+  return Current != End;
+}
+
+wxString PackageNameCompleter::GetNext()
+{
+  return Current != End ? *Current++ : wxString();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <wx/string.h>
+#include <wx/textcompleter.h>
+
+#include <memory>
+#include <vector>
+
+// Package names sorted case-insensitively. Lookups and prefix queries are binary searches.
+class PackageNameIndex {
+public:
+  void Build(std::vector<wxString>&& names);
+
+  // Case-insensitive exact match
+  bool Contains(const wxString& name) const;
+
+  // Range of names starting with the prefix regardless of case
+  std::pair<std::vector<wxString>::const_iterator, std::vector<wxString>::const_iterator> FindPrefix(const wxString& prefix) const;
+
+  size_t Size() const
+  {
+    return Names.size();
+  }
+
+private:
+  std::vector<wxString> Names;
+};
+
+// Autocomplete for wxTextCtrl served from a snapshot of a PackageNameIndex
+class PackageNameCompleter : public wxTextCompleter {
+public:
+  PackageNameCompleter(std::shared_ptr<const PackageNameIndex> index)
+    : Index(std::move(index))
+  {}
+
+  bool Start(const wxString& prefix) override;
+
+  wxString GetNext() override;
+
+private:
+  std::shared_ptr<const PackageNameIndex> Index;
+  std::vector<wxString>::const_iterator Current;
+  std::vector<wxString>::const_iterator End;
+};
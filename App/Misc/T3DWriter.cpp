@@ -0,0 +1,443 @@
+#include "T3DWriter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+  const size_t ChunkSize = 1024 * 1024;
+  // Enough for any formatted number or a small fixed token
+  const size_t MaxTokenSize = 64;
+  const char* NewLine = "\r\n";
+  const char* IndentStr = "   ";
+  const float RotatorToDegrees = 360.f / 65536.f;
+}
+
+T3DWriter::~T3DWriter()
+{
+  Discard();
+}
+
+void T3DWriter::Open(const std::filesystem::path& path)
+{
+  Discard();
+  Path = path;
+}
+
+bool T3DWriter::Close()
+{
+  if (Path.empty())
+  {
+    return false;
+  }
+  for (Chunk& chunk : Chunks)
+  {
+    FlushChunk(chunk);
+  }
+  bool ok = !Failed;
+  if (Stream.is_open())
+  {
+    Stream.close();
+    ok = ok && !Stream.fail();
+  }
+  Path.clear();
+  Reset();
+  return ok;
+}
+
+void T3DWriter::Discard()
+{
+  if (Stream.is_open())
+  {
+    Stream.close();
+    std::error_code err;
+    std::filesystem::remove(Path, err);
+  }
+  Path.clear();
+  Reset();
+}
+
+bool T3DWriter::Save(const std::filesystem::path& path)
+{
+  if (Stream.is_open())
+  {
+    return false;
+  }
+  Path = path;
+  return Close();
+}
+
+void T3DWriter::Reset()
+{
+  // Keep one chunk around to avoid reallocating it for the next file
+  if (Chunks.size() > 1)
+  {
+    Chunks.resize(1);
+  }
+  if (Chunks.size())
+  {
+    Chunks.front().Size = 0;
+  }
+  Scopes.clear();
+  Size = 0;
+  Failed = false;
+}
+
+void T3DWriter::InitializeMap()
+{
+  Begin("Map");
+  Begin("Level");
+}
+
+void T3DWriter::FinalizeMap()
+{
+  End();
+  // Surface block lives outside of the level
+  if (Scopes.size())
+  {
+    Scopes.pop_back();
+  }
+  Write("Begin Surface");
+  WriteNewLine();
+  Write("End Surface");
+  WriteNewLine();
+  Write("End Map");
+  WriteNewLine();
+}
+
+void T3DWriter::Begin(const char* objType, const char* objClass, const char* name)
+{
+  WriteIndent();
+  Write("Begin ");
+  Write(objType);
+  if (objClass)
+  {
+    Write(" Class=");
+    Write(objClass);
+  }
+  if (name)
+  {
+    Write(" Name=");
+    Write(name);
+  }
+  WriteNewLine();
+  Scopes.emplace_back(objType);
+}
+
+void T3DWriter::End()
+{
+  if (Scopes.empty())
+  {
+    return;
+  }
+  std::string scope = std::move(Scopes.back());
+  Scopes.pop_back();
+  WriteIndent();
+  Write("End ");
+  Write(scope);
+  WriteNewLine();
+}
+
+void T3DWriter::AddCustomLine(std::string_view line)
+{
+  WriteIndent();
+  Write(line);
+  WriteNewLine();
+}
+
+void T3DWriter::AddCustom(std::string_view key, std::string_view value)
+{
+  WriteKey(key);
+  Write(value);
+  WriteNewLine();
+}
+
+void T3DWriter::AddCustom(std::string_view key, int32 index, std::string_view value)
+{
+  WriteKey(key, index);
+  Write(value);
+  WriteNewLine();
+}
+
+void T3DWriter::AddString(std::string_view key, std::string_view value)
+{
+  WriteKey(key);
+  Write("\"", 1);
+  Write(value);
+  Write("\"", 1);
+  WriteNewLine();
+}
+
+void T3DWriter::AddString(std::string_view key, int32 index, std::string_view value)
+{
+  WriteKey(key, index);
+  Write("\"", 1);
+  Write(value);
+  Write("\"", 1);
+  WriteNewLine();
+}
+
+void T3DWriter::AddReference(std::string_view key, std::string_view objClass, std::string_view path)
+{
+  WriteKey(key);
+  WriteReference(objClass, path);
+  WriteNewLine();
+}
+
+void T3DWriter::AddReference(std::string_view key, int32 index, std::string_view objClass, std::string_view path)
+{
+  WriteKey(key, index);
+  WriteReference(objClass, path);
+  WriteNewLine();
+}
+
+void T3DWriter::AddFloat(std::string_view key, float value)
+{
+  WriteKey(key);
+  WriteFloat(value);
+  WriteNewLine();
+}
+
+void T3DWriter::AddInt(std::string_view key, int32 value)
+{
+  WriteKey(key);
+  WriteInt(value);
+  WriteNewLine();
+}
+
+void T3DWriter::AddBool(std::string_view key, bool value)
+{
+  WriteKey(key);
+  Write(value ? "True" : "False");
+  WriteNewLine();
+}
+
+void T3DWriter::AddColor(std::string_view key, const FColor& color)
+{
+  WriteKey(key);
+  Write("(B=");
+  WriteInt(color.B);
+  Write(",G=");
+  WriteInt(color.G);
+  Write(",R=");
+  WriteInt(color.R);
+  Write(",A=");
+  WriteInt(color.A);
+  Write(")", 1);
+  WriteNewLine();
+}
+
+void T3DWriter::AddLinearColor(std::string_view key, const FLinearColor& color)
+{
+  WriteKey(key);
+  Write("(R=");
+  WriteFloat(color.R);
+  Write(",G=");
+  WriteFloat(color.G);
+  Write(",B=");
+  WriteFloat(color.B);
+  Write(",A=");
+  WriteFloat(color.A);
+  Write(")", 1);
+  WriteNewLine();
+}
+
+void T3DWriter::AddGuid(std::string_view key, const FGuid& guid)
+{
+  WriteKey(key);
+  char* dst = Reserve(32);
+  for (uint32 part : { guid.A, guid.B, guid.C, guid.D })
+  {
+    for (int32 shift = 28; shift >= 0; shift -= 4)
+    {
+      *dst++ = "0123456789ABCDEF"[(part >> shift) & 0xF];
+    }
+  }
+  Commit(dst);
+  WriteNewLine();
+}
+
+void T3DWriter::AddPosition(const FVector& position)
+{
+  WriteKey("RelativeLocation");
+  WriteVector(position);
+  WriteNewLine();
+}
+
+void T3DWriter::AddRotation(const FRotator& rotation)
+{
+  const FRotator normalized = rotation.Normalized();
+  WriteKey("RelativeRotation");
+  Write("(Pitch=");
+  WriteFloat(normalized.Pitch * RotatorToDegrees);
+  Write(",Yaw=");
+  WriteFloat(normalized.Yaw * RotatorToDegrees);
+  Write(",Roll=");
+  WriteFloat(normalized.Roll * RotatorToDegrees);
+  Write(")", 1);
+  WriteNewLine();
+}
+
+void T3DWriter::AddScale(const FVector& scale3D, float scale)
+{
+  WriteKey("RelativeScale3D");
+  WriteVector(scale3D * scale);
+  WriteNewLine();
+}
+
+void T3DWriter::AddStaticMesh(std::string_view path)
+{
+  WriteKey("StaticMesh");
+  Write("StaticMesh'\"/Game/");
+  Write(path);
+  Write("\"'", 2);
+  WriteNewLine();
+}
+
+void T3DWriter::AddSkeletalMesh(std::string_view path)
+{
+  WriteKey("SkeletalMesh");
+  Write("SkeletalMesh'\"/Game/");
+  Write(path);
+  Write("\"'", 2);
+  WriteNewLine();
+}
+
+void T3DWriter::Write(const char* data, size_t size)
+{
+  Size += size;
+  while (size)
+  {
+    if (Chunks.empty() || Chunks.back().Size == ChunkSize)
+    {
+      NextChunk();
+    }
+    Chunk& chunk = Chunks.back();
+    size_t count = std::min(size, ChunkSize - chunk.Size);
+    std::memcpy(chunk.Data.get() + chunk.Size, data, count);
+    chunk.Size += count;
+    data += count;
+    size -= count;
+  }
+}
+
+char* T3DWriter::Reserve(size_t size)
+{
+  if (Chunks.empty() || ChunkSize - Chunks.back().Size < size)
+  {
+    NextChunk();
+  }
+  return Chunks.back().Data.get() + Chunks.back().Size;
+}
+
+void T3DWriter::Commit(char* end)
+{
+  Chunk& chunk = Chunks.back();
+  size_t count = end - (chunk.Data.get() + chunk.Size);
+  chunk.Size += count;
+  Size += count;
+}
+
+void T3DWriter::NextChunk()
+{
+  if (Path.empty() || Chunks.empty())
+  {
+    // In-memory mode or the first chunk. Existing chunks are never moved or copied.
+    if (Chunks.size() && !Chunks.back().Size)
+    {
+      return;
+    }
+    Chunk& chunk = Chunks.emplace_back();
+    chunk.Data = std::make_unique<char[]>(ChunkSize);
+    return;
+  }
+  // Streaming mode. Flush and reuse the only chunk.
+  FlushChunk(Chunks.back());
+}
+
+bool T3DWriter::FlushChunk(Chunk& chunk)
+{
+  if (!chunk.Size)
+  {
+    return !Failed;
+  }
+  if (!Stream.is_open() && !Failed)
+  {
+    Stream.open(Path, std::ios::out | std::ios::binary | std::ios::trunc);
+    Failed = !Stream.is_open();
+  }
+  if (!Failed)
+  {
+    Stream.write(chunk.Data.get(), chunk.Size);
+    Failed = Stream.fail();
+  }
+  chunk.Size = 0;
+  return !Failed;
+}
+
+void T3DWriter::WriteIndent()
+{
+  for (size_t idx = 0; idx < Scopes.size(); ++idx)
+  {
+    Write(IndentStr, 3);
+  }
+}
+
+void T3DWriter::WriteKey(std::string_view key)
+{
+  WriteIndent();
+  Write(key);
+  Write("=", 1);
+}
+
+void T3DWriter::WriteKey(std::string_view key, int32 index)
+{
+  WriteIndent();
+  Write(key);
+  Write("(", 1);
+  WriteInt(index);
+  Write(")=", 2);
+}
+
+void T3DWriter::WriteReference(std::string_view objClass, std::string_view path)
+{
+  Write(objClass);
+  Write("'\"", 2);
+  Write(path);
+  Write("\"'", 2);
+}
+
+void T3DWriter::WriteInt(int64 value)
+{
+  char* dst = Reserve(MaxTokenSize);
+  Commit(std::to_chars(dst, dst + MaxTokenSize, value).ptr);
+}
+
+void T3DWriter::WriteFloat(float value)
+{
+  char* dst = Reserve(MaxTokenSize);
+  std::to_chars_result result = std::to_chars(dst, dst + MaxTokenSize, value, std::chars_format::fixed, 6);
+  if (result.ec != std::errc())
+  {
+    // Huge values don't fit the token. Fall back to the scientific notation.
+    result = std::to_chars(dst, dst + MaxTokenSize, value, std::chars_format::scientific, 6);
+  }
+  Commit(result.ptr);
+}
+
+void T3DWriter::WriteVector(const FVector& v)
+{
+  Write("(X=");
+  WriteFloat(v.X);
+  Write(",Y=");
+  WriteFloat(v.Y);
+  Write(",Z=");
+  WriteFloat(v.Z);
+  Write(")", 1);
+}
+
+void T3DWriter::WriteNewLine()
+{
+  Write(NewLine, 2);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <Tera/Core.h>
+#include <Tera/FStructs.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// T3D text writer backed by a chunked arena. Numbers are formatted in place with std::to_chars.
+// Without a destination the text stays in memory until Save. After Open full chunks are streamed
+// to disk and reused, so memory usage stays flat regardless of the map size.
+class T3DWriter {
+public:
+  T3DWriter() = default;
+  T3DWriter(const T3DWriter&) = delete;
+  T3DWriter& operator=(const T3DWriter&) = delete;
+  // Unfinished streamed output is discarded
+  ~T3DWriter();
+
+  // Stream to the file. The file is created on the first flush.
+  void Open(const std::filesystem::path& path);
+  // Flush the remaining data and close the file
+  bool Close();
+  // Drop buffered data and remove the streamed file if it was created
+  void Discard();
+  // Write buffered data to the file and reset the writer
+  bool Save(const std::filesystem::path& path);
+
+  // Total number of bytes emitted since the writer was reset
+  inline uint64 GetSize() const
+  {
+    return Size;
+  }
+
+  void InitializeMap();
+  void FinalizeMap();
+
+  void Begin(const char* objType, const char* objClass = nullptr, const char* name = nullptr);
+  void End();
+
+  void AddCustomLine(std::string_view line);
+  void AddCustom(std::string_view key, std::string_view value);
+  // key(index)=value
+  void AddCustom(std::string_view key, int32 index, std::string_view value);
+  void AddString(std::string_view key, std::string_view value);
+  void AddString(std::string_view key, int32 index, std::string_view value);
+  // key=Class'"path"'
+  void AddReference(std::string_view key, std::string_view objClass, std::string_view path);
+  void AddReference(std::string_view key, int32 index, std::string_view objClass, std::string_view path);
+  void AddFloat(std::string_view key, float value);
+  void AddInt(std::string_view key, int32 value);
+  void AddBool(std::string_view key, bool value);
+  void AddColor(std::string_view key, const FColor& color);
+  void AddLinearColor(std::string_view key, const FLinearColor& color);
+  void AddGuid(std::string_view key, const FGuid& guid);
+  void AddPosition(const FVector& position);
+  void AddRotation(const FRotator& rotation);
+  void AddScale(const FVector& scale3D, float scale);
+  void AddStaticMesh(std::string_view path);
+  void AddSkeletalMesh(std::string_view path);
+
+private:
+  struct Chunk {
+    std::unique_ptr<char[]> Data;
+    size_t Size = 0;
+  };
+
+  void Reset();
+  void Write(const char* data, size_t size);
+  inline void Write(std::string_view str)
+  {
+    Write(str.data(), str.size());
+  }
+  // Get at least 'size' contiguous bytes in the current chunk
+  char* Reserve(size_t size);
+  void Commit(char* end);
+  void NextChunk();
+  bool FlushChunk(Chunk& chunk);
+
+  void WriteIndent();
+  void WriteKey(std::string_view key);
+  void WriteKey(std::string_view key, int32 index);
+  void WriteReference(std::string_view objClass, std::string_view path);
+  void WriteInt(int64 value);
+  void WriteFloat(float value);
+  void WriteVector(const FVector& v);
+  void WriteNewLine();
+
+private:
+  std::vector<Chunk> Chunks;
+  std::vector<std::string> Scopes;
+  std::filesystem::path Path;
+  std::ofstream Stream;
+  uint64 Size = 0;
+  bool Failed = false;
+};
@@ -0,0 +1,527 @@
+#include "TerrainRaster.h"
+
+#include <wx/stream.h>
+#include <wx/zstream.h>
+
+#include <immintrin.h>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+// GCC and Clang compile wider intrinsics only in functions built for the instruction set
+#ifdef _MSC_VER
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+  // Source sample positions for each destination column/row
+  struct ResampleAxis {
+    std::vector<int32> Index;
+    std::vector<float> Frac;
+  };
+
+  ResampleAxis BuildResampleAxis(int32 srcSize, int32 dstSize)
+  {
+    ResampleAxis axis;
+    axis.Index.resize(dstSize);
+    axis.Frac.resize(dstSize);
+    const double step = dstSize > 1 ? double(srcSize - 1) / double(dstSize - 1) : 0.;
+    for (int32 idx = 0; idx < dstSize; ++idx)
+    {
+      double pos = idx * step;
+      int32 i = std::min<int32>(int32(pos), srcSize - 1);
+      axis.Index[idx] = i;
+      axis.Frac[idx] = i == srcSize - 1 ? 0.f : float(pos - i);
+    }
+    return axis;
+  }
+
+  // Round using the current MXCSR mode, so scalar tails match vector bodies
+  inline int32 RoundToInt(float v)
+  {
+    return _mm_cvtss_si32(_mm_set_ss(v));
+  }
+
+  template <typename T>
+  void LerpRowsScalar(const T* r0, const T* r1, float fy, float* out, int32 x, int32 width)
+  {
+    for (; x < width; ++x)
+    {
+      out[x] = float(r0[x]) + (float(r1[x]) - float(r0[x])) * fy;
+    }
+  }
+
+  template <typename T>
+  void LerpColumnsScalar(const float* row, const ResampleAxis& axis, T* out, int32 x, int32 width)
+  {
+    for (; x < width; ++x)
+    {
+      const float a = row[axis.Index[x]];
+      const float b = row[axis.Index[x] + 1];
+      out[x] = (T)RoundToInt(a + (b - a) * axis.Frac[x]);
+    }
+  }
+
+  template <typename T>
+  void LerpRowsSSE2(const T* r0, const T* r1, float fy, float* out, int32 width)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 vfy = _mm_set1_ps(fy);
+    int32 x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+      __m128i a;
+      __m128i b;
+      if constexpr (sizeof(T) == 1)
+      {
+        a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(r0 + x)), zero);
+        b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(r1 + x)), zero);
+      }
+      else
+      {
+        a = _mm_loadu_si128((const __m128i*)(r0 + x));
+        b = _mm_loadu_si128((const __m128i*)(r1 + x));
+      }
+      __m128 a0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero));
+      __m128 a1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero));
+      __m128 b0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero));
+      __m128 b1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(b, zero));
+      _mm_storeu_ps(out + x, _mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(b0, a0), vfy)));
+      _mm_storeu_ps(out + x + 4, _mm_add_ps(a1, _mm_mul_ps(_mm_sub_ps(b1, a1), vfy)));
+    }
+    LerpRowsScalar(r0, r1, fy, out, x, width);
+  }
+
+  template <typename T>
+  void LerpColumnsSSE2(const float* row, const ResampleAxis& axis, T* out, int32 width)
+  {
+    const int32* index = axis.Index.data();
+    int32 x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+      __m128 a = _mm_setr_ps(row[index[x]], row[index[x + 1]], row[index[x + 2]], row[index[x + 3]]);
+      __m128 b = _mm_setr_ps(row[index[x] + 1], row[index[x + 1] + 1], row[index[x + 2] + 1], row[index[x + 3] + 1]);
+      __m128 f = _mm_loadu_ps(axis.Frac.data() + x);
+      __m128i v = _mm_cvtps_epi32(_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), f)));
+      if constexpr (sizeof(T) == 1)
+      {
+        v = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+        *(int32*)(out + x) = _mm_cvtsi128_si32(v);
+      }
+      else
+      {
+        // SSE2 has no unsigned 32->16 pack. Bias into the signed range and flip the sign bit back.
+        v = _mm_packs_epi32(_mm_sub_epi32(v, _mm_set1_epi32(0x8000)), v);
+        v = _mm_xor_si128(v, _mm_set1_epi16((int16)0x8000));
+        _mm_storel_epi64((__m128i*)(out + x), v);
+      }
+    }
+    LerpColumnsScalar(row, axis, out, x, width);
+  }
+
+  template <typename T>
+  TARGET_AVX2 void LerpRowsAVX2(const T* r0, const T* r1, float fy, float* out, int32 width)
+  {
+    const __m256 vfy = _mm256_set1_ps(fy);
+    int32 x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+      __m256 a;
+      __m256 b;
+      if constexpr (sizeof(T) == 1)
+      {
+        a = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(r0 + x))));
+        b = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(r1 + x))));
+      }
+      else
+      {
+        a = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(r0 + x))));
+        b = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(r1 + x))));
+      }
+      _mm256_storeu_ps(out + x, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), vfy)));
+    }
+    LerpRowsScalar(r0, r1, fy, out, x, width);
+  }
+
+  template <typename T>
+  TARGET_AVX2 void LerpColumnsAVX2(const float* row, const ResampleAxis& axis, T* out, int32 width)
+  {
+    int32 x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+      __m256i idx = _mm256_loadu_si256((const __m256i*)(axis.Index.data() + x));
+      __m256 a = _mm256_i32gather_ps(row, idx, 4);
+      __m256 b = _mm256_i32gather_ps(row + 1, idx, 4);
+      __m256 f = _mm256_loadu_ps(axis.Frac.data() + x);
+      __m256i v = _mm256_cvtps_epi32(_mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), f)));
+      __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+      if constexpr (sizeof(T) == 1)
+      {
+        _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(packed, packed));
+      }
+      else
+      {
+        _mm_storeu_si128((__m128i*)(out + x), packed);
+      }
+    }
+    LerpColumnsScalar(row, axis, out, x, width);
+  }
+
+  template <typename T>
+  void Resample(const T* src, int32 srcWidth, int32 srcHeight, T* dst, int32 dstWidth, int32 dstHeight)
+  {
+    const ResampleAxis xAxis = BuildResampleAxis(srcWidth, dstWidth);
+    const ResampleAxis yAxis = BuildResampleAxis(srcHeight, dstHeight);
+    const bool avx2 = HasAVX2();
+    // One extra element so the right neighbor of the last column is always readable
+    std::vector<float> row(srcWidth + 1);
+    for (int32 y = 0; y < dstHeight; ++y)
+    {
+      const int32 sy = yAxis.Index[y];
+      const T* r0 = src + size_t(sy) * srcWidth;
+      const T* r1 = sy + 1 < srcHeight ? r0 + srcWidth : r0;
+      T* out = dst + size_t(y) * dstWidth;
+      if (avx2)
+      {
+        LerpRowsAVX2(r0, r1, yAxis.Frac[y], row.data(), srcWidth);
+        row[srcWidth] = row[srcWidth - 1];
+        LerpColumnsAVX2(row.data(), xAxis, out, dstWidth);
+      }
+      else
+      {
+        LerpRowsSSE2(r0, r1, yAxis.Frac[y], row.data(), srcWidth);
+        row[srcWidth] = row[srcWidth - 1];
+        LerpColumnsSSE2(row.data(), xAxis, out, dstWidth);
+      }
+    }
+  }
+
+  // Filters whole 32 byte blocks. Returns the number of filtered bytes.
+  TARGET_AVX2 size_t FilterRowUpAVX2(const uint8* cur, const uint8* prev, uint8* out, size_t size, bool swap16)
+  {
+    size_t idx = 0;
+    for (; idx + 32 <= size; idx += 32)
+    {
+      __m256i d = _mm256_loadu_si256((const __m256i*)(cur + idx));
+      if (prev)
+      {
+        d = _mm256_sub_epi8(d, _mm256_loadu_si256((const __m256i*)(prev + idx)));
+      }
+      if (swap16)
+      {
+        d = _mm256_or_si256(_mm256_slli_epi16(d, 8), _mm256_srli_epi16(d, 8));
+      }
+      _mm256_storeu_si256((__m256i*)(out + idx), d);
+    }
+    return idx;
+  }
+
+  // PNG "Up" filter. 16-bit samples are also converted to big-endian as PNG requires.
+  void FilterRowUp(const uint8* cur, const uint8* prev, uint8* out, size_t size, bool swap16)
+  {
+    size_t idx = HasAVX2() ? FilterRowUpAVX2(cur, prev, out, size, swap16) : 0;
+    for (; idx + 16 <= size; idx += 16)
+    {
+      __m128i d = _mm_loadu_si128((const __m128i*)(cur + idx));
+      if (prev)
+      {
+        d = _mm_sub_epi8(d, _mm_loadu_si128((const __m128i*)(prev + idx)));
+      }
+      if (swap16)
+      {
+        d = _mm_or_si128(_mm_slli_epi16(d, 8), _mm_srli_epi16(d, 8));
+      }
+      _mm_storeu_si128((__m128i*)(out + idx), d);
+    }
+    for (; idx < size; ++idx)
+    {
+      out[idx] = cur[idx] - (prev ? prev[idx] : 0);
+    }
+    if (swap16)
+    {
+      // Row sizes are even for 16-bit samples, so only whole pairs remain
+      for (idx = size & ~size_t(15); idx + 1 < size; idx += 2)
+      {
+        std::swap(out[idx], out[idx + 1]);
+      }
+    }
+  }
+
+  uint32 PngCrc(const uint8* data, size_t size, uint32 crc = 0xFFFFFFFF)
+  {
+    static const std::array<uint32, 256> table = [] {
+      std::array<uint32, 256> result;
+      for (uint32 n = 0; n < 256; ++n)
+      {
+        uint32 c = n;
+        for (int32 k = 0; k < 8; ++k)
+        {
+          c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        }
+        result[n] = c;
+      }
+      return result;
+    }();
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+      crc = table[(crc ^ data[idx]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+  }
+
+  void WriteBE32(uint8* dst, uint32 v)
+  {
+    dst[0] = uint8(v >> 24);
+    dst[1] = uint8(v >> 16);
+    dst[2] = uint8(v >> 8);
+    dst[3] = uint8(v);
+  }
+
+  void WritePngChunk(std::ofstream& s, const char* type, const uint8* data, uint32 size)
+  {
+    uint8 header[8];
+    WriteBE32(header, size);
+    memcpy(header + 4, type, 4);
+    uint32 crc = PngCrc(header + 4, 4);
+    if (size)
+    {
+      crc = PngCrc(data, size, crc);
+    }
+    uint8 footer[4];
+    WriteBE32(footer, crc ^ 0xFFFFFFFF);
+    s.write((const char*)header, sizeof(header));
+    if (size)
+    {
+      s.write((const char*)data, size);
+    }
+    s.write((const char*)footer, sizeof(footer));
+  }
+
+  // Splits the deflate stream into IDAT chunks as it's produced, so memory stays flat for any raster size
+  class PngDataStream : public wxOutputStream {
+  public:
+    PngDataStream(std::ofstream& s)
+      : Stream(s)
+    {
+      Buffer.reserve(ChunkSize);
+    }
+
+    void Finish()
+    {
+      if (Buffer.size())
+      {
+        WritePngChunk(Stream, "IDAT", Buffer.data(), (uint32)Buffer.size());
+        Buffer.clear();
+      }
+    }
+
+  protected:
+    size_t OnSysWrite(const void* buffer, size_t size) override
+    {
+      const uint8* ptr = (const uint8*)buffer;
+      size_t left = size;
+      while (left)
+      {
+        size_t len = std::min(left, ChunkSize - Buffer.size());
+        Buffer.insert(Buffer.end(), ptr, ptr + len);
+        ptr += len;
+        left -= len;
+        if (Buffer.size() == ChunkSize)
+        {
+          Finish();
+        }
+      }
+      return size;
+    }
+
+  private:
+    static constexpr size_t ChunkSize = 1024 * 1024;
+    std::ofstream& Stream;
+    std::vector<uint8> Buffer;
+  };
+}
+
+TerrainRaster::TerrainRaster(TerrainRaster&& a) noexcept
+{
+  *this = std::move(a);
+}
+
+TerrainRaster& TerrainRaster::operator=(TerrainRaster&& a) noexcept
+{
+  if (this != &a)
+  {
+    if (Owned)
+    {
+      free(Data);
+    }
+    Data = a.Data;
+    Width = a.Width;
+    Height = a.Height;
+    BytesPerPixel = a.BytesPerPixel;
+    Owned = a.Owned;
+    a.Data = nullptr;
+    a.Owned = false;
+    a.Width = a.Height = 0;
+  }
+  return *this;
+}
+
+TerrainRaster::~TerrainRaster()
+{
+  if (Owned)
+  {
+    free(Data);
+  }
+}
+
+TerrainRaster TerrainRaster::Adopt(void* data, int32 width, int32 height, int32 bytesPerPixel)
+{
+  TerrainRaster result;
+  result.Data = (uint8*)data;
+  result.Width = width;
+  result.Height = height;
+  result.BytesPerPixel = bytesPerPixel;
+  result.Owned = true;
+  return result;
+}
+
+TerrainRaster TerrainRaster::View(const void* data, int32 width, int32 height, int32 bytesPerPixel)
+{
+  TerrainRaster result;
+  result.Data = (uint8*)data;
+  result.Width = width;
+  result.Height = height;
+  result.BytesPerPixel = bytesPerPixel;
+  return result;
+}
+
+TerrainRaster TerrainRaster::Resampled(int32 width, int32 height) const
+{
+  if (!IsValid() || BytesPerPixel == 4 || width <= 0 || height <= 0)
+  {
+    return {};
+  }
+  void* dst = malloc(size_t(width) * height * BytesPerPixel);
+  if (!dst)
+  {
+    return {};
+  }
+  if (width == Width && height == Height)
+  {
+    memcpy(dst, Data, size_t(width) * height * BytesPerPixel);
+  }
+  else if (BytesPerPixel == 2)
+  {
+    Resample((const uint16*)Data, Width, Height, (uint16*)dst, width, height);
+  }
+  else
+  {
+    Resample(Data, Width, Height, (uint8*)dst, width, height);
+  }
+  return Adopt(dst, width, height, BytesPerPixel);
+}
+
+bool TerrainRaster::SavePng(const std::filesystem::path& path, std::string& error) const
+{
+  if (!IsValid() || BytesPerPixel == 4)
+  {
+    error = "No raster data";
+    return false;
+  }
+  std::ofstream s(path, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!s.is_open())
+  {
+    error = "Failed to create " + path.filename().u8string();
+    return false;
+  }
+
+  static const uint8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  s.write((const char*)signature, sizeof(signature));
+
+  uint8 ihdr[13];
+  WriteBE32(ihdr, Width);
+  WriteBE32(ihdr + 4, Height);
+  ihdr[8] = uint8(BytesPerPixel * 8);
+  ihdr[9] = 0; // Grayscale
+  ihdr[10] = 0; // Deflate
+  ihdr[11] = 0; // Adaptive filtering
+  ihdr[12] = 0; // No interlace
+  WritePngChunk(s, "IHDR", ihdr, sizeof(ihdr));
+
+  {
+    PngDataStream idat(s);
+    {
+      wxZlibOutputStream zs(idat, wxZ_DEFAULT_COMPRESSION, wxZLIB_ZLIB);
+      const size_t stride = size_t(Width) * BytesPerPixel;
+      std::vector<uint8> scanline(stride + 1);
+      scanline[0] = 2; // Up
+      for (int32 y = 0; y < Height; ++y)
+      {
+        const uint8* cur = Data + stride * y;
+        FilterRowUp(cur, y ? cur - stride : nullptr, scanline.data() + 1, stride, BytesPerPixel == 2);
+        zs.Write(scanline.data(), scanline.size());
+        if (!zs.IsOk())
+        {
+          error = "Failed to compress the image data";
+          return false;
+        }
+      }
+      zs.Close();
+    }
+    idat.Finish();
+  }
+  WritePngChunk(s, "IEND", nullptr, 0);
+
+  if (!s.good())
+  {
+    error = "Failed to write " + path.filename().u8string();
+    return false;
+  }
+  return true;
+}
+
+bool TerrainRaster::SaveTga(const std::filesystem::path& path, std::string& error) const
+{
+  if (!IsValid() || BytesPerPixel == 2)
+  {
+    error = "No raster data";
+    return false;
+  }
+  if (Width > 0xFFFF || Height > 0xFFFF)
+  {
+    error = "The raster is too big for TGA";
+    return false;
+  }
+  std::ofstream s(path, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!s.is_open())
+  {
+    error = "Failed to create " + path.filename().u8string();
+    return false;
+  }
+
+  uint8 header[18] = {};
+  header[2] = BytesPerPixel == 4 ? 2 : 3; // Uncompressed true color or grayscale
+  header[12] = uint8(Width & 0xFF);
+  header[13] = uint8(Width >> 8);
+  header[14] = uint8(Height & 0xFF);
+  header[15] = uint8(Height >> 8);
+  header[16] = uint8(BytesPerPixel * 8);
+  header[17] = 0x20 | (BytesPerPixel == 4 ? 8 : 0); // Top-left origin and alpha bits
+  s.write((const char*)header, sizeof(header));
+  s.write((const char*)Data, std::streamsize(size_t(Width) * Height * BytesPerPixel));
+
+  if (!s.good())
+  {
+    error = "Failed to write " + path.filename().u8string();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <Tera/Core.h>
+
+#include <filesystem>
+#include <string>
+
+// Single channel 8 or 16-bit raster used to export terrain height, visibility and weight maps.
+// Combined weight maps are 32-bit BGRA rasters saved as TGA.
+// Resampling uses SSE2 with an AVX2 fast path and encoding doesn't depend on the CPU features.
+class TerrainRaster {
+public:
+  TerrainRaster() = default;
+  TerrainRaster(const TerrainRaster&) = delete;
+  TerrainRaster& operator=(const TerrainRaster&) = delete;
+  TerrainRaster(TerrainRaster&& a) noexcept;
+  TerrainRaster& operator=(TerrainRaster&& a) noexcept;
+  ~TerrainRaster();
+
+  // Take ownership of a malloc'ed buffer returned by UTerrain/ULandscape getters. No copy is made.
+  static TerrainRaster Adopt(void* data, int32 width, int32 height, int32 bytesPerPixel);
+
+  // Wrap memory owned by someone else. The memory must outlive the raster.
+  static TerrainRaster View(const void* data, int32 width, int32 height, int32 bytesPerPixel);
+
+  inline bool IsValid() const
+  {
+    return Data && Width > 0 && Height > 0 && (BytesPerPixel == 1 || BytesPerPixel == 2 || BytesPerPixel == 4);
+  }
+
+  inline int32 GetWidth() const
+  {
+    return Width;
+  }
+
+  inline int32 GetHeight() const
+  {
+    return Height;
+  }
+
+  inline int32 GetBytesPerPixel() const
+  {
+    return BytesPerPixel;
+  }
+
+  inline const uint8* GetData() const
+  {
+    return Data;
+  }
+
+  // Bilinear resampling with aligned corners, so edge samples stay on the terrain borders.
+  // BGRA rasters can't be resampled.
+  TerrainRaster Resampled(int32 width, int32 height) const;
+
+  // Save as a grayscale PNG. 16-bit rasters keep full precision.
+  bool SavePng(const std::filesystem::path& path, std::string& error) const;
+
+  // Save as an uncompressed TGA. 8-bit rasters are saved as grayscale, 32-bit as BGRA.
+  bool SaveTga(const std::filesystem::path& path, std::string& error) const;
+
+private:
+  uint8* Data = nullptr;
+  int32 Width = 0;
+  int32 Height = 0;
+  int32 BytesPerPixel = 1;
+  bool Owned = false;
+};
@@ -0,0 +1,169 @@
+#include "TextureCache.h"
+
+#include <Tera/FPackage.h>
+#include <Tera/UTexture.h>
+
+#include <cstring>
+
+namespace
+{
+  bool CopyBitmap(UTexture2D* texture, UTextureBitmapInfo& info, osg::Image* img, uint64& outSize)
+  {
+    if (!texture->GetBitmapData(info) || !info.IsValid())
+    {
+      return false;
+    }
+    // Bitmap memory is owned by the texture object. Wrap it to get the size and copy it.
+    img->setImage(info.Width, info.Height, 1, info.InternalFormat, info.Format, info.Type, (unsigned char*)info.Allocation, osg::Image::AllocationMode::NO_DELETE);
+    outSize = img->getTotalSizeInBytes();
+    unsigned char* pixels = new unsigned char[outSize];
+    std::memcpy(pixels, info.Allocation, outSize);
+    img->setImage(info.Width, info.Height, 1, info.InternalFormat, info.Format, info.Type, pixels, osg::Image::AllocationMode::USE_NEW_DELETE);
+    return true;
+  }
+}
+
+TextureCache& TextureCache::Get()
+{
+  static TextureCache cache;
+  return cache;
+}
+
+osg::ref_ptr<osg::Texture2D> TextureCache::GetTexture(UTexture2D* texture, int32 maxSize)
+{
+  if (!texture)
+  {
+    return nullptr;
+  }
+  const Key key = { texture, maxSize };
+  {
+    std::scoped_lock<std::mutex> l(Mutex);
+    auto it = Entries.find(key);
+    if (it != Entries.end())
+    {
+      Lru.splice(Lru.begin(), Lru, it->second.LruIt);
+      return it->second.Texture;
+    }
+  }
+
+  // Decode outside of the lock. If another thread was faster, use its texture.
+  uint64 size = 0;
+  osg::ref_ptr<osg::Texture2D> result = CreateTexture(texture, maxSize, size);
+  if (!result)
+  {
+    return nullptr;
+  }
+
+  std::scoped_lock<std::mutex> l(Mutex);
+  auto it = Entries.find(key);
+  if (it != Entries.end())
+  {
+    Lru.splice(Lru.begin(), Lru, it->second.LruIt);
+    return it->second.Texture;
+  }
+  Lru.push_front(key);
+  Entry& entry = Entries[key];
+  entry.Texture = result;
+  entry.Package = texture->GetPackage();
+  entry.Size = size;
+  entry.LruIt = Lru.begin();
+  Usage += size;
+  Trim();
+  return result;
+}
+
+void TextureCache::Invalidate(UTexture2D* texture)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  for (auto it = Entries.begin(); it != Entries.end();)
+  {
+    if (it->first.Texture == texture)
+    {
+      Usage -= it->second.Size;
+      Lru.erase(it->second.LruIt);
+      it = Entries.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void TextureCache::Evict(const std::function<bool(FPackage*)>& unloaded)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  for (auto it = Entries.begin(); it != Entries.end();)
+  {
+    if (unloaded(it->second.Package))
+    {
+      Usage -= it->second.Size;
+      Lru.erase(it->second.LruIt);
+      it = Entries.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void TextureCache::SetBudget(uint64 bytes)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  Budget = bytes;
+  Trim();
+}
+
+uint64 TextureCache::GetBudget() const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  return Budget;
+}
+
+uint64 TextureCache::GetUsage() const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  return Usage;
+}
+
+osg::ref_ptr<osg::Texture2D> TextureCache::CreateTexture(UTexture2D* texture, int32 maxSize, uint64& outSize)
+{
+  osg::ref_ptr<osg::Image> img = new osg::Image;
+  {
+    std::scoped_lock<std::mutex> l(DecodeMutex);
+    bool decoded = false;
+    if (maxSize > 0)
+    {
+      UTextureBitmapInfo info(maxSize);
+      decoded = CopyBitmap(texture, info, img, outSize);
+    }
+    else
+    {
+      UTextureBitmapInfo info;
+      decoded = CopyBitmap(texture, info, img, outSize);
+    }
+    if (!decoded)
+    {
+      return nullptr;
+    }
+  }
+
+  osg::ref_ptr<osg::Texture2D> result = new osg::Texture2D(img);
+  result->setUseHardwareMipMapGeneration(true);
+  result->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::REPEAT);
+  result->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::REPEAT);
+  return result;
+}
+
+void TextureCache::Trim()
+{
+  // Always keep the most recent entry, even if it doesn't fit the budget alone
+  while (Usage > Budget && Lru.size() > 1)
+  {
+    auto it = Entries.find(Lru.back());
+    Usage -= it->second.Size;
+    Entries.erase(it);
+    Lru.pop_back();
+  }
+}
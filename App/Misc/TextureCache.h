@@ -0,0 +1,76 @@
+#pragma once
+#include <Tera/Core.h>
+
+#include <osg/Texture2D>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+class FPackage;
+class UTexture2D;
+
+// Process-wide LRU cache of decoded bitmaps and their OSG textures shared by all viewers.
+// Entries are keyed by the texture object and the requested mip size. Images own a copy of the
+// pixels, so evicting an entry frees its memory unless a scene still references the texture.
+class TextureCache {
+public:
+  static TextureCache& Get();
+
+  // Get a shared texture for the mip closest to maxSize. 0 selects the top mip.
+  // Returns nullptr if the bitmap can't be decoded. Thread safe.
+  osg::ref_ptr<osg::Texture2D> GetTexture(UTexture2D* texture, int32 maxSize = 0);
+
+  // Drop all mips of the texture. Call when the texture data changes.
+  void Invalidate(UTexture2D* texture);
+  // Drop textures of the packages that match. Call before unloading packages, so freed objects
+  // can't be matched by address.
+  void Evict(const std::function<bool(FPackage*)>& unloaded);
+
+  void SetBudget(uint64 bytes);
+  uint64 GetBudget() const;
+  uint64 GetUsage() const;
+
+private:
+  TextureCache() = default;
+
+  struct Key {
+    UTexture2D* Texture = nullptr;
+    int32 MaxSize = 0;
+
+    inline bool operator==(const Key& a) const
+    {
+      return Texture == a.Texture && MaxSize == a.MaxSize;
+    }
+  };
+
+  struct KeyHash {
+    inline size_t operator()(const Key& k) const
+    {
+      return std::hash<UTexture2D*>()(k.Texture) ^ (std::hash<int32>()(k.MaxSize) << 1);
+    }
+  };
+
+  struct Entry {
+    osg::ref_ptr<osg::Texture2D> Texture;
+    FPackage* Package = nullptr;
+    uint64 Size = 0;
+    std::list<Key>::iterator LruIt;
+  };
+
+  osg::ref_ptr<osg::Texture2D> CreateTexture(UTexture2D* texture, int32 maxSize, uint64& outSize);
+  // Evict the least recently used entries until the usage fits the budget. Expects the lock.
+  void Trim();
+
+private:
+  std::unordered_map<Key, Entry, KeyHash> Entries;
+  // Front is the most recently used entry
+  std::list<Key> Lru;
+  uint64 Usage = 0;
+  uint64 Budget = 512ULL * 1024 * 1024;
+  mutable std::mutex Mutex;
+  // GetBitmapData reuses a bitmap buffer of the texture object. Decode one bitmap at a time and copy
+  // the pixels before another call can replace the buffer.
+  std::mutex DecodeMutex;
+};
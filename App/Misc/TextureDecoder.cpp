@@ -0,0 +1,585 @@
+#include "TextureDecoder.h"
+
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+// GCC and Clang compile wider intrinsics only in functions built for the instruction set
+#ifdef _MSC_VER
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+  struct KernelTable {
+    // 16 pixels from a 4 color palette and 2-bit indices
+    void (*ExpandColors)(const uint32* palette, uint32 indices, uint32* out);
+    // 16 values from an 8 entry palette and 3-bit indices
+    void (*ExpandAlpha)(const uint32* palette, uint64 indices, uint32* out);
+    // Replace alpha of 16 pixels
+    void (*MergeAlpha)(uint32* pixels, const uint32* alpha);
+    // Gray to opaque pixels
+    void (*ConvertG8)(const uint8* src, uint32* out, int32 count);
+    void (*ConvertG16)(const uint16* src, uint32* out, int32 count);
+  };
+
+  inline uint32 Pack(uint32 r, uint32 g, uint32 b, uint32 a)
+  {
+    return b | (g << 8) | (r << 16) | (a << 24);
+  }
+
+  // Exact for v < 98304
+  inline uint32 Div3(uint32 v)
+  {
+    return (v * 43691) >> 17;
+  }
+
+  inline uint32 ReadUInt32(const uint8* p)
+  {
+    uint32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  inline uint64 ReadAlphaIndices(const uint8* block)
+  {
+    uint64 v = 0;
+    memcpy(&v, block + 2, 6);
+    return v;
+  }
+
+  void BuildColorPalette(const uint8* block, bool allowThreeColors, uint32* palette)
+  {
+    const uint32 c0 = block[0] | (block[1] << 8);
+    const uint32 c1 = block[2] | (block[3] << 8);
+    uint32 r0 = (c0 >> 11) & 31;
+    uint32 g0 = (c0 >> 5) & 63;
+    uint32 b0 = c0 & 31;
+    uint32 r1 = (c1 >> 11) & 31;
+    uint32 g1 = (c1 >> 5) & 63;
+    uint32 b1 = c1 & 31;
+    r0 = (r0 << 3) | (r0 >> 2);
+    g0 = (g0 << 2) | (g0 >> 4);
+    b0 = (b0 << 3) | (b0 >> 2);
+    r1 = (r1 << 3) | (r1 >> 2);
+    g1 = (g1 << 2) | (g1 >> 4);
+    b1 = (b1 << 3) | (b1 >> 2);
+    palette[0] = Pack(r0, g0, b0, 255);
+    palette[1] = Pack(r1, g1, b1, 255);
+    if (c0 > c1 || !allowThreeColors)
+    {
+      palette[2] = Pack(Div3(2 * r0 + r1), Div3(2 * g0 + g1), Div3(2 * b0 + b1), 255);
+      palette[3] = Pack(Div3(r0 + 2 * r1), Div3(g0 + 2 * g1), Div3(b0 + 2 * b1), 255);
+    }
+    else
+    {
+      // DXT1 three color mode. The last entry is transparent black.
+      palette[2] = Pack((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 255);
+      palette[3] = 0;
+    }
+  }
+
+  void BuildAlphaPalette(const uint8* block, uint32* palette)
+  {
+    const uint32 a0 = block[0];
+    const uint32 a1 = block[1];
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+    {
+      for (uint32 idx = 1; idx < 7; ++idx)
+      {
+        palette[idx + 1] = ((7 - idx) * a0 + idx * a1) / 7;
+      }
+    }
+    else
+    {
+      for (uint32 idx = 1; idx < 5; ++idx)
+      {
+        palette[idx + 1] = ((5 - idx) * a0 + idx * a1) / 5;
+      }
+      palette[6] = 0;
+      palette[7] = 255;
+    }
+  }
+
+  inline uint32 PackNormal(uint32 x, uint32 y)
+  {
+    const float nx = x / 127.5f - 1.f;
+    const float ny = y / 127.5f - 1.f;
+    const float nz = std::sqrt(std::max(0.f, 1.f - nx * nx - ny * ny));
+    const uint32 z = std::min<uint32>(uint32(nz * 127.5f + 128.f), 255);
+    return Pack(x, y, z, 255);
+  }
+
+  // Scalar reference
+
+  void ExpandColorsScalar(const uint32* palette, uint32 indices, uint32* out)
+  {
+    for (int32 idx = 0; idx < 16; ++idx)
+    {
+      out[idx] = palette[(indices >> (idx * 2)) & 3];
+    }
+  }
+
+  void ExpandAlphaScalar(const uint32* palette, uint64 indices, uint32* out)
+  {
+    for (int32 idx = 0; idx < 16; ++idx)
+    {
+      out[idx] = palette[(indices >> (idx * 3)) & 7];
+    }
+  }
+
+  void MergeAlphaScalar(uint32* pixels, const uint32* alpha)
+  {
+    for (int32 idx = 0; idx < 16; ++idx)
+    {
+      pixels[idx] = (pixels[idx] & 0x00FFFFFF) | (alpha[idx] << 24);
+    }
+  }
+
+  void ConvertG8Scalar(const uint8* src, uint32* out, int32 count)
+  {
+    for (int32 idx = 0; idx < count; ++idx)
+    {
+      out[idx] = Pack(src[idx], src[idx], src[idx], 255);
+    }
+  }
+
+  void ConvertG16Scalar(const uint16* src, uint32* out, int32 count)
+  {
+    for (int32 idx = 0; idx < count; ++idx)
+    {
+      const uint32 v = src[idx] >> 8;
+      out[idx] = Pack(v, v, v, 255);
+    }
+  }
+
+  // SSE2
+
+  inline __m128i SetIndices4(uint32 indices, int32 shift)
+  {
+    return _mm_setr_epi32((indices >> shift) & 3, (indices >> (shift + 2)) & 3, (indices >> (shift + 4)) & 3, (indices >> (shift + 6)) & 3);
+  }
+
+  void ExpandColorsSSE2(const uint32* palette, uint32 indices, uint32* out)
+  {
+    const __m128i p0 = _mm_set1_epi32(palette[0]);
+    const __m128i p1 = _mm_set1_epi32(palette[1]);
+    const __m128i p2 = _mm_set1_epi32(palette[2]);
+    const __m128i p3 = _mm_set1_epi32(palette[3]);
+    for (int32 idx = 0; idx < 16; idx += 4)
+    {
+      const __m128i sel = SetIndices4(indices, idx * 2);
+      __m128i result = _mm_and_si128(_mm_cmpeq_epi32(sel, _mm_setzero_si128()), p0);
+      result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(sel, _mm_set1_epi32(1)), p1));
+      result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(sel, _mm_set1_epi32(2)), p2));
+      result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(sel, _mm_set1_epi32(3)), p3));
+      _mm_storeu_si128((__m128i*)(out + idx), result);
+    }
+  }
+
+  void MergeAlphaSSE2(uint32* pixels, const uint32* alpha)
+  {
+    const __m128i mask = _mm_set1_epi32(0x00FFFFFF);
+    for (int32 idx = 0; idx < 16; idx += 4)
+    {
+      const __m128i p = _mm_loadu_si128((const __m128i*)(pixels + idx));
+      const __m128i a = _mm_loadu_si128((const __m128i*)(alpha + idx));
+      _mm_storeu_si128((__m128i*)(pixels + idx), _mm_or_si128(_mm_and_si128(p, mask), _mm_slli_epi32(a, 24)));
+    }
+  }
+
+  void ConvertG8SSE2(const uint8* src, uint32* out, int32 count)
+  {
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    int32 idx = 0;
+    for (; idx + 16 <= count; idx += 16)
+    {
+      const __m128i g = _mm_loadu_si128((const __m128i*)(src + idx));
+      const __m128i gg0 = _mm_unpacklo_epi8(g, g);
+      const __m128i gg1 = _mm_unpackhi_epi8(g, g);
+      const __m128i ga0 = _mm_unpacklo_epi8(g, alpha);
+      const __m128i ga1 = _mm_unpackhi_epi8(g, alpha);
+      _mm_storeu_si128((__m128i*)(out + idx + 0), _mm_unpacklo_epi16(gg0, ga0));
+      _mm_storeu_si128((__m128i*)(out + idx + 4), _mm_unpackhi_epi16(gg0, ga0));
+      _mm_storeu_si128((__m128i*)(out + idx + 8), _mm_unpacklo_epi16(gg1, ga1));
+      _mm_storeu_si128((__m128i*)(out + idx + 12), _mm_unpackhi_epi16(gg1, ga1));
+    }
+    ConvertG8Scalar(src + idx, out + idx, count - idx);
+  }
+
+  void ConvertG16SSE2(const uint16* src, uint32* out, int32 count)
+  {
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    int32 idx = 0;
+    for (; idx + 8 <= count; idx += 8)
+    {
+      const __m128i v = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(src + idx)), 8);
+      const __m128i g = _mm_packus_epi16(v, v);
+      const __m128i gg = _mm_unpacklo_epi8(g, g);
+      const __m128i ga = _mm_unpacklo_epi8(g, alpha);
+      _mm_storeu_si128((__m128i*)(out + idx + 0), _mm_unpacklo_epi16(gg, ga));
+      _mm_storeu_si128((__m128i*)(out + idx + 4), _mm_unpackhi_epi16(gg, ga));
+    }
+    ConvertG16Scalar(src + idx, out + idx, count - idx);
+  }
+
+  // SSE4.1
+
+  TARGET_SSE41 void ExpandColorsSSE41(const uint32* palette, uint32 indices, uint32* out)
+  {
+    const __m128i p0 = _mm_set1_epi32(palette[0]);
+    const __m128i p1 = _mm_set1_epi32(palette[1]);
+    const __m128i p2 = _mm_set1_epi32(palette[2]);
+    const __m128i p3 = _mm_set1_epi32(palette[3]);
+    for (int32 idx = 0; idx < 16; idx += 4)
+    {
+      const __m128i sel = SetIndices4(indices, idx * 2);
+      // Spread the index bits over whole lanes for the byte blends
+      const __m128i bit0 = _mm_srai_epi32(_mm_slli_epi32(sel, 31), 31);
+      const __m128i bit1 = _mm_srai_epi32(_mm_slli_epi32(sel, 30), 31);
+      const __m128i lo = _mm_blendv_epi8(p0, p1, bit0);
+      const __m128i hi = _mm_blendv_epi8(p2, p3, bit0);
+      _mm_storeu_si128((__m128i*)(out + idx), _mm_blendv_epi8(lo, hi, bit1));
+    }
+  }
+
+  // AVX2
+
+  TARGET_AVX2 void ExpandColorsAVX2(const uint32* palette, uint32 indices, uint32* out)
+  {
+    const __m256i table = _mm256_setr_epi32(palette[0], palette[1], palette[2], palette[3], palette[0], palette[1], palette[2], palette[3]);
+    const __m256i shifts = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i mask = _mm256_set1_epi32(3);
+    const __m256i lo = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(indices), shifts), mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(indices >> 16), shifts), mask);
+    _mm256_storeu_si256((__m256i*)(out + 0), _mm256_permutevar8x32_epi32(table, lo));
+    _mm256_storeu_si256((__m256i*)(out + 8), _mm256_permutevar8x32_epi32(table, hi));
+  }
+
+  TARGET_AVX2 void ExpandAlphaAVX2(const uint32* palette, uint64 indices, uint32* out)
+  {
+    const __m256i table = _mm256_loadu_si256((const __m256i*)palette);
+    const __m256i shifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const __m256i mask = _mm256_set1_epi32(7);
+    const __m256i lo = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(uint32(indices & 0xFFFFFF)), shifts), mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(uint32(indices >> 24)), shifts), mask);
+    _mm256_storeu_si256((__m256i*)(out + 0), _mm256_permutevar8x32_epi32(table, lo));
+    _mm256_storeu_si256((__m256i*)(out + 8), _mm256_permutevar8x32_epi32(table, hi));
+  }
+
+  TARGET_AVX2 void MergeAlphaAVX2(uint32* pixels, const uint32* alpha)
+  {
+    const __m256i mask = _mm256_set1_epi32(0x00FFFFFF);
+    for (int32 idx = 0; idx < 16; idx += 8)
+    {
+      const __m256i p = _mm256_loadu_si256((const __m256i*)(pixels + idx));
+      const __m256i a = _mm256_loadu_si256((const __m256i*)(alpha + idx));
+      _mm256_storeu_si256((__m256i*)(pixels + idx), _mm256_or_si256(_mm256_and_si256(p, mask), _mm256_slli_epi32(a, 24)));
+    }
+  }
+
+  TARGET_AVX2 inline __m256i ExpandGray8(__m256i v)
+  {
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    return _mm256_or_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 8)), _mm256_or_si256(_mm256_slli_epi32(v, 16), alpha));
+  }
+
+  TARGET_AVX2 void ConvertG8AVX2(const uint8* src, uint32* out, int32 count)
+  {
+    int32 idx = 0;
+    for (; idx + 8 <= count; idx += 8)
+    {
+      const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + idx)));
+      _mm256_storeu_si256((__m256i*)(out + idx), ExpandGray8(v));
+    }
+    ConvertG8Scalar(src + idx, out + idx, count - idx);
+  }
+
+  TARGET_AVX2 void ConvertG16AVX2(const uint16* src, uint32* out, int32 count)
+  {
+    int32 idx = 0;
+    for (; idx + 8 <= count; idx += 8)
+    {
+      const __m256i v = _mm256_srli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + idx))), 8);
+      _mm256_storeu_si256((__m256i*)(out + idx), ExpandGray8(v));
+    }
+    ConvertG16Scalar(src + idx, out + idx, count - idx);
+  }
+
+  const KernelTable& GetKernelTable(TextureDecoder::Kernel kernel)
+  {
+    // SSE2 and SSE4.1 have no 8 entry lookup, so alpha indices are expanded by the scalar code
+    static const KernelTable tables[] = {
+      { ExpandColorsScalar, ExpandAlphaScalar, MergeAlphaScalar, ConvertG8Scalar, ConvertG16Scalar },
+      { ExpandColorsSSE2, ExpandAlphaScalar, MergeAlphaSSE2, ConvertG8SSE2, ConvertG16SSE2 },
+      { ExpandColorsSSE41, ExpandAlphaScalar, MergeAlphaSSE2, ConvertG8SSE2, ConvertG16SSE2 },
+      { ExpandColorsAVX2, ExpandAlphaAVX2, MergeAlphaAVX2, ConvertG8AVX2, ConvertG16AVX2 },
+    };
+    return tables[(int32)kernel];
+  }
+
+  inline int32 GetBlockBytes(TextureDecoder::Format format)
+  {
+    return format == TextureDecoder::Format::DXT1 ? 8 : 16;
+  }
+
+  void DecodeBlock(TextureDecoder::Format format, const KernelTable& table, const uint8* block, uint32* out)
+  {
+    alignas(32) uint32 colors[4];
+    alignas(32) uint32 palette[8];
+    alignas(32) uint32 alpha[16];
+    switch (format)
+    {
+    case TextureDecoder::Format::DXT1:
+      BuildColorPalette(block, true, colors);
+      table.ExpandColors(colors, ReadUInt32(block + 4), out);
+      break;
+    case TextureDecoder::Format::DXT3:
+      BuildColorPalette(block + 8, false, colors);
+      table.ExpandColors(colors, ReadUInt32(block + 12), out);
+      for (int32 idx = 0; idx < 16; ++idx)
+      {
+        alpha[idx] = ((block[idx / 2] >> ((idx & 1) * 4)) & 15) * 17;
+      }
+      table.MergeAlpha(out, alpha);
+      break;
+    case TextureDecoder::Format::DXT5:
+      BuildAlphaPalette(block, palette);
+      table.ExpandAlpha(palette, ReadAlphaIndices(block), alpha);
+      BuildColorPalette(block + 8, false, colors);
+      table.ExpandColors(colors, ReadUInt32(block + 12), out);
+      table.MergeAlpha(out, alpha);
+      break;
+    case TextureDecoder::Format::BC5:
+    {
+      alignas(32) uint32 green[16];
+      BuildAlphaPalette(block, palette);
+      table.ExpandAlpha(palette, ReadAlphaIndices(block), alpha);
+      BuildAlphaPalette(block + 8, palette);
+      table.ExpandAlpha(palette, ReadAlphaIndices(block + 8), green);
+      for (int32 idx = 0; idx < 16; ++idx)
+      {
+        out[idx] = PackNormal(alpha[idx], green[idx]);
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  bool HasSSE41()
+  {
+#ifdef _MSC_VER
+    int32 info[4] = {};
+    __cpuid(info, 1);
+    return info[2] & (1 << 19);
+#else
+    uint32 eax = 0, ebx = 0, ecx = 0, edx = 0;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 19));
+#endif
+  }
+}
+
+TextureDecoder::Format TextureDecoder::GetFormat(EPixelFormat format)
+{
+  switch (format)
+  {
+  case PF_DXT1:
+    return Format::DXT1;
+  case PF_DXT3:
+    return Format::DXT3;
+  case PF_DXT5:
+    return Format::DXT5;
+  case PF_BC5:
+    return Format::BC5;
+  case PF_G8:
+    return Format::G8;
+  case PF_G16:
+    return Format::G16;
+  case PF_A8R8G8B8:
+    return Format::A8R8G8B8;
+  default:
+    break;
+  }
+  return Format::Unknown;
+}
+
+TextureDecoder::Kernel TextureDecoder::GetBestKernel()
+{
+  static const Kernel kernel = HasAVX2() ? Kernel::AVX2 : HasSSE41() ? Kernel::SSE41 : Kernel::SSE2;
+  return kernel;
+}
+
+const char* TextureDecoder::GetKernelName(Kernel kernel)
+{
+  switch (kernel)
+  {
+  case Kernel::SSE2:
+    return "SSE2";
+  case Kernel::SSE41:
+    return "SSE4.1";
+  case Kernel::AVX2:
+    return "AVX2";
+  default:
+    break;
+  }
+  return "Scalar";
+}
+
+size_t TextureDecoder::GetEncodedSize(Format format, int32 width, int32 height)
+{
+  if (width <= 0 || height <= 0)
+  {
+    return 0;
+  }
+  switch (format)
+  {
+  case Format::DXT1:
+  case Format::DXT3:
+  case Format::DXT5:
+  case Format::BC5:
+    return size_t((width + 3) / 4) * size_t((height + 3) / 4) * GetBlockBytes(format);
+  case Format::G8:
+    return size_t(width) * height;
+  case Format::G16:
+    return size_t(width) * height * 2;
+  case Format::A8R8G8B8:
+    return size_t(width) * height * 4;
+  default:
+    break;
+  }
+  return 0;
+}
+
+bool TextureDecoder::Decode(Format format, const void* data, size_t size, int32 width, int32 height, uint8* out)
+{
+  return Decode(format, data, size, width, height, out, GetBestKernel());
+}
+
+bool TextureDecoder::Decode(Format format, const void* data, size_t size, int32 width, int32 height, uint8* out, Kernel kernel)
+{
+  const size_t encodedSize = GetEncodedSize(format, width, height);
+  if (!data || !out || !encodedSize || size < encodedSize)
+  {
+    return false;
+  }
+  const KernelTable& table = GetKernelTable(kernel);
+  const uint8* src = (const uint8*)data;
+  uint32* dst = (uint32*)out;
+
+  if (format == Format::A8R8G8B8)
+  {
+    memcpy(out, data, encodedSize);
+    return true;
+  }
+
+  if (format == Format::G8 || format == Format::G16)
+  {
+    std::vector<int32> rows(height);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::for_each(std::execution::par, rows.begin(), rows.end(), [&](int32 y) {
+      if (format == Format::G8)
+      {
+        table.ConvertG8(src + size_t(y) * width, dst + size_t(y) * width, width);
+      }
+      else
+      {
+        table.ConvertG16((const uint16*)src + size_t(y) * width, dst + size_t(y) * width, width);
+      }
+    });
+    return true;
+  }
+
+  const int32 blockBytes = GetBlockBytes(format);
+  const int32 blocksX = (width + 3) / 4;
+  const int32 blocksY = (height + 3) / 4;
+  std::vector<int32> blockRows(blocksY);
+  std::iota(blockRows.begin(), blockRows.end(), 0);
+  std::for_each(std::execution::par, blockRows.begin(), blockRows.end(), [&](int32 by) {
+    alignas(32) uint32 pixels[16];
+    const uint8* block = src + size_t(by) * blocksX * blockBytes;
+    const int32 rows = std::min(4, height - by * 4);
+    for (int32 bx = 0; bx < blocksX; ++bx, block += blockBytes)
+    {
+      DecodeBlock(format, table, block, pixels);
+      // Edge blocks are cropped to the image size
+      const int32 columns = std::min(4, width - bx * 4);
+      for (int32 row = 0; row < rows; ++row)
+      {
+        memcpy(dst + size_t(by * 4 + row) * width + bx * 4, pixels + row * 4, columns * sizeof(uint32));
+      }
+    }
+  });
+  return true;
+}
+
+bool TextureDecoder::SelfCheck(std::string& error)
+{
+  const Format formats[] = { Format::DXT1, Format::DXT3, Format::DXT5, Format::BC5, Format::G8, Format::G16 };
+  std::vector<Kernel> kernels = { Kernel::SSE2 };
+  if (HasSSE41())
+  {
+    kernels.push_back(Kernel::SSE41);
+  }
+  if (HasAVX2())
+  {
+    kernels.push_back(Kernel::AVX2);
+  }
+  // Odd sizes cover cropped edge blocks and the scalar tails of the row converters
+  const int32 sizes[][2] = { { 64, 64 }, { 61, 37 } };
+  uint32 seed = 0x9E3779B9;
+  for (Format format : formats)
+  {
+    for (const auto& size : sizes)
+    {
+      const int32 width = size[0];
+      const int32 height = size[1];
+      std::vector<uint8> data(GetEncodedSize(format, width, height));
+      for (uint8& v : data)
+      {
+        seed = seed * 1664525 + 1013904223;
+        v = uint8(seed >> 24);
+      }
+      if (format == Format::DXT1 && data.size() >= 16)
+      {
+        // Make sure both DXT1 modes are present: c0 > c1 and c0 <= c1
+        data[0] = 0xFF; data[1] = 0xFF; data[2] = 0x00; data[3] = 0x00;
+        data[8] = 0x00; data[9] = 0x00; data[10] = 0xFF; data[11] = 0xFF;
+      }
+      std::vector<uint8> expected(size_t(width) * height * 4);
+      std::vector<uint8> actual(expected.size());
+      Decode(format, data.data(), data.size(), width, height, expected.data(), Kernel::Scalar);
+      for (Kernel kernel : kernels)
+      {
+        std::fill(actual.begin(), actual.end(), uint8(0));
+        Decode(format, data.data(), data.size(), width, height, actual.data(), kernel);
+        auto mismatch = std::mismatch(expected.begin(), expected.end(), actual.begin());
+        if (mismatch.first != expected.end())
+        {
+          static const char* formatNames[] = { "Unknown", "DXT1", "DXT3", "DXT5", "BC5", "G8", "G16", "A8R8G8B8" };
+          const size_t pixel = (mismatch.first - expected.begin()) / 4;
+          error = std::string(formatNames[(int32)format]) + " " + GetKernelName(kernel) + " kernel differs from the scalar kernel at pixel " + std::to_string(pixel) + " of a " + std::to_string(width) + "x" + std::to_string(height) + " image";
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <Tera/Core.h>
+#include <Tera/UTexture.h>
+
+#include <string>
+
+// CPU decoders of block compressed and integer pixel formats into 8-bit BGRA.
+// The kernel is picked once by the CPU features: AVX2, SSE4.1 or SSE2. Block palettes are built by
+// shared scalar code and kernels only differ in how they expand indices, so every kernel must match
+// the scalar reference bit for bit.
+class TextureDecoder {
+public:
+  enum class Format : uint8 {
+    Unknown = 0,
+    DXT1,
+    DXT3,
+    DXT5,
+    // Two channel normal map block(ATI2/3Dc). Z is reconstructed into the blue channel.
+    BC5,
+    G8,
+    G16,
+    A8R8G8B8
+  };
+
+  enum class Kernel : uint8 {
+    Scalar = 0,
+    SSE2,
+    SSE41,
+    AVX2
+  };
+
+  // Returns Format::Unknown if the pixel format can't be decoded
+  static Format GetFormat(EPixelFormat format);
+
+  // The fastest kernel supported by the CPU
+  static Kernel GetBestKernel();
+  static const char* GetKernelName(Kernel kernel);
+
+  // Size of the encoded data of a width x height image
+  static size_t GetEncodedSize(Format format, int32 width, int32 height);
+
+  // Decode a width x height image into out, which must hold width * height * 4 bytes.
+  // Rows are decoded in parallel. Returns false if the format is unknown or the input is too small.
+  static bool Decode(Format format, const void* data, size_t size, int32 width, int32 height, uint8* out);
+  static bool Decode(Format format, const void* data, size_t size, int32 width, int32 height, uint8* out, Kernel kernel);
+
+  // Decode generated data of every format with every kernel the CPU supports and compare the output
+  // with the scalar kernel. Returns false and describes the first mismatch.
+  static bool SelfCheck(std::string& error);
+};
@@ -0,0 +1,177 @@
+#include "TextureFormats.h"
+#include "TextureDecoder.h"
+
+#include <wx/string.h>
+#include <osg/Texture>
+
+#include <algorithm>
+#include <execution>
+#include <mutex>
+
+namespace
+{
+  struct FormatEntry {
+    EPixelFormat PixelFormat;
+    TextureProcessor::TCFormat Format;
+    TextureProcessor::TCFormat DdsFormat;
+    uint32 GLInternalFormat;
+    uint32 GLSrgbInternalFormat;
+    uint32 GLPixelFormat;
+  };
+
+  const FormatEntry FormatTable[] = {
+    { PF_DXT1, TextureProcessor::TCFormat::DXT1, TextureProcessor::TCFormat::DXT, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT },
+    { PF_DXT3, TextureProcessor::TCFormat::DXT3, TextureProcessor::TCFormat::DXT, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT },
+    { PF_DXT5, TextureProcessor::TCFormat::DXT5, TextureProcessor::TCFormat::DXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT },
+    { PF_A8R8G8B8, TextureProcessor::TCFormat::ARGB8, TextureProcessor::TCFormat::ARGB8, GL_RGBA, GL_SRGB8_ALPHA8_EXT, GL_BGRA },
+    { PF_G8, TextureProcessor::TCFormat::G8, TextureProcessor::TCFormat::G8, GL_LUMINANCE, GL_SLUMINANCE8_EXT, GL_LUMINANCE },
+  };
+
+  const FormatEntry* FindFormat(EPixelFormat format)
+  {
+    for (const FormatEntry& entry : FormatTable)
+    {
+      if (entry.PixelFormat == format)
+      {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+}
+
+TextureProcessor::TCFormat TextureFormats::GetProcessorFormat(EPixelFormat format)
+{
+  const FormatEntry* entry = FindFormat(format);
+  return entry ? entry->Format : TextureProcessor::TCFormat::None;
+}
+
+TextureProcessor::TCFormat TextureFormats::GetProcessorDdsFormat(EPixelFormat format)
+{
+  const FormatEntry* entry = FindFormat(format);
+  return entry ? entry->DdsFormat : TextureProcessor::TCFormat::None;
+}
+
+bool TextureFormats::GetGLFormat(EPixelFormat format, bool srgb, uint32& internalFormat, uint32& pixelFormat)
+{
+  const FormatEntry* entry = FindFormat(format);
+  if (!entry)
+  {
+    return false;
+  }
+  internalFormat = srgb ? entry->GLSrgbInternalFormat : entry->GLInternalFormat;
+  pixelFormat = entry->GLPixelFormat;
+  return true;
+}
+
+FTexture2DMipMap* TextureFormats::GetTopMip(UTexture2D* texture)
+{
+  if (!texture)
+  {
+    return nullptr;
+  }
+  for (FTexture2DMipMap* mipmap : texture->Mips)
+  {
+    if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
+    {
+      return mipmap;
+    }
+  }
+  return nullptr;
+}
+
+TextureCubeInput::TextureCubeInput(UTextureCube* cube)
+{
+  if (!cube)
+  {
+    Error = "Failed to load the cube!";
+    return;
+  }
+
+  const std::string cubePath = cube->GetObjectPath().UTF8();
+  std::array<UTexture2D*, 6> faces = cube->GetFaces();
+  for (int32 faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+  {
+    UTexture2D* face = faces[faceIdx];
+    if (!face)
+    {
+      Error = wxString::Format("Failed to export texture cube %s. Can't get one of the faces.", cubePath.c_str()).ToStdString();
+      return;
+    }
+    const std::string faceName = face->GetObjectNameString().UTF8();
+    if (TextureDecoder::GetFormat(face->Format) == TextureDecoder::Format::Unknown)
+    {
+      Error = wxString::Format("Failed to export texture cube %s.%s. Invalid face format!", cubePath.c_str(), faceName.c_str()).ToStdString();
+      return;
+    }
+    if (faceIdx && face->Format != Format)
+    {
+      Error = wxString::Format("Failed to export texture cube %s.%s. Faces have different format!", cubePath.c_str(), faceName.c_str()).ToStdString();
+      return;
+    }
+    FTexture2DMipMap* mip = TextureFormats::GetTopMip(face);
+    if (!mip)
+    {
+      Error = wxString::Format("Failed to export texture cube face %s.%s. No mipmaps!", cubePath.c_str(), faceName.c_str()).ToStdString();
+      return;
+    }
+    if (faceIdx && (mip->SizeX != SizeX || mip->SizeY != SizeY))
+    {
+      Error = wxString::Format("Failed to export texture cube %s.%s. Faces have different size!", cubePath.c_str(), faceName.c_str()).ToStdString();
+      return;
+    }
+    Format = face->Format;
+    SizeX = mip->SizeX;
+    SizeY = mip->SizeY;
+    Faces[faceIdx].Texture = face;
+    Faces[faceIdx].Mip = mip;
+  }
+}
+
+uint64 TextureCubeInput::GetDecodedSize() const
+{
+  return uint64(SizeX) * SizeY * 4 * Faces.size();
+}
+
+bool TextureCubeInput::Decode(TextureProcessor::TCFormat outputFormat)
+{
+  if (!IsValid())
+  {
+    return false;
+  }
+  if (Decoded || !NeedsDecoding(outputFormat))
+  {
+    return true;
+  }
+
+  const TextureDecoder::Format format = TextureDecoder::GetFormat(Format);
+  std::mutex errorMutex;
+  std::for_each(std::execution::par, Faces.begin(), Faces.end(), [&](Face& face) {
+    face.Pixels.resize(size_t(SizeX) * SizeY * 4);
+    if (!TextureDecoder::Decode(format, face.Mip->Data->GetAllocation(), face.Mip->Data->GetBulkDataSize(), SizeX, SizeY, face.Pixels.data()))
+    {
+      std::scoped_lock<std::mutex> l(errorMutex);
+      Error = wxString::Format("Failed to decode texture cube face %s. Not enough data!", face.Texture->GetObjectNameString().UTF8().c_str()).ToStdString();
+    }
+  });
+  Decoded = IsValid();
+  return Decoded;
+}
+
+void TextureCubeInput::SetProcessorInput(TextureProcessor& processor)
+{
+  // Decode must run first if the processor can't read the raw faces
+  DBreakIf(!Decoded && TextureFormats::GetProcessorFormat(Format) == TextureProcessor::TCFormat::None);
+  for (int32 faceIdx = 0; faceIdx < Faces.size(); ++faceIdx)
+  {
+    Face& face = Faces[faceIdx];
+    if (Decoded)
+    {
+      processor.SetInputCubeFace(faceIdx, face.Pixels.data(), face.Pixels.size(), SizeX, SizeY);
+    }
+    else
+    {
+      processor.SetInputCubeFace(faceIdx, face.Mip->Data->GetAllocation(), face.Mip->Data->GetBulkDataSize(), SizeX, SizeY);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <Tera/Core.h>
+#include <Tera/UTexture.h>
+#include <Tera/Utils/TextureUtils.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Pixel format lookups shared by texture importers and exporters
+class TextureFormats {
+public:
+  // Processor format of raw pixel data. Returns TCFormat::None if the processor can't read the format.
+  static TextureProcessor::TCFormat GetProcessorFormat(EPixelFormat format);
+
+  // Processor format of a DDS file. DXT variants share a single format.
+  static TextureProcessor::TCFormat GetProcessorDdsFormat(EPixelFormat format);
+
+  // GL internal and pixel formats of raw pixel data. SRGB selects the sRGB internal format.
+  // Returns false if GL can't read the format.
+  static bool GetGLFormat(EPixelFormat format, bool srgb, uint32& internalFormat, uint32& pixelFormat);
+
+  // The largest mip with loaded data or nullptr
+  static FTexture2DMipMap* GetTopMip(UTexture2D* texture);
+};
+
+// Faces of a texture cube ready for a TextureProcessor. Faces are validated in a single pass. DDS output gets
+// the faces raw if the processor can read their format, so DXT cubes stay DXT. Faces for other outputs and
+// formats are decoded to A8R8G8B8 concurrently.
+class TextureCubeInput {
+public:
+  // Validate faces: every face must have a loaded mip and all faces must share the format and the size
+  TextureCubeInput(UTextureCube* cube);
+
+  inline bool IsValid() const
+  {
+    return Error.empty();
+  }
+
+  inline const std::string& GetError() const
+  {
+    return Error;
+  }
+
+  // Faces are passed raw only to DDS output in a format the processor can read
+  inline bool NeedsDecoding(TextureProcessor::TCFormat outputFormat) const
+  {
+    return outputFormat != TextureProcessor::TCFormat::DDS || TextureFormats::GetProcessorFormat(Format) == TextureProcessor::TCFormat::None;
+  }
+
+  // Size of the faces as A8R8G8B8 in bytes
+  uint64 GetDecodedSize() const;
+
+  // Decode faces if the output format needs it. Returns false and sets the error on failure.
+  bool Decode(TextureProcessor::TCFormat outputFormat);
+
+  // Input format of the processor for the faces
+  inline TextureProcessor::TCFormat GetProcessorFormat() const
+  {
+    return Decoded ? TextureProcessor::TCFormat::ARGB8 : TextureFormats::GetProcessorFormat(Format);
+  }
+
+  // Pass the faces to the processor. The input must outlive the processor.
+  void SetProcessorInput(TextureProcessor& processor);
+
+private:
+  struct Face {
+    UTexture2D* Texture = nullptr;
+    FTexture2DMipMap* Mip = nullptr;
+    // Empty if the mip is passed through
+    std::vector<uint8> Pixels;
+  };
+
+  std::array<Face, 6> Faces;
+  EPixelFormat Format = PF_Unknown;
+  int32 SizeX = 0;
+  int32 SizeY = 0;
+  bool Decoded = false;
+  std::string Error;
+};
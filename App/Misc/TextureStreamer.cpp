@@ -0,0 +1,200 @@
+#include "TextureStreamer.h"
+#include "TextureCache.h"
+
+#include <osgUtil/CullVisitor>
+
+#include <Tera/UTexture.h>
+
+#include <algorithm>
+
+void TextureStreamer::CullCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+  if (osgUtil::CullVisitor* cv = dynamic_cast<osgUtil::CullVisitor*>(nv))
+  {
+    // The bound is local, the cull visitor projects it with the model view of this instance
+    const float pixelSize = cv->clampedPixelSize(node->getBound()) * 2.f;
+    for (UTexture2D* texture : Textures)
+    {
+      Streamer->Request(texture, pixelSize);
+    }
+  }
+  traverse(node, nv);
+}
+
+void TextureStreamer::UpdateCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+  Streamer->Update();
+  traverse(node, nv);
+}
+
+TextureStreamer::TextureStreamer()
+{
+  Worker = std::thread(&TextureStreamer::WorkerMain, this);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+  Stop();
+}
+
+bool TextureStreamer::Add(osg::StateSet* stateSet, UTexture2D* texture)
+{
+  if (!stateSet || !texture)
+  {
+    return false;
+  }
+  osg::ref_ptr<osg::Texture2D> initial = TextureCache::Get().GetTexture(texture, InitialSize);
+  if (!initial)
+  {
+    return false;
+  }
+
+  std::scoped_lock<std::mutex> l(Mutex);
+  auto it = Entries.find(texture);
+  if (it == Entries.end())
+  {
+    it = Entries.emplace(texture, Entry()).first;
+    Entry& entry = it->second;
+    for (FTexture2DMipMap* mip : texture->Mips)
+    {
+      if (mip && mip->SizeX && mip->SizeY)
+      {
+        entry.MipSizes.push_back(std::max(mip->SizeX, mip->SizeY));
+      }
+    }
+    entry.CurrentSize = InitialSize;
+    entry.Current = initial;
+  }
+  Entry& entry = it->second;
+  // Mips are swapped by the update traversal while the scene is rendered
+  stateSet->setDataVariance(osg::Object::DYNAMIC);
+  stateSet->setTextureAttributeAndModes(0, entry.Current);
+  entry.StateSets.emplace_back(stateSet);
+  return true;
+}
+
+void TextureStreamer::Request(UTexture2D* texture, float pixelSize)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  auto it = Entries.find(texture);
+  if (it == Entries.end())
+  {
+    return;
+  }
+  Entry& entry = it->second;
+  const int32 size = SelectMip(entry.MipSizes, pixelSize);
+  if (size <= std::max(entry.CurrentSize, entry.RequestedSize))
+  {
+    if (size == entry.RequestedSize)
+    {
+      // Already queued. Bump the priority if the texture got bigger on screen.
+      auto queued = Queue.find(texture);
+      if (queued != Queue.end() && queued->second.second < pixelSize)
+      {
+        queued->second.second = pixelSize;
+      }
+    }
+    return;
+  }
+  entry.RequestedSize = size;
+  Queue[texture] = { size, pixelSize };
+  QueueCondition.notify_one();
+}
+
+void TextureStreamer::Update()
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  for (Result& result : Results)
+  {
+    auto it = Entries.find(result.Texture);
+    if (it == Entries.end() || result.Size <= it->second.CurrentSize)
+    {
+      continue;
+    }
+    Entry& entry = it->second;
+    entry.CurrentSize = result.Size;
+    entry.Current = result.Data;
+    for (osg::ref_ptr<osg::StateSet>& stateSet : entry.StateSets)
+    {
+      stateSet->setTextureAttributeAndModes(0, entry.Current);
+    }
+  }
+  Results.clear();
+}
+
+bool TextureStreamer::HasPendingUpdates() const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  return Results.size();
+}
+
+void TextureStreamer::Stop()
+{
+  {
+    std::scoped_lock<std::mutex> l(Mutex);
+    Stopped = true;
+    Queue.clear();
+  }
+  QueueCondition.notify_all();
+  if (Worker.joinable())
+  {
+    Worker.join();
+  }
+}
+
+void TextureStreamer::WorkerMain()
+{
+  while (true)
+  {
+    UTexture2D* texture = nullptr;
+    int32 size = 0;
+    {
+      std::unique_lock<std::mutex> l(Mutex);
+      QueueCondition.wait(l, [this] { return Stopped || Queue.size(); });
+      if (Stopped)
+      {
+        return;
+      }
+      // Nearest or biggest on screen first
+      auto next = std::max_element(Queue.begin(), Queue.end(), [](const auto& a, const auto& b) {
+        return a.second.second < b.second.second;
+      });
+      texture = next->first;
+      size = next->second.first;
+      Queue.erase(next);
+    }
+
+    osg::ref_ptr<osg::Texture2D> data = TextureCache::Get().GetTexture(texture, size);
+    std::scoped_lock<std::mutex> l(Mutex);
+    if (!data)
+    {
+      // Let the next Request queue the mip again
+      auto it = Entries.find(texture);
+      if (it != Entries.end() && it->second.RequestedSize == size)
+      {
+        it->second.RequestedSize = it->second.CurrentSize;
+      }
+      continue;
+    }
+    Results.push_back({ texture, size, data });
+  }
+}
+
+int32 TextureStreamer::SelectMip(const std::vector<int32>& mipSizes, float pixelSize)
+{
+  if (mipSizes.empty())
+  {
+    return 0;
+  }
+  // Smallest mip that covers the projected size. Sizes are sorted from the biggest.
+  int32 result = mipSizes.front();
+  for (int32 size : mipSizes)
+  {
+    if (size < pixelSize)
+    {
+      break;
+    }
+    result = size;
+  }
+  return result;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <Tera/Core.h>
+
+#include <osg/NodeCallback>
+#include <osg/StateSet>
+#include <osg/Texture2D>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class UTexture2D;
+
+// Progressive texture loading for 3D viewers. State sets start with a small mip. The cull traversal
+// reports the projected size of the nodes that use a texture and a worker thread decodes bigger
+// mips from UTexture2D::Mips, the biggest on-screen textures first. Mips only grow. The worker gets
+// textures from TextureCache, which decodes one bitmap at a time and hands out images that own a
+// copy of the pixels, so nothing it applies aliases memory of the texture objects.
+class TextureStreamer : public osg::Referenced {
+public:
+  // Size of the mip used until the texture gets on screen
+  static const int32 InitialSize = 64;
+
+  // Reports projected sizes of a node to the streamer. Attach as a cull callback.
+  class CullCallback : public osg::NodeCallback {
+  public:
+    CullCallback(TextureStreamer* streamer, const std::vector<UTexture2D*>& textures)
+      : Streamer(streamer)
+      , Textures(textures)
+    {}
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
+  private:
+    osg::ref_ptr<TextureStreamer> Streamer;
+    std::vector<UTexture2D*> Textures;
+  };
+
+  // Applies decoded mips. Attach as an update callback to the scene root.
+  class UpdateCallback : public osg::NodeCallback {
+  public:
+    UpdateCallback(TextureStreamer* streamer)
+      : Streamer(streamer)
+    {}
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
+  private:
+    osg::ref_ptr<TextureStreamer> Streamer;
+  };
+
+  TextureStreamer();
+
+  // Bind the texture to the state set with the initial mip. Thread safe.
+  // Returns false if the texture can't be decoded.
+  bool Add(osg::StateSet* stateSet, UTexture2D* texture);
+
+  // Request a mip that fits the projected size in pixels. Thread safe.
+  void Request(UTexture2D* texture, float pixelSize);
+
+  // Apply decoded mips to the state sets. Call from the update traversal.
+  void Update();
+
+  // Returns true if decoded mips wait for Update. Used to request a redraw.
+  bool HasPendingUpdates() const;
+
+  // Stop the worker. Must be called before the textures are unloaded.
+  void Stop();
+
+protected:
+  ~TextureStreamer() override;
+
+private:
+  struct Entry {
+    std::vector<osg::ref_ptr<osg::StateSet>> StateSets;
+    osg::ref_ptr<osg::Texture2D> Current;
+    // Mip sizes with data, biggest first
+    std::vector<int32> MipSizes;
+    int32 CurrentSize = 0;
+    int32 RequestedSize = 0;
+  };
+
+  struct Result {
+    UTexture2D* Texture = nullptr;
+    int32 Size = 0;
+    osg::ref_ptr<osg::Texture2D> Data;
+  };
+
+  void WorkerMain();
+  static int32 SelectMip(const std::vector<int32>& mipSizes, float pixelSize);
+
+private:
+  std::unordered_map<UTexture2D*, Entry> Entries;
+  // Texture to the requested mip size and its priority(projected size)
+  std::unordered_map<UTexture2D*, std::pair<int32, float>> Queue;
+  std::vector<Result> Results;
+  std::thread Worker;
+  std::condition_variable QueueCondition;
+  mutable std::mutex Mutex;
+  bool Stopped = false;
+};
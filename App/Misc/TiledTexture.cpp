@@ -0,0 +1,368 @@
+#include "TiledTexture.h"
+#include "TextureCache.h"
+#include "TextureFormats.h"
+
+#include <osgUtil/CullVisitor>
+
+#include <Tera/UTexture.h>
+
+#include <algorithm>
+#include <cstring>
+
+void TiledTexture::CullCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+  if (osgUtil::CullVisitor* cv = dynamic_cast<osgUtil::CullVisitor*>(nv))
+  {
+    Owner->Request(TileIdx, cv->clampedPixelSize(node->getBound()));
+  }
+  traverse(node, nv);
+}
+
+void TiledTexture::UpdateCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+  Owner->Update();
+  traverse(node, nv);
+}
+
+bool TiledTexture::IsSupported(UTexture2D* texture)
+{
+  if (!texture)
+  {
+    return false;
+  }
+  switch (texture->Format)
+  {
+  case PF_DXT1:
+  case PF_DXT3:
+  case PF_DXT5:
+  case PF_A8R8G8B8:
+  case PF_G8:
+  case PF_G16:
+  case PF_BC5:
+    break;
+  default:
+    return false;
+  }
+  for (FTexture2DMipMap* mip : texture->Mips)
+  {
+    if (mip && mip->Data && mip->Data->GetAllocation() && mip->SizeX && mip->SizeY)
+    {
+      return std::max(mip->SizeX, mip->SizeY) > TileSize;
+    }
+  }
+  return false;
+}
+
+TiledTexture::TiledTexture(UTexture2D* texture)
+  : Texture(texture)
+{
+  switch (Texture->Format)
+  {
+  case PF_DXT1:
+    BlockSize = 4;
+    BlockBytes = 8;
+    break;
+  case PF_DXT3:
+  case PF_DXT5:
+    BlockSize = 4;
+    BlockBytes = 16;
+    break;
+  case PF_G8:
+    BlockSize = 1;
+    BlockBytes = 1;
+    break;
+  case PF_G16:
+    BlockSize = 1;
+    BlockBytes = 2;
+    DecodeFormat = TextureDecoder::Format::G16;
+    break;
+  case PF_BC5:
+    BlockSize = 4;
+    BlockBytes = 16;
+    DecodeFormat = TextureDecoder::Format::BC5;
+    break;
+  default:
+    BlockSize = 1;
+    BlockBytes = 4;
+    break;
+  }
+  // Same GL formats as the cached preview. Decoded tiles are BGRA.
+  uint32 internalFormat = GL_RGBA;
+  uint32 pixelFormat = GL_BGRA;
+  TextureFormats::GetGLFormat(DecodeFormat == TextureDecoder::Format::Unknown ? Texture->Format : PF_A8R8G8B8, Texture->SRGB, internalFormat, pixelFormat);
+  InternalFormat = internalFormat;
+  PixelFormat = pixelFormat;
+
+  // Mips are expected to halve. Stop at the first gap or a mip that can't be cut into tiles.
+  for (FTexture2DMipMap* mip : Texture->Mips)
+  {
+    if (!mip || !mip->Data || !mip->Data->GetAllocation() || !mip->SizeX || !mip->SizeY)
+    {
+      if (Mips.size())
+      {
+        break;
+      }
+      continue;
+    }
+    if (Mips.size() && (TileSize >> Mips.size()) < BlockSize)
+    {
+      break;
+    }
+    Mips.push_back({ (const uint8*)mip->Data->GetAllocation(), mip->SizeX, mip->SizeY });
+  }
+
+  Preview = TextureCache::Get().GetTexture(Texture, PreviewSize);
+
+  const int32 workerCount = std::clamp<int32>((int32)std::thread::hardware_concurrency() - 1, 1, 4);
+  for (int32 idx = 0; idx < workerCount; ++idx)
+  {
+    Workers.emplace_back(&TiledTexture::WorkerMain, this);
+  }
+}
+
+TiledTexture::~TiledTexture()
+{
+  Stop();
+}
+
+osg::ref_ptr<osg::Geode> TiledTexture::CreateNode(float width, float height)
+{
+  osg::ref_ptr<osg::Geode> root = new osg::Geode;
+  if (Mips.empty())
+  {
+    return root;
+  }
+  const int32 sizeX = Mips.front().SizeX;
+  const int32 sizeY = Mips.front().SizeY;
+
+  osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+  normals->push_back(osg::Vec3(0.0f, -1.0f, 0.0f));
+  osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array;
+  colors->push_back(osg::Vec4(1.0f, 1.0f, 1.0f, 1.0f));
+
+  std::scoped_lock<std::mutex> l(Mutex);
+  Tiles.clear();
+  for (int32 y = 0; y < sizeY; y += TileSize)
+  {
+    for (int32 x = 0; x < sizeX; x += TileSize)
+    {
+      Tile tile;
+      tile.X = x;
+      tile.Y = y;
+      tile.Width = std::min(TileSize, sizeX - x);
+      tile.Height = std::min(TileSize, sizeY - y);
+
+      // Image rows go from the top of the plane to the bottom
+      const float left = width * (float(x) / sizeX - .5f);
+      const float right = width * (float(x + tile.Width) / sizeX - .5f);
+      const float top = height * (.5f - float(y) / sizeY);
+      const float bottom = height * (.5f - float(y + tile.Height) / sizeY);
+
+      osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+      vertices->push_back(osg::Vec3(left, 0.0f, bottom));
+      vertices->push_back(osg::Vec3(right, 0.0f, bottom));
+      vertices->push_back(osg::Vec3(right, 0.0f, top));
+      vertices->push_back(osg::Vec3(left, 0.0f, top));
+
+      // Part of the preview until the tile gets its own texture
+      const float u0 = float(x) / sizeX;
+      const float u1 = float(x + tile.Width) / sizeX;
+      const float v0 = float(y) / sizeY;
+      const float v1 = float(y + tile.Height) / sizeY;
+      osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array;
+      uvs->push_back(osg::Vec2(u0, v1));
+      uvs->push_back(osg::Vec2(u1, v1));
+      uvs->push_back(osg::Vec2(u1, v0));
+      uvs->push_back(osg::Vec2(u0, v0));
+
+      tile.Geometry = new osg::Geometry;
+      tile.Geometry->setDataVariance(osg::Object::DYNAMIC);
+      tile.Geometry->setVertexArray(vertices);
+      tile.Geometry->setNormalArray(normals);
+      tile.Geometry->setNormalBinding(osg::Geometry::BIND_OVERALL);
+      tile.Geometry->setTexCoordArray(0, uvs);
+      tile.Geometry->setColorArray(colors);
+      tile.Geometry->setColorBinding(osg::Geometry::BIND_OVERALL);
+      tile.Geometry->addPrimitiveSet(new osg::DrawArrays(GL_QUADS, 0, 4));
+      tile.Geometry->getOrCreateStateSet()->setDataVariance(osg::Object::DYNAMIC);
+      if (Preview)
+      {
+        tile.Geometry->getOrCreateStateSet()->setTextureAttributeAndModes(0, Preview);
+      }
+
+      osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+      geode->addDrawable(tile.Geometry);
+      geode->setCullCallback(new CullCallback(this, (int32)Tiles.size()));
+      root->addChild(geode);
+      Tiles.push_back(tile);
+    }
+  }
+  root->setUpdateCallback(new UpdateCallback(this));
+  return root;
+}
+
+void TiledTexture::Request(int32 tileIdx, float pixelSize)
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  if ((size_t)tileIdx >= Tiles.size())
+  {
+    return;
+  }
+  Tile& tile = Tiles[tileIdx];
+  // The bound is a sphere around the tile, so the projected size is close to the diagonal
+  const float tilePixels = pixelSize * .7071f;
+  int32 level = 0;
+  while (size_t(level + 1) < Mips.size() && (TileSize >> (level + 1)) >= tilePixels)
+  {
+    level++;
+  }
+  // A finer mip is never replaced by a coarser one
+  if ((tile.Level >= 0 && tile.Level <= level) || (tile.RequestedLevel >= 0 && tile.RequestedLevel <= level))
+  {
+    return;
+  }
+  tile.RequestedLevel = level;
+  Queue[tileIdx] = { level, pixelSize };
+  QueueCondition.notify_one();
+}
+
+void TiledTexture::Update()
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  for (Result& result : Results)
+  {
+    if ((size_t)result.TileIdx >= Tiles.size())
+    {
+      continue;
+    }
+    Tile& tile = Tiles[result.TileIdx];
+    if (tile.Level >= 0 && tile.Level <= result.Level)
+    {
+      continue;
+    }
+    tile.Level = result.Level;
+    osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array;
+    uvs->push_back(osg::Vec2(0.0f, 1.0f));
+    uvs->push_back(osg::Vec2(1.0f, 1.0f));
+    uvs->push_back(osg::Vec2(1.0f, 0.0f));
+    uvs->push_back(osg::Vec2(0.0f, 0.0f));
+    tile.Geometry->setTexCoordArray(0, uvs);
+    tile.Geometry->getOrCreateStateSet()->setTextureAttributeAndModes(0, result.Texture);
+  }
+  Results.clear();
+}
+
+bool TiledTexture::HasPendingUpdates() const
+{
+  std::scoped_lock<std::mutex> l(Mutex);
+  return Results.size();
+}
+
+void TiledTexture::Stop()
+{
+  {
+    std::scoped_lock<std::mutex> l(Mutex);
+    Stopped = true;
+    Queue.clear();
+  }
+  QueueCondition.notify_all();
+  for (std::thread& worker : Workers)
+  {
+    if (worker.joinable())
+    {
+      worker.join();
+    }
+  }
+  Workers.clear();
+}
+
+osg::ref_ptr<osg::Texture2D> TiledTexture::CreateTileTexture(const Tile& tile, int32 level) const
+{
+  const Mip& mip = Mips[level];
+  const int32 x0 = tile.X >> level;
+  const int32 y0 = tile.Y >> level;
+  const int32 width = std::max(1, std::min(tile.Width >> level, mip.SizeX - x0));
+  const int32 height = std::max(1, std::min(tile.Height >> level, mip.SizeY - y0));
+  if (x0 >= mip.SizeX || y0 >= mip.SizeY)
+  {
+    return nullptr;
+  }
+
+  // Copy whole rows of blocks. Compressed blocks are uploaded as is.
+  const int32 mipPitch = (mip.SizeX + BlockSize - 1) / BlockSize * BlockBytes;
+  const int32 tilePitch = (width + BlockSize - 1) / BlockSize * BlockBytes;
+  const int32 blockRows = (height + BlockSize - 1) / BlockSize;
+  const size_t offsetX = size_t(x0 / BlockSize) * BlockBytes;
+  const size_t offsetY = size_t(y0 / BlockSize);
+  uint8* data = new uint8[size_t(tilePitch) * blockRows];
+  for (int32 row = 0; row < blockRows; ++row)
+  {
+    memcpy(data + size_t(row) * tilePitch, mip.Data + (offsetY + row) * mipPitch + offsetX, tilePitch);
+  }
+
+  osg::ref_ptr<osg::Image> img = new osg::Image;
+  if (DecodeFormat != TextureDecoder::Format::Unknown)
+  {
+    // Formats without a GL equivalent are decoded to BGRA
+    uint8* pixels = new uint8[size_t(width) * height * 4];
+    if (!TextureDecoder::Decode(DecodeFormat, data, size_t(tilePitch) * blockRows, width, height, pixels))
+    {
+      delete[] data;
+      delete[] pixels;
+      return nullptr;
+    }
+    delete[] data;
+    img->setImage(width, height, 1, InternalFormat, PixelFormat, GL_UNSIGNED_BYTE, pixels, osg::Image::AllocationMode::USE_NEW_DELETE);
+  }
+  else
+  {
+    img->setImage(width, height, 1, InternalFormat, PixelFormat, GL_UNSIGNED_BYTE, data, osg::Image::AllocationMode::USE_NEW_DELETE);
+  }
+
+  osg::ref_ptr<osg::Texture2D> result = new osg::Texture2D(img);
+  result->setResizeNonPowerOfTwoHint(false);
+  result->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+  result->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+  result->setWrap(osg::Texture::WrapParameter::WRAP_S, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+  result->setWrap(osg::Texture::WrapParameter::WRAP_T, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+  return result;
+}
+
+void TiledTexture::WorkerMain()
+{
+  while (true)
+  {
+    Tile tile;
+    int32 tileIdx = 0;
+    int32 level = 0;
+    {
+      std::unique_lock<std::mutex> l(Mutex);
+      QueueCondition.wait(l, [this] { return Stopped || Queue.size(); });
+      if (Stopped)
+      {
+        return;
+      }
+      // Biggest on screen first
+      auto next = std::max_element(Queue.begin(), Queue.end(), [](const auto& a, const auto& b) {
+        return a.second.second < b.second.second;
+      });
+      tileIdx = next->first;
+      level = next->second.first;
+      Queue.erase(next);
+      tile = Tiles[tileIdx];
+    }
+
+    osg::ref_ptr<osg::Texture2D> texture = CreateTileTexture(tile, level);
+    std::scoped_lock<std::mutex> l(Mutex);
+    if (!texture)
+    {
+      // Let the next cull traversal request the tile again
+      if ((size_t)tileIdx < Tiles.size() && Tiles[tileIdx].RequestedLevel == level)
+      {
+        Tiles[tileIdx].RequestedLevel = -1;
+      }
+      continue;
+    }
+    Results.push_back({ tileIdx, level, texture });
+  }
+}
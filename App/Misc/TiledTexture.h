@@ -0,0 +1,134 @@
+#pragma once
+#include <Tera/Core.h>
+#include "TextureDecoder.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeCallback>
+#include <osg/Texture2D>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class UTexture2D;
+
+// Texture preview split into square tiles for the texture viewer. Every tile starts with a small
+// cached mip and gets its own texture once it's visible. Tiles are cut from the raw mip data on
+// worker threads, so DXT blocks go to the GPU as is and hidden tiles never touch memory. Formats
+// without a GL equivalent are decoded by TextureDecoder per tile.
+// The mip of a tile is selected by its projected size.
+class TiledTexture : public osg::Referenced {
+public:
+  // Tile size in top mip texels
+  static const int32 TileSize = 512;
+  // Size of the mip shown until a tile is ready
+  static const int32 PreviewSize = 256;
+
+  // Returns true if the texture is too big for a single quad and its format can be tiled
+  static bool IsSupported(UTexture2D* texture);
+
+  TiledTexture(UTexture2D* texture);
+
+  // Size of the top mip in texels
+  inline int32 GetSizeX() const
+  {
+    return Mips.size() ? Mips.front().SizeX : 0;
+  }
+
+  inline int32 GetSizeY() const
+  {
+    return Mips.size() ? Mips.front().SizeY : 0;
+  }
+
+  // Create tiles on the XZ plane centered at the origin
+  osg::ref_ptr<osg::Geode> CreateNode(float width, float height);
+
+  // Apply finished tiles. Call from the update traversal.
+  void Update();
+
+  // Returns true if finished tiles wait for Update. Used to request a redraw.
+  bool HasPendingUpdates() const;
+
+  // Stop the workers. Must be called before the texture is unloaded.
+  void Stop();
+
+protected:
+  ~TiledTexture() override;
+
+private:
+  class CullCallback : public osg::NodeCallback {
+  public:
+    CullCallback(TiledTexture* owner, int32 tileIdx)
+      : Owner(owner)
+      , TileIdx(tileIdx)
+    {}
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
+  private:
+    osg::ref_ptr<TiledTexture> Owner;
+    int32 TileIdx = 0;
+  };
+
+  class UpdateCallback : public osg::NodeCallback {
+  public:
+    UpdateCallback(TiledTexture* owner)
+      : Owner(owner)
+    {}
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
+  private:
+    osg::ref_ptr<TiledTexture> Owner;
+  };
+
+  struct Mip {
+    const uint8* Data = nullptr;
+    int32 SizeX = 0;
+    int32 SizeY = 0;
+  };
+
+  struct Tile {
+    // Rect in top mip texels
+    int32 X = 0;
+    int32 Y = 0;
+    int32 Width = 0;
+    int32 Height = 0;
+    osg::ref_ptr<osg::Geometry> Geometry;
+    // Mip level applied to the tile or -1 if the tile shows the preview
+    int32 Level = -1;
+    int32 RequestedLevel = -1;
+  };
+
+  struct Result {
+    int32 TileIdx = 0;
+    int32 Level = 0;
+    osg::ref_ptr<osg::Texture2D> Texture;
+  };
+
+  void Request(int32 tileIdx, float pixelSize);
+  osg::ref_ptr<osg::Texture2D> CreateTileTexture(const Tile& tile, int32 level) const;
+  void WorkerMain();
+
+private:
+  UTexture2D* Texture = nullptr;
+  std::vector<Mip> Mips;
+  int32 BlockSize = 1;
+  int32 BlockBytes = 4;
+  GLenum InternalFormat = GL_RGBA;
+  GLenum PixelFormat = GL_BGRA;
+  // Set if tiles must be decoded on the CPU
+  TextureDecoder::Format DecodeFormat = TextureDecoder::Format::Unknown;
+  osg::ref_ptr<osg::Texture2D> Preview;
+  std::vector<Tile> Tiles;
+  // Tile index to the requested level and its priority(projected size)
+  std::unordered_map<int32, std::pair<int32, float>> Queue;
+  std::vector<Result> Results;
+  std::vector<std::thread> Workers;
+  std::condition_variable QueueCondition;
+  mutable std::mutex Mutex;
+  bool Stopped = false;
+};
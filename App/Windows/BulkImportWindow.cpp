@@ -4,6 +4,7 @@
 #include "REDialogs.h"
 #include "TextureImporter.h"
 #include "ObjectPicker.h"
+#include "../Misc/ATrace.h"
 
 #include <wx/notebook.h>
 #include <wx/clipbrd.h>
@@ -16,7 +17,6 @@
 #include <Tera/UTexture.h>
 #include <Tera/Cast.h>
 
-#include <Tera/Utils/APerfSamples.h>
 
 enum ObjTreeMenuId {
   ObjectList = wxID_HIGHEST + 1,
@@ -530,7 +530,7 @@ protected:
     const std::string& buffer = ObjectDumpBuffer;
     std::vector<BulkImportAction::Entry> found;
     std::thread([&] {
-      PERF_START(DumpSearch);
+      TRACE_START(DumpSearch);
       size_t bufPos = 0;
       auto GetLine = [&](const std::string& buf, size_t& pos, std::string_view& l)
       {
@@ -598,7 +598,7 @@ protected:
           found.push_back({ objectPath, std::string(&line[pos + 1], end - pos - 1), objIndex, true });
         }
       }
-      PERF_END(DumpSearch);
+      TRACE_END(DumpSearch);
       SendEvent(&progress, UPDATE_PROGRESS_FINISH);
     }).detach();
     progress.ShowModal();
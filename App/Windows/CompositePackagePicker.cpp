@@ -1,7 +1,6 @@
 #include "CompositePackagePicker.h"
 #include "../App.h"
 
-#include <Tera/FPackage.h>
 
 DEFINE_EVENT_TYPE(FINISHED_POPULATING);
 
@@ -35,16 +34,11 @@ CompositePackagePicker::CompositePackagePicker(wxWindow* parent, const wxString&
   CompositeName = new wxTextCtrl(m_panel1, ControlElementId::TextField, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
   if (FilePackages)
   {
-    wxArrayString complete;
-    for (const auto& name : FPackage::FilePackageNames)
-    {
-      complete.push_back(name.WString());
-    }
-    CompositeName->AutoComplete(complete);
+    CompositeName->AutoComplete(new PackageNameCompleter(App::GetSharedApp()->GetFilePackageNames()));
   }
   else
   {
-    CompositeName->AutoComplete(App::GetSharedApp()->GetCompositePackageNames());
+    CompositeName->AutoComplete(new PackageNameCompleter(App::GetSharedApp()->GetCompositePackageNames()));
   }
   bSizer2->Add(CompositeName, 1, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(5));
 
@@ -90,7 +84,7 @@ void CompositePackagePicker::OnText(wxCommandEvent&)
   }
   else
   {
-    OpenButton->Enable(((App*)wxTheApp)->GetCompositePackageNames().Index(CompositeName->GetValue(), false) != wxNOT_FOUND);
+    OpenButton->Enable(((App*)wxTheApp)->GetCompositePackageNames()->Contains(CompositeName->GetValue()));
   }
 }
 
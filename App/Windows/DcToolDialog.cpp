@@ -11,6 +11,7 @@
 
 #include "../App.h"
 #include "../Misc/AConfiguration.h"
+#include "../Misc/ATrace.h"
 #include "ProgressWindow.h"
 #include "REDialogs.h"
 
@@ -19,7 +20,6 @@
 #include <Tera/FPackage.h>
 
 #include <Tera/Utils/DCKeyTool.h>
-#include <Tera/Utils/APerfSamples.h>
 
 #include <execution>
 #include <filesystem>
@@ -374,6 +374,7 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
     std::vector<byte> inputData(inputLen);
     in.seekg(0, 0);
     in.read((char*)inputData.data(), inputLen);
+    TRACE_BYTES_READ(inputLen);
 
     std::vector<unsigned char> rawkey;
     std::vector<unsigned char> rawvec;
@@ -403,9 +404,9 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
     {
       CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption tmp;
       tmp.SetKeyWithIV(rawkey.data(), rawkey.size(), rawvec.data());
-      PERF_START(DecryptDC);
+      TRACE_START(DecryptDC);
       CryptoPP::VectorSource ss(inputData, true, new CryptoPP::StreamTransformationFilter(tmp, new CryptoPP::VectorSink(outData)));
-      PERF_END(DecryptDC);
+      TRACE_END(DecryptDC);
       inputData.clear();
       if (outData[4] != 0x78 && outData[5] != 0x9C)
       {
@@ -438,9 +439,10 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
       try
       {
         wxZlibInputStream zis(wxis);
-        PERF_START(UncompressDC);
+        TRACE_START(UncompressDC);
         zis.ReadAll(inflatedDc.data(), uncompressedSize);
-        PERF_END(UncompressDC);
+        TRACE_END(UncompressDC);
+        TRACE_BYTES_DECOMPRESSED(uncompressedSize);
         outData.clear();
       }
       catch (...)
@@ -454,25 +456,27 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
 
     if (inflatedDc.empty())
     {
-      SendEvent(&progress, UPDATE_PROGRESS_DESC, wxS("Saving..."));
+      progress.GetReporter().SetActionText(wxS("Saving..."));
       std::ofstream out(dst, std::ios::out | std::ios::binary);
       out.write((const char*)outData.data(), outData.size());
+      TRACE_BYTES_WRITTEN(outData.size());
       SendEvent(&progress, UPDATE_PROGRESS_FINISH, true);
       return;
     }
     if (!Mode->GetSelection())
     {
-      SendEvent(&progress, UPDATE_PROGRESS_DESC, wxS("Saving..."));
+      progress.GetReporter().SetActionText(wxS("Saving..."));
       std::ofstream out(dst, std::ios::out | std::ios::binary);
       out.write((const char*)inflatedDc.data(), uncompressedSize);
+      TRACE_BYTES_WRITTEN(uncompressedSize);
       SendEvent(&progress, UPDATE_PROGRESS_FINISH, true);
       return;
     }
 
-    SendEvent(&progress, UPDATE_PROGRESS_DESC, wxS("Serializing..."));
+    progress.GetReporter().SetActionText(wxS("Serializing..."));
 
     MReadStream s(inflatedDc.data(), false, inflatedDc.size());
-    PERF_START(SerializeDC);
+    TRACE_START(SerializeDC);
 #if USE_STATIC_DC_4_EXPORT
     std::unique_ptr<S1Data::DCInterface> dc = std::make_unique<S1Data::StaticDataCenter>();
 #else
@@ -502,9 +506,9 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
 #if !USE_STATIC_DC_4_EXPORT
     inflatedDc.clear();
 #endif
-    PERF_END(SerializeDC);
+    TRACE_END(SerializeDC);
 
-    SendEvent(&progress, UPDATE_PROGRESS_DESC, wxS("Saving..."));
+    progress.GetReporter().SetActionText(wxS("Saving..."));
 
     dst /= (std::filesystem::path(wstr).filename().replace_extension().wstring() + L'_' + std::to_wstring(dc->GetHeader()->Version));
 
@@ -551,10 +555,10 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
     std::for_each(std::execution::par_unseq, folders.begin(), folders.end(), [&](const S1Data::DCElement& element) {
       std::filesystem::create_directories(dst / std::wstring(dc->GetName(element.GetName())));
     });
-    SendEvent(&progress, UPDATE_MAX_PROGRESS, total);
-    SendEvent(&progress, UPDATE_PROGRESS, 0);
+    progress.GetReporter().SetMaxProgress(total);
+    progress.GetReporter().SetCurrentProgress(0);
 
-    PERF_START(ExportDC);
+    TRACE_START(ExportDC);
     S1Data::DCExporter* exporter = nullptr;
     if (Mode->GetSelection() == 1)
     {
@@ -571,7 +575,7 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
       {
         const S1Data::DCElement& element = elements.front();
         exporter->ExportElement(element, dst / std::wstring(dc->GetName(element.GetName())));
-        SendEvent(&progress, UPDATE_PROGRESS_ADV);
+        progress.GetReporter().AdvanceProgress();
       }
       else
       {
@@ -581,12 +585,12 @@ void DcToolDialog::OnUnpackClicked(wxCommandEvent& event)
           if (idx < elements.size() && element.GetName().Index)
           {
             exporter->ExportElement(element, dst / name / (name + L"-" + std::to_wstring(idx + 1)));
-            SendEvent(&progress, UPDATE_PROGRESS_ADV);
+            progress.GetReporter().AdvanceProgress();
           }
         });
       }
     });
-    PERF_END(ExportDC);
+    TRACE_END(ExportDC);
     delete exporter;
     items.clear();
     folders.clear();
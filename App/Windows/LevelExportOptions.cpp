@@ -404,6 +404,12 @@ LevelExportOptionsWindow::LevelExportOptionsWindow(wxWindow* parent, const Level
 
   bSizer14->Add(0, 0, 1, wxEXPAND, FromDIP(5));
 
+  DryRunButton = new wxButton(this, wxID_ANY, wxT("Dry run"), wxDefaultPosition, wxDefaultSize, 0);
+  DryRunButton->SetToolTip(wxT("Estimate the export without saving any assets. Saves a JSON report to the destination folder."));
+  DryRunButton->Enable(false);
+
+  bSizer14->Add(DryRunButton, 0, wxALL | wxALIGN_CENTER_VERTICAL, FromDIP(5));
+
   ExportButton = new wxButton(this, wxID_ANY, wxT("Export"), wxDefaultPosition, wxDefaultSize, 0);
   ExportButton->Enable(false);
 
@@ -443,6 +449,7 @@ LevelExportOptionsWindow::LevelExportOptionsWindow(wxWindow* parent, const Level
 
   PathPicker->Connect(wxEVT_COMMAND_DIRPICKER_CHANGED, wxFileDirPickerEventHandler(LevelExportOptionsWindow::OnDirChanged), NULL, this);
   DefaultsButton->Connect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnDefaultsClicked), NULL, this);
+  DryRunButton->Connect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnDryRunClicked), NULL, this);
   ExportButton->Connect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnExportClicked), NULL, this);
   CancelButton->Connect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnCancelClicked), NULL, this);
   Connect(wxEVT_IDLE, wxIdleEventHandler(LevelExportOptionsWindow::OnFirstIdle), NULL, this);
@@ -455,6 +462,7 @@ LevelExportOptionsWindow::~LevelExportOptionsWindow()
   TurnOffAllButton->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnNoneClicked), NULL, this);
   PathPicker->Disconnect(wxEVT_COMMAND_DIRPICKER_CHANGED, wxFileDirPickerEventHandler(LevelExportOptionsWindow::OnDirChanged), NULL, this);
   DefaultsButton->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnDefaultsClicked), NULL, this);
+  DryRunButton->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnDryRunClicked), NULL, this);
   ExportButton->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnExportClicked), NULL, this);
   CancelButton->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(LevelExportOptionsWindow::OnCancelClicked), NULL, this);
 }
@@ -469,8 +477,7 @@ void LevelExportOptionsWindow::SetExportContext(const LevelExportContext& ctx)
   LightInvSqrt->SetValue(ctx.Config.InvSqrtFalloff);
   DynamicShadows->SetValue(ctx.Config.ForceDynamicShadows);
   ResampleTerrain->SetValue(ctx.Config.ResampleTerrain);
-  SplitTerrainWeightMaps->SetValue(HasAVX2() && ctx.Config.SplitTerrainWeights);
-  SplitTerrainWeightMaps->Enable(HasAVX2());
+  SplitTerrainWeightMaps->SetValue(ctx.Config.SplitTerrainWeights);
   Textures->SetValue(ctx.Config.Textures);
   if (DelayedTextureFormat == -1)
   {
@@ -526,6 +533,7 @@ LevelExportContext LevelExportOptionsWindow::GetExportContext() const
   ctx.Config.GlobalScale = GlobalScaleValue;
   ctx.Config.PointLightMul = PointLightMultiplierValue;
   ctx.Config.SpotLightMul = SpotLightMultiplierValue;
+  ctx.DryRun = DryRun;
 
   return ctx;
 }
@@ -563,6 +571,7 @@ int32 LevelExportOptionsWindow::GetActorsTableMask() const
 void LevelExportOptionsWindow::OnDirChanged(wxFileDirPickerEvent& event)
 {
   ExportButton->Enable(PathPicker->GetPath().size());
+  DryRunButton->Enable(PathPicker->GetPath().size());
 }
 
 void LevelExportOptionsWindow::OnDefaultsClicked(wxCommandEvent& event)
@@ -584,6 +593,17 @@ void LevelExportOptionsWindow::OnExportClicked(wxCommandEvent& event)
   EndModal(wxID_OK);
 }
 
+void LevelExportOptionsWindow::OnDryRunClicked(wxCommandEvent& event)
+{
+  DryRun = true;
+  OnExportClicked(event);
+  if (GetReturnCode() != wxID_OK)
+  {
+    // Validation failed
+    DryRun = false;
+  }
+}
+
 void LevelExportOptionsWindow::OnCancelClicked(wxCommandEvent& event)
 {
   EndModal(wxID_CANCEL);
@@ -4,8 +4,10 @@
 #include <wx/filepicker.h>
 #include "WXDialog.h"
 #include "../Misc/AConfiguration.h"
+#include "../Misc/LevelExportReport.h"
 
 #include <filesystem>
+#include <unordered_set>
 
 #include <Tera/Utils/TextureUtils.h>
 
@@ -158,7 +160,10 @@ struct LevelExportContext {
   std::vector<std::string> ComplexCollisions;
   std::map<std::string, std::vector<std::string>> MLODs;
   std::vector<std::string> TerrainInfo;
-  std::vector<UObject*> Waves;
+  std::unordered_set<UObject*> Waves;
+  // Walk the level and estimate the export without writing any assets
+  bool DryRun = false;
+  LevelExportReport Report;
   int CurrentProgress = 0;
   int StaticMeshActorsCount = 0;
   int SkeletalMeshActorsCount = 0;
@@ -185,6 +190,7 @@ protected:
   void OnDirChanged(wxFileDirPickerEvent& event);
   void OnDefaultsClicked(wxCommandEvent& event);
   void OnExportClicked(wxCommandEvent& event);
+  void OnDryRunClicked(wxCommandEvent& event);
   void OnCancelClicked(wxCommandEvent& event);
   void OnAllClicked(wxCommandEvent&);
   void OnNoneClicked(wxCommandEvent&);
@@ -215,6 +221,7 @@ protected:
   wxCheckBox* ExportLightmapUVs = nullptr;
   wxCheckBox* IgnoreHidden = nullptr;
   wxButton* DefaultsButton = nullptr;
+  wxButton* DryRunButton = nullptr;
   wxButton* ExportButton = nullptr;
   wxButton* CancelButton = nullptr;
 
@@ -222,4 +229,5 @@ protected:
   float PointLightMultiplierValue = 1.;
   float SpotLightMultiplierValue = 1.;
   int32 DelayedTextureFormat = 0;
+  bool DryRun = false;
 };
\ No newline at end of file
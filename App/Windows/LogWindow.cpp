@@ -1,32 +1,107 @@
 #include "../App.h"
 #include "../Misc/AConfiguration.h"
 #include "LogWindow.h"
-#include <wx/richtext/richtextctrl.h>
+#include <wx/listctrl.h>
 
 #include <Tera/Utils/ALog.h>
 
-#define POLL_INTERVAL 1000
-#define MAX_LINES 500
-#define CLEAN_LINES 400
+#define POLL_INTERVAL 250
+// Lines kept by the console. Older lines are overwritten.
+#define MAX_LINES 20000
+
+// Virtual list that asks the window for visible lines only
+class LogListCtrl : public wxListCtrl {
+public:
+  LogListCtrl(LogWindow* owner)
+    : wxListCtrl(owner, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_NO_HEADER | wxLC_SINGLE_SEL | wxNO_BORDER)
+    , Owner(owner)
+  {
+    SetBackgroundColour(wxColour(16, 16, 16));
+    AppendColumn(wxEmptyString);
+    InfoAttr.SetTextColour(wxColour(160, 160, 160));
+    WarnAttr.SetTextColour(wxColour(255, 120, 0));
+    ErrAttr.SetTextColour(wxColour(255, 30, 30));
+    Bind(wxEVT_SIZE, [this](wxSizeEvent& e) {
+      SetColumnWidth(0, GetClientSize().x);
+      e.Skip();
+    });
+  }
+
+  // Returns true if the last line is on the screen
+  bool IsScrolledToEnd() const
+  {
+    return GetItemCount() <= 0 || GetTopItem() + GetCountPerPage() >= GetItemCount();
+  }
+
+protected:
+  wxString OnGetItemText(long item, long column) const override
+  {
+    return Owner->GetLineText(item);
+  }
+
+  wxListItemAttr* OnGetItemAttr(long item) const override
+  {
+    switch (Owner->GetLineChannel(item))
+    {
+    case ALogEntry::Type::ERR:
+      return (wxListItemAttr*)&ErrAttr;
+    case ALogEntry::Type::WARN:
+      return (wxListItemAttr*)&WarnAttr;
+    case ALogEntry::Type::INFO:
+    default:
+      return (wxListItemAttr*)&InfoAttr;
+    }
+  }
+
+private:
+  LogWindow* Owner = nullptr;
+  wxListItemAttr InfoAttr;
+  wxListItemAttr WarnAttr;
+  wxListItemAttr ErrAttr;
+};
 
 LogWindow::LogWindow(const wxPoint& pos, const wxSize& size)
   : wxFrame(nullptr, wxID_ANY, wxTheApp->GetAppDisplayName() + wxT(" ") + GetAppVersion() + wxT(" - Log"), pos, size, wxCAPTION | wxSTAY_ON_TOP | wxCLOSE_BOX | wxFRAME_TOOL_WINDOW | wxTAB_TRAVERSAL)
 {
   DesiredPosition = pos;
+  Lines.resize(MAX_LINES);
   SetSize(FromDIP(GetSize()));
   SetIcon(wxICON(#114));
   SetSizeHints(GetSize(), wxDefaultSize);
 
   wxBoxSizer* bSizer1 = new wxBoxSizer(wxVERTICAL);
-  LogCtrl = new wxRichTextCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxTE_READONLY | wxVSCROLL | wxHSCROLL | wxNO_BORDER | wxWANTS_CHARS);
-  LogCtrl->SetBackgroundColour(wxColour(16, 16, 16));
+  LogCtrl = new LogListCtrl(this);
   bSizer1->Add(LogCtrl, 1, wxEXPAND | wxALL, 0);
 
+  wxBoxSizer* bSizer2 = new wxBoxSizer(wxHORIZONTAL);
+  ShowInfo = new wxCheckBox(this, wxID_ANY, wxT("Info"));
+  ShowInfo->SetValue(true);
+  bSizer2->Add(ShowInfo, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(4));
+
+  ShowWarnings = new wxCheckBox(this, wxID_ANY, wxT("Warnings"));
+  ShowWarnings->SetValue(true);
+  bSizer2->Add(ShowWarnings, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(4));
+
+  ShowErrors = new wxCheckBox(this, wxID_ANY, wxT("Errors"));
+  ShowErrors->SetValue(true);
+  bSizer2->Add(ShowErrors, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(4));
+
+  bSizer2->Add(0, 0, 1, wxEXPAND, 0);
+
+  ThroughputLabel = new wxStaticText(this, wxID_ANY, wxT("0 lines/s"));
+  bSizer2->Add(ThroughputLabel, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(4));
+  bSizer1->Add(bSizer2, 0, wxEXPAND, 0);
+
   SetSizer(bSizer1);
   Layout();
 
   Centre(wxBOTH);
 
+  ShowInfo->Bind(wxEVT_CHECKBOX, &LogWindow::OnFilterChanged, this);
+  ShowWarnings->Bind(wxEVT_CHECKBOX, &LogWindow::OnFilterChanged, this);
+  ShowErrors->Bind(wxEVT_CHECKBOX, &LogWindow::OnFilterChanged, this);
+
+  LastTickTime = wxGetLocalTimeMillis();
   PollTimer.Bind(wxEVT_TIMER, &LogWindow::OnTick, this);
   PollTimer.Start(POLL_INTERVAL);
 }
@@ -45,57 +120,126 @@ void LogWindow::OnCloseWindow(wxCloseEvent& event)
 void LogWindow::PumpMessages()
 {
   std::vector<ALogEntry> entries;
-  if (DisplayedMessages > MAX_LINES)
+  ALog::SharedLog()->GetEntries(entries, LastMessageIndex);
+
+  const wxLongLong now = wxGetLocalTimeMillis();
+  const double elapsed = (now - LastTickTime).ToDouble() / 1000.;
+  if (elapsed > 0.)
   {
-    DisplayedMessages = 0;
-    LogCtrl->Clear();
-    LastMessageIndex -= CLEAN_LINES;
+    ThroughputLabel->SetLabelText(wxString::Format("%.0f lines/s", entries.size() / elapsed));
   }
-  ALog::SharedLog()->GetEntries(entries, LastMessageIndex);
+  LastTickTime = now;
 
   if (entries.empty())
   {
     return;
   }
 
-  LogCtrl->Freeze();
-  LogCtrl->SetInsertionPointEnd();
-  size_t eIdx = 0;
-  if (entries.size() > MAX_LINES)
-  {
-    eIdx = entries.size() - CLEAN_LINES;
-  }
+  // Older entries would be overwritten anyway
+  size_t eIdx = entries.size() > Lines.size() ? entries.size() - Lines.size() : 0;
   for (; eIdx < entries.size(); ++eIdx)
   {
-    DisplayedMessages++;
-    ALogEntry& e = entries[eIdx];
+    const ALogEntry& e = entries[eIdx];
     std::string msg = e.Text;
-    if (msg.back() != '\n')
+    while (msg.size() && (msg.back() == '\n' || msg.back() == '\r'))
     {
-      msg += "\n";
+      msg.pop_back();
     }
     std::tm* tm = std::localtime(&e.Time);
     char buffer[32];
     std::strftime(buffer, 32, "[%H:%M:%S] ", tm);
-    msg = std::string(buffer) + msg;
-    switch (e.Channel)
+    const wxString timestamp(buffer);
+    const bool visible = IsChannelVisible(e.Channel);
+
+    // Multiline messages take a ring line per text line
+    size_t start = 0;
+    while (start <= msg.size())
     {
-    case ALogEntry::Type::ERR:
-      LogCtrl->BeginTextColour(wxColour(255, 30, 30));
-      break;
-    case ALogEntry::Type::WARN:
-      LogCtrl->BeginTextColour(wxColour(255, 120, 0));
-      break;
-    case ALogEntry::Type::INFO:
-    default:
-      LogCtrl->BeginTextColour(wxColour(160, 160, 160));
-      break;
+      size_t end = msg.find('\n', start);
+      if (end == std::string::npos)
+      {
+        end = msg.size();
+      }
+      size_t length = end - start;
+      if (length && msg[end - 1] == '\r')
+      {
+        length--;
+      }
+      Line& line = Lines[TotalLines % Lines.size()];
+      line.Text = timestamp + A2W(msg.substr(start, length));
+      line.Channel = e.Channel;
+      if (visible)
+      {
+        VisibleLines.push_back(TotalLines);
+      }
+      TotalLines++;
+      start = end + 1;
+    }
+  }
+
+  // Drop overwritten lines
+  const uint64 firstLine = TotalLines > Lines.size() ? TotalLines - Lines.size() : 0;
+  while (VisibleLines.size() && VisibleLines.front() < firstLine)
+  {
+    VisibleLines.pop_front();
+  }
+
+  const bool scrollToEnd = LogCtrl->IsScrolledToEnd();
+  LogCtrl->SetItemCount(long(VisibleLines.size()));
+  if (scrollToEnd && VisibleLines.size())
+  {
+    LogCtrl->EnsureVisible(long(VisibleLines.size()) - 1);
+  }
+  LogCtrl->Refresh();
+}
+
+const wxString& LogWindow::GetLineText(size_t idx) const
+{
+  static const wxString empty;
+  return idx < VisibleLines.size() ? Lines[VisibleLines[idx] % Lines.size()].Text : empty;
+}
+
+ALogEntry::Type LogWindow::GetLineChannel(size_t idx) const
+{
+  return idx < VisibleLines.size() ? Lines[VisibleLines[idx] % Lines.size()].Channel : ALogEntry::Type::INFO;
+}
+
+bool LogWindow::IsChannelVisible(ALogEntry::Type channel) const
+{
+  switch (channel)
+  {
+  case ALogEntry::Type::ERR:
+    return ShowErrors->GetValue();
+  case ALogEntry::Type::WARN:
+    return ShowWarnings->GetValue();
+  case ALogEntry::Type::INFO:
+  default:
+    return ShowInfo->GetValue();
+  }
+}
+
+void LogWindow::RebuildVisibleLines()
+{
+  VisibleLines.clear();
+  const uint64 firstLine = TotalLines > Lines.size() ? TotalLines - Lines.size() : 0;
+  for (uint64 lineIdx = firstLine; lineIdx < TotalLines; ++lineIdx)
+  {
+    if (IsChannelVisible(Lines[lineIdx % Lines.size()].Channel))
+    {
+      VisibleLines.push_back(lineIdx);
     }
-    LogCtrl->WriteText(A2W(msg));
-    LogCtrl->EndTextColour();
   }
-  LogCtrl->Thaw();
-  LogCtrl->ScrollIntoView(LogCtrl->GetCaretPosition(), WXK_PAGEDOWN);
+  LogCtrl->SetItemCount(long(VisibleLines.size()));
+  if (VisibleLines.size())
+  {
+    LogCtrl->EnsureVisible(long(VisibleLines.size()) - 1);
+  }
+  LogCtrl->Refresh();
+}
+
+void LogWindow::OnFilterChanged(wxCommandEvent&)
+{
+  RebuildVisibleLines();
 }
 
 void LogWindow::OnTick(wxTimerEvent& e)
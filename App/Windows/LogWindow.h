@@ -1,9 +1,11 @@
 #pragma once
 #include <wx/wx.h>
 #include <atomic>
+#include <deque>
+#include <vector>
 #include <Tera/Utils/ALog.h>
 
-class wxRichTextCtrl;
+class LogListCtrl;
 class LogWindow : public wxFrame
 {
 public:
@@ -15,15 +17,37 @@ public:
 	bool Show(bool show = true) override;
 	bool Destroy() override;
 
+	// Visible line for the list control
+	const wxString& GetLineText(size_t idx) const;
+	ALogEntry::Type GetLineChannel(size_t idx) const;
+
 private:
+	struct Line {
+		wxString Text;
+		ALogEntry::Type Channel = ALogEntry::Type::INFO;
+	};
+
 	void OnTick(wxTimerEvent& e);
+	void OnFilterChanged(wxCommandEvent& e);
+
+	bool IsChannelVisible(ALogEntry::Type channel) const;
+	void RebuildVisibleLines();
 
 	wxDECLARE_EVENT_TABLE();
 
 private:
 	wxPoint DesiredPosition;
-	wxRichTextCtrl* LogCtrl = nullptr;
+	LogListCtrl* LogCtrl = nullptr;
+	wxCheckBox* ShowInfo = nullptr;
+	wxCheckBox* ShowWarnings = nullptr;
+	wxCheckBox* ShowErrors = nullptr;
+	wxStaticText* ThroughputLabel = nullptr;
 	size_t LastMessageIndex = 0;
-	size_t DisplayedMessages = 0;
+	// Ring buffer of formatted lines. Line N lives at Lines[N % Lines.size()].
+	std::vector<Line> Lines;
+	uint64 TotalLines = 0;
+	// Line numbers that pass the channel filter
+	std::deque<uint64> VisibleLines;
+	wxLongLong LastTickTime = 0;
 	wxTimer PollTimer;
-};
\ No newline at end of file
+};
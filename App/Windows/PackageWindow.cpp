@@ -13,6 +13,7 @@
 
 #include "../CustomViews/ArchiveInfo.h"
 #include "../CustomViews/ObjectProperties.h"
+#include "../Misc/TextureCache.h"
 #include "../App.h"
 
 #include <algorithm>
@@ -102,6 +103,8 @@ enum ObjTreeMenuId {
 };
 
 #define MAX_SELECTION_HISTORY 50
+// Delay before a typed search is started
+#define SEARCH_DELAY 150
 #define TARGET_HEARBEAT 60
 #ifdef _DEBUG
 #define HEARTBEAT (1000. / float(TARGET_HEARBEAT + 15))
@@ -117,6 +120,7 @@ wxDEFINE_EVENT(UPDATE_PROPERTIES, wxCommandEvent);
 wxDEFINE_EVENT(OBJECT_CHANGED, wxCommandEvent);
 wxDEFINE_EVENT(OBJECT_ADD, wxCommandEvent);
 wxDEFINE_EVENT(OBJECT_DEL, wxCommandEvent);
+wxDEFINE_EVENT(SEARCH_READY, wxCommandEvent);
 
 const wxString HelpUrl = wxS("https://github.com/VenoMKO/RealEditor/wiki");
 
@@ -211,6 +215,7 @@ PackageWindow::PackageWindow(std::shared_ptr<FPackage>& package)
   PropertiesCtrl->Bind(wxEVT_SIZE, &PackageWindow::OnSize, this);
   SearchField->Connect(wxEVT_COMMAND_SEARCHCTRL_SEARCH_BTN, wxCommandEventHandler(PackageWindow::OnSearchEnter), nullptr, this);
   HeartBeat.Bind(wxEVT_TIMER, &PackageWindow::OnTick, this);
+  SearchTimer.Bind(wxEVT_TIMER, &PackageWindow::OnSearchTimer, this);
   HeartBeat.Start(HEARTBEAT);
   UpdateAccelerators();
 }
@@ -236,6 +241,12 @@ void PackageWindow::OnCloseWindow(wxCloseEvent& event)
 
 PackageWindow::~PackageWindow()
 {
+  CancelSearch();
+  // Cached textures may belong to this package or its dependencies. Keep textures of packages that stay open.
+  TextureCache::Get().Evict([this](FPackage* package) {
+    PackageWindow* owner = App::GetSharedApp()->GetPackageWindow(package);
+    return !owner || owner == this;
+  });
   FPackage::UnloadPackage(Package);
   delete FileHistory;
   delete ImageList;
@@ -961,6 +972,7 @@ void PackageWindow::DebugOnDupSelection(wxCommandEvent&)
     return;
   }
 
+  CancelSearch();
   if (FObjectExport* exp = Package->DuplicateExport(mi->GetExportObject(), mi->GetExportObject()->Outer, name.ToStdWstring()))
   {
     OnExportObjectSelected(exp->ObjectIndex);
@@ -1175,7 +1187,8 @@ void PackageWindow::OnObjectDirty(wxCommandEvent& e)
   }
   SaveMenu->Enable(!Package->IsComposite() && !Package->GetPackageFlag(PKG_NoSource) && !Package->GetPackageFlag(PKG_ROAccess));
   PACKAGE_INDEX id = (PACKAGE_INDEX)e.GetInt();
-  if (ObjectTreeNode* node = DataModel->FindItemByObjectIndex(id))
+  // Nodes that were not created yet will show the new state once they are
+  if (ObjectTreeNode* node = DataModel->FindLoadedItem(id))
   {
     DataModel->ItemChanged(wxDataViewItem(node));
   }
@@ -1188,7 +1201,7 @@ void PackageWindow::OnObjectAdded(wxCommandEvent& e)
   {
     return;
   }
-  if (ObjectTreeNode* node = DataModel->FindItemByObjectIndex(id))
+  if (ObjectTreeNode* node = DataModel->FindLoadedItem(id))
   {
     return;
   }
@@ -1205,6 +1218,10 @@ void PackageWindow::OnObjectAdded(wxCommandEvent& e)
 
 void PackageWindow::OnExportAdded(FObjectExport* obj)
 {
+  // Search workers walk the export tree. Mutations made by this window stop them in advance,
+  // others are caught here. Exports may be added off the UI thread, so the timer is left alone.
+  StopSearchThread();
+  NameIndex.Add(obj);
   SendEvent(this, OBJECT_ADD, obj->ObjectIndex);
 }
 
@@ -1215,6 +1232,8 @@ void PackageWindow::OnImportAdded(FObjectImport* imp)
 
 void PackageWindow::OnExportRemoved(PACKAGE_INDEX index)
 {
+  StopSearchThread();
+  NameIndex.Remove(index);
   ObjectTreeCtrl->RemoveExp(index);
 }
 
@@ -1301,7 +1320,7 @@ void PackageWindow::OnCreateModClicked(wxCommandEvent&)
   progress.SetCurrentProgress(-1);
   progress.SetActionText(wxT("Preparing..."));
   ctx.ProgressDescriptionCallback = [&progress](std::string desc) {
-    SendEvent(&progress, UPDATE_PROGRESS_DESC, A2W(desc));
+    progress.GetReporter().SetActionText(A2W(desc));
   };
 
   std::thread([&progress, &ctx] {
@@ -1401,17 +1420,11 @@ void PackageWindow::OnSaveClicked(wxCommandEvent& e)
   context.Path = W2A(path.ToStdWstring());
 
   context.ProgressCallback = [&progress](int value) {
-    wxCommandEvent* e = new wxCommandEvent;
-    e->SetId(UPDATE_PROGRESS);
-    e->SetInt(value);
-    wxQueueEvent(&progress, e);
+    progress.GetReporter().SetCurrentProgress(value);
   };
 
   context.MaxProgressCallback = [&progress](int value) {
-    wxCommandEvent* e = new wxCommandEvent;
-    e->SetId(UPDATE_MAX_PROGRESS);
-    e->SetInt(value);
-    wxQueueEvent(&progress, e);
+    progress.GetReporter().SetMaxProgress(value);
   };
 
   context.IsCancelledCallback = [&progress] {
@@ -1419,7 +1432,7 @@ void PackageWindow::OnSaveClicked(wxCommandEvent& e)
   };
 
   context.ProgressDescriptionCallback = [&progress](std::string desc) {
-    SendEvent(&progress, UPDATE_PROGRESS_DESC, A2W(desc));
+    progress.GetReporter().SetActionText(A2W(desc));
   };
 
   FPackage* package = Package.get();
@@ -1473,25 +1486,19 @@ void PackageWindow::OnSaveAsClicked(wxCommandEvent& e)
   context.Path = W2A(path.ToStdWstring());
 
   context.ProgressCallback = [&progress](int value) {
-    wxCommandEvent* e = new wxCommandEvent;
-    e->SetId(UPDATE_PROGRESS);
-    e->SetInt(value);
-    wxQueueEvent(&progress, e);
+    progress.GetReporter().SetCurrentProgress(value);
   };
 
   context.MaxProgressCallback = [&progress](int value) {
-    wxCommandEvent* e = new wxCommandEvent;
-    e->SetId(UPDATE_MAX_PROGRESS);
-    e->SetInt(value);
-    wxQueueEvent(&progress, e);
+    progress.GetReporter().SetMaxProgress(value);
   };
 
   context.IsCancelledCallback = [&progress] {
     return progress.IsCanceled();
   };
 
-  context.ProgressDescriptionCallback = [&progress] (std::string desc) {
-    SendEvent(&progress, UPDATE_PROGRESS_DESC, A2W(desc));
+  context.ProgressDescriptionCallback = [&progress](std::string desc) {
+    progress.GetReporter().SetActionText(A2W(desc));
   };
 
   FPackage* package = Package.get();
@@ -1722,6 +1729,13 @@ void PackageWindow::OnPackageReady(wxCommandEvent&)
 {
   Package->AddObserver(this);
   SearchField->Enable(true);
+  // Index export names while the user looks at the tree
+  CancelSearch();
+  SearchCancelled = false;
+  SearchThread = std::thread([this] {
+    // The first search cancels the build and restarts it on its own thread
+    NameIndex.Build(Package->GetRootExports(), &SearchCancelled);
+  });
   ObjectTreeCtrl->Freeze();
   LoadObjectTree();
   ObjectTreeCtrl->Thaw();
@@ -1869,6 +1883,7 @@ void PackageWindow::OnAddPackageClicked(int parentIdx)
     return;
   }
 
+  CancelSearch();
   if (FObjectExport* newExp = Package->AddExport(FString(name.ToStdWstring()), NAME_Package, parent))
   {
     ObjectTreeCtrl->AddExportObject(newExp, true);
@@ -1938,6 +1953,7 @@ void PackageWindow::OnAddTextureClicked(int parentIdx)
     return;
   }
 
+  CancelSearch();
   FObjectExport* exp = Package->AddExport(FString(name.ToStdWstring()), UTexture2D::StaticClassName(), parent);
   UTexture2D* texture = Cast<UTexture2D>(Package->GetObject(exp));
 
@@ -2049,6 +2065,7 @@ void PackageWindow::OnDuplicateClicked(PACKAGE_INDEX objIndex)
     }
   };
 
+  CancelSearch();
   if (FObjectExport* result = Package->DuplicateExport(source, parent, name.ToStdWstring()))
   {
     ObjectTreeCtrl->Freeze();
@@ -2220,11 +2237,15 @@ void PackageWindow::OnSearchEnter(wxCommandEvent& event)
     return;
   }
   bool completeMatch = true;
-  ObjectTreeNode* node = DataModel->GetRootExport()->FindItemByName(search);
+  ObjectTreeNode* node = DataModel->FindItemByName(search);
   if (!node)
   {
     completeMatch = false;
-    node = DataModel->GetRootExport()->FindFirstItemMatch(search);
+    node = DataModel->FindFirstItemMatch(search);
+  }
+  if (!node)
+  {
+    return;
   }
   FObjectExport* exp = node->GetExport();
   if (completeMatch)
@@ -2239,16 +2260,98 @@ void PackageWindow::OnSearchEnter(wxCommandEvent& event)
 
 void PackageWindow::OnSearchText(wxCommandEvent&)
 {
-  // This is extremely expensive!!!
-  // TODO: figure out a way to not rebuild the whole model on every char
-  bool needsRestore = false;
+  CancelSearch();
+  if (SearchField->GetValue().empty())
+  {
+    ApplySearch(FString(), nullptr);
+    return;
+  }
+  // Wait for the user to stop typing
+  SearchTimer.StartOnce(SEARCH_DELAY);
+}
+
+void PackageWindow::OnSearchTimer(wxTimerEvent&)
+{
+  CancelSearch();
   FString currentSearch = SearchField->GetValue().ToStdWstring();
-  if (DataModel && !DataModel->GetSearchValue().Size() && currentSearch.Size())
+  if (currentSearch.Empty())
+  {
+    return;
+  }
+  ExportNameIndex::Result previous;
+  {
+    std::scoped_lock<std::mutex> l(SearchMutex);
+    previous = LastSearch;
+  }
+  // Query the index on a worker so typing doesn't block the UI. Stale results are dropped.
+  SearchCancelled = false;
+  SearchThread = std::thread([this, currentSearch, previous = std::move(previous)] {
+    if (!NameIndex.Build(Package->GetRootExports(), &SearchCancelled))
+    {
+      return;
+    }
+    ExportNameIndex::Result found = NameIndex.Find(currentSearch, &previous, &SearchCancelled);
+    if (found.Cancelled)
+    {
+      return;
+    }
+    auto filter = std::make_unique<ObjectTreeFilter>(Package->GetRootExports(), NameIndex.GetExports(found), &SearchCancelled);
+    if (filter->IsCancelled())
+    {
+      return;
+    }
+    {
+      std::scoped_lock<std::mutex> l(SearchMutex);
+      SearchResult = std::move(filter);
+      SearchResultValue = currentSearch;
+      LastSearch = std::move(found);
+    }
+    SendEvent(this, SEARCH_READY);
+  });
+}
+
+void PackageWindow::OnSearchReady(wxCommandEvent&)
+{
+  std::unique_ptr<ObjectTreeFilter> filter;
+  FString search;
+  {
+    std::scoped_lock<std::mutex> l(SearchMutex);
+    filter = std::move(SearchResult);
+    search = SearchResultValue;
+  }
+  if (!filter || search.WString() != SearchField->GetValue().ToStdWstring())
+  {
+    return;
+  }
+  ApplySearch(search, std::move(filter));
+}
+
+void PackageWindow::CancelSearch()
+{
+  SearchTimer.Stop();
+  StopSearchThread();
+}
+
+void PackageWindow::StopSearchThread()
+{
+  SearchCancelled = true;
+  if (SearchThread.joinable())
+  {
+    SearchThread.join();
+  }
+  std::scoped_lock<std::mutex> l(SearchMutex);
+  SearchResult = nullptr;
+}
+
+void PackageWindow::ApplySearch(const FString& search, std::unique_ptr<ObjectTreeFilter> filter)
+{
+  bool needsRestore = false;
+  if (DataModel && !DataModel->GetSearchValue().Size() && search.Size())
   {
     ObjectTreeCtrl->SaveTreeState();
     UpdateAccelerators();
   }
-  else if (DataModel && DataModel->GetSearchValue().Size() && !currentSearch.Size())
+  else if (DataModel && DataModel->GetSearchValue().Size() && !search.Size())
   {
     needsRestore = true;
   }
@@ -2257,9 +2360,9 @@ void PackageWindow::OnSearchText(wxCommandEvent&)
 #ifdef _DUBUG
   imps = Package->GetRootImports();
 #endif
-  if (currentSearch.Size())
+  if (filter)
   {
-    DataModel = new ObjectTreeModel(Package->GetPackageName(), Package->GetRootExports(), imps, currentSearch);
+    DataModel = new ObjectTreeModel(Package->GetPackageName(), Package->GetRootExports(), imps, std::move(filter), search);
   }
   else
   {
@@ -2272,7 +2375,7 @@ void PackageWindow::OnSearchText(wxCommandEvent&)
   }
   ObjectTreeCtrl->Freeze();
   ObjectTreeCtrl->AssociateModel(DataModel.get());
-  if (SearchField->GetValue().size())
+  if (search.Size())
   {
     ObjectTreeCtrl->ExpandAll();
   }
@@ -2405,6 +2508,7 @@ EVT_COMMAND(wxID_ANY, SELECT_OBJECT, PackageWindow::OnSelectObject)
 EVT_COMMAND(wxID_ANY, OBJECT_CHANGED, PackageWindow::OnObjectDirty)
 EVT_COMMAND(wxID_ANY, OBJECT_ADD, PackageWindow::OnObjectAdded)
 EVT_COMMAND(wxID_ANY, UPDATE_PROPERTIES, PackageWindow::OnUpdateProperties)
+EVT_COMMAND(wxID_ANY, SEARCH_READY, PackageWindow::OnSearchReady)
 EVT_BUTTON(ControlElementId::Back, PackageWindow::OnBackClicked)
 EVT_BUTTON(ControlElementId::Forward, PackageWindow::OnForwardClicked)
 EVT_BUTTON(ControlElementId::EditExpFlags, PackageWindow::OnEditExportFlagsClicked)
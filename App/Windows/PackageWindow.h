@@ -7,9 +7,14 @@
 #include <wx/propgrid/manager.h>
 
 #include "../Editors/GenericEditor.h"
+#include "../Misc/ExportNameIndex.h"
 #include "../Misc/ObjectTreeModel.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <Tera/FPackage.h>
@@ -141,6 +146,11 @@ private:
 
   void OnSearchEnter(wxCommandEvent&);
   void OnSearchText(wxCommandEvent&);
+  void OnSearchTimer(wxTimerEvent&);
+  void OnSearchReady(wxCommandEvent&);
+  void CancelSearch();
+  void StopSearchThread();
+  void ApplySearch(const FString& search, std::unique_ptr<ObjectTreeFilter> filter);
   void OnFocusSearch(wxCommandEvent&);
   void OnEscClicked(wxCommandEvent& e);
   void ClearSearch(bool preserveSelection = true);
@@ -204,6 +214,15 @@ private:
   wxTimer HeartBeat;
 
   wxObjectDataPtr<ObjectTreeModel> DataModel;
+  std::thread SearchThread;
+  wxTimer SearchTimer;
+  ExportNameIndex NameIndex;
+  // Last applied index query. Next query refines it if possible.
+  ExportNameIndex::Result LastSearch;
+  std::atomic_bool SearchCancelled = false;
+  std::mutex SearchMutex;
+  std::unique_ptr<ObjectTreeFilter> SearchResult;
+  FString SearchResultValue;
   bool ContentHidden = false;
   bool PropertiesHidden = false;
   bool DisableSizeUpdates = true;
@@ -2,6 +2,8 @@
 #include "ProgressWindow.h"
 #include "../App.h"
 #include "REDialogs.h"
+#include "../Misc/ATrace.h"
+#include "../Misc/TextureFormats.h"
 
 #include <filesystem>
 
@@ -16,7 +18,6 @@
 #include <Tera/USoundNode.h>
 #include <Tera/USpeedTree.h>
 
-#include <Tera/Utils/APerfSamples.h>
 #include <Tera/Utils/MeshUtils.h>
 #include <Tera/Utils/TextureUtils.h>
 
@@ -104,7 +105,7 @@ void PackageWindow::OnBulkPackageExport(PACKAGE_INDEX objIndex)
   additionalCount += (int32)exports.size();
   progress.SetMaxProgress(additionalCount);
   int32 count = 0;
-  PERF_START(BulkExport);
+  TRACE_START(BulkExport);
   std::thread([&] {
     int progressCounter = 0;
     for (int idx = 0; idx < exports.size(); ++idx, ++progressCounter)
@@ -179,15 +180,7 @@ void PackageWindow::OnBulkPackageExport(PACKAGE_INDEX objIndex)
           LogE("%s is not a texture", exp->GetObjectNameString().UTF8().c_str());
           continue;
         }
-        FTexture2DMipMap* mip = nullptr;
-        for (FTexture2DMipMap* mipmap : texture->Mips)
-        {
-          if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-          {
-            mip = mipmap;
-            break;
-          }
-        }
+        FTexture2DMipMap* mip = TextureFormats::GetTopMip(texture);
         if (!mip)
         {
           failedExports.push_back(exp);
@@ -196,30 +189,9 @@ void PackageWindow::OnBulkPackageExport(PACKAGE_INDEX objIndex)
 
         dest.replace_extension(IODialog::GetLastTextureExtension().ToStdString());
 
-        TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
+        TextureProcessor::TCFormat inputFormat = TextureFormats::GetProcessorFormat(texture->Format);
         TextureProcessor::TCFormat outputFormat = TextureProcessor::GetTcFormatByExtension(dest.extension().string());
-
-        if (texture->Format == PF_DXT1)
-        {
-          inputFormat = TextureProcessor::TCFormat::DXT1;
-        }
-        else if (texture->Format == PF_DXT3)
-        {
-          inputFormat = TextureProcessor::TCFormat::DXT3;
-        }
-        else if (texture->Format == PF_DXT5)
-        {
-          inputFormat = TextureProcessor::TCFormat::DXT5;
-        }
-        else if (texture->Format == PF_A8R8G8B8)
-        {
-          inputFormat = TextureProcessor::TCFormat::ARGB8;
-        }
-        else if (texture->Format == PF_G8)
-        {
-          inputFormat = TextureProcessor::TCFormat::G8;
-        }
-        else
+        if (inputFormat == TextureProcessor::TCFormat::None)
         {
           failedExports.push_back(exp);
           LogE("%s has unsupported pixel format!", exp->GetObjectNameString().UTF8().c_str());
@@ -252,48 +224,10 @@ void PackageWindow::OnBulkPackageExport(PACKAGE_INDEX objIndex)
       }
       if (obj->GetClassName() == UTextureCube::StaticClassName())
       {
-        auto faces = Cast<UTextureCube>(obj)->GetFaces();
-        bool invalidFace = faces.empty();
-        TextureProcessor::TCFormat inputFormat = TextureProcessor::TCFormat::None;
-        for (UTexture2D* face : faces)
-        {
-          if (!face)
-          {
-            invalidFace = true;
-            LogE("Failed to load the cube face!");
-            break;
-          }
-
-          TextureProcessor::TCFormat f = TextureProcessor::TCFormat::None;
-          switch (face->Format)
-          {
-          case PF_DXT1:
-            f = TextureProcessor::TCFormat::DXT1;
-            break;
-          case PF_DXT3:
-            f = TextureProcessor::TCFormat::DXT3;
-            break;
-          case PF_DXT5:
-            f = TextureProcessor::TCFormat::DXT5;
-            break;
-          case PF_A8R8G8B8:
-            f = TextureProcessor::TCFormat::ARGB8;
-            break;
-          case PF_G8:
-            f = TextureProcessor::TCFormat::G8;
-            break;
-          default:
-            continue;
-          }
-          if (inputFormat != TextureProcessor::TCFormat::None && inputFormat != f)
-          {
-            invalidFace = true;
-            break;
-          }
-          inputFormat = f;
-        }
-        if (invalidFace)
+        TextureCubeInput input(Cast<UTextureCube>(obj));
+        if (!input.IsValid())
         {
+          LogE("%s", input.GetError().c_str());
           continue;
         }
         wxString ext = IODialog::GetLastTextureExtension();
@@ -320,31 +254,15 @@ void PackageWindow::OnBulkPackageExport(PACKAGE_INDEX objIndex)
           continue;
         }
 
-        TextureProcessor processor(inputFormat, outputFormat);
-        bool noMip = false;
-        for (int32 faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
-        {
-          FTexture2DMipMap* mip = nullptr;
-          for (FTexture2DMipMap* mipmap : faces[faceIdx]->Mips)
-          {
-            if (mipmap->Data && mipmap->Data->GetAllocation() && mipmap->SizeX && mipmap->SizeY)
-            {
-              mip = mipmap;
-              break;
-            }
-          }
-          if (!mip)
-          {
-            noMip = true;
-            break;
-          }
-          processor.SetInputCubeFace(faceIdx, mip->Data->GetAllocation(), mip->Data->GetBulkDataSize(), mip->SizeX, mip->SizeY);
-        }
-        if (noMip)
+        if (!input.Decode(outputFormat))
         {
+          LogE("%s", input.GetError().c_str());
           continue;
         }
 
+        TextureProcessor processor(input.GetProcessorFormat(), outputFormat);
+        input.SetProcessorInput(processor);
+
         processor.SetOutputPath(W2A(dest.replace_extension(ext.ToStdWstring()).wstring()));
 
         bool result = false;
@@ -581,7 +499,7 @@ void PackageWindow::OnBulkPackageExport(PACKAGE_INDEX objIndex)
     SendEvent(&progress, UPDATE_PROGRESS_FINISH);
   }).detach();
   progress.ShowModal();
-  PERF_END(BulkExport);
+  TRACE_END(BulkExport);
   if (failedExports.empty())
   {
     if (!count)
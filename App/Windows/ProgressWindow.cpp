@@ -1,11 +1,26 @@
 #include "ProgressWindow.h"
 
+#include <algorithm>
+
+#define POLL_INTERVAL 50
+
 wxDEFINE_EVENT(UPDATE_MAX_PROGRESS, wxCommandEvent);
 wxDEFINE_EVENT(UPDATE_PROGRESS, wxCommandEvent);
 wxDEFINE_EVENT(UPDATE_PROGRESS_ADV, wxCommandEvent);
 wxDEFINE_EVENT(UPDATE_PROGRESS_DESC, wxCommandEvent);
 wxDEFINE_EVENT(UPDATE_PROGRESS_FINISH, wxCommandEvent);
 
+ProgressReporter::~ProgressReporter()
+{
+  delete ActionText.exchange(nullptr);
+}
+
+void ProgressReporter::SetActionText(const wxString& text)
+{
+  // The window owns the string once it takes it. A description it didn't take yet is replaced.
+  delete ActionText.exchange(new wxString(text), std::memory_order_acq_rel);
+}
+
 class ActionTextCtrl : public wxTextCtrl {
 public:
   using wxTextCtrl::wxTextCtrl;
@@ -69,6 +84,9 @@ ProgressWindow::ProgressWindow(wxWindow* parent, const wxString& title, const wx
 
   // Connect Events
   CancelButton->Connect(wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler(ProgressWindow::OnCancelClicked), NULL, this);
+
+  PollTimer.Bind(wxEVT_TIMER, &ProgressWindow::OnTick, this);
+  PollTimer.Start(POLL_INTERVAL);
 }
 
 void ProgressWindow::SetActionText(const wxString& text)
@@ -130,6 +148,29 @@ void ProgressWindow::OnCancelClicked(wxCommandEvent&)
   ProgressBar->Pulse();
 }
 
+void ProgressWindow::OnTick(wxTimerEvent&)
+{
+  if (wxString* text = Reporter.PopActionText())
+  {
+    SetActionText(*text);
+    delete text;
+  }
+
+  // Apply only values that changed since the last tick, so events sent by older code still work
+  const int maxProgress = Reporter.MaxProgress.load(std::memory_order_relaxed);
+  if (maxProgress != LastMaxProgress)
+  {
+    LastMaxProgress = maxProgress;
+    SetMaxProgress(maxProgress);
+  }
+  const int progress = Reporter.Progress.load(std::memory_order_relaxed);
+  if (progress != LastProgress || progress < 0)
+  {
+    LastProgress = progress;
+    SetCurrentProgress(progress < 0 ? progress : std::min(progress, ProgressBar->GetRange()));
+  }
+}
+
 void ProgressWindow::OnUpdateMaxProgress(wxCommandEvent& e)
 {
   SetMaxProgress(e.GetInt());
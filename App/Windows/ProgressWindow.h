@@ -10,6 +10,45 @@ wxDECLARE_EVENT(UPDATE_PROGRESS_ADV, wxCommandEvent);
 wxDECLARE_EVENT(UPDATE_PROGRESS_DESC, wxCommandEvent);
 wxDECLARE_EVENT(UPDATE_PROGRESS_FINISH, wxCommandEvent);
 
+// Progress state shared by a worker thread and a ProgressWindow. Workers update it without locks
+// or events and the window polls it on a timer, so frequent ticks don't flood the UI thread.
+// Only the latest description is shown.
+class ProgressReporter {
+public:
+  ~ProgressReporter();
+
+  void SetActionText(const wxString& text);
+
+  // Pass -1 to pulse
+  void SetCurrentProgress(int progress)
+  {
+    Progress.store(progress, std::memory_order_relaxed);
+  }
+
+  void AdvanceProgress(int count = 1)
+  {
+    Progress.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void SetMaxProgress(int max)
+  {
+    MaxProgress.store(max, std::memory_order_relaxed);
+  }
+
+private:
+  friend class ProgressWindow;
+
+  // Take the latest description. Returns nullptr if the description didn't change.
+  wxString* PopActionText()
+  {
+    return ActionText.exchange(nullptr, std::memory_order_acquire);
+  }
+
+  std::atomic_int Progress = { 0 };
+  std::atomic_int MaxProgress = { 0 };
+  std::atomic<wxString*> ActionText = { nullptr };
+};
+
 class ProgressWindow : public WXDialog {
 public:
   ProgressWindow(wxWindow* parent, const wxString& title = wxT("Loading"), const wxString& cancel = wxT("Cancel"));
@@ -36,9 +75,17 @@ public:
 
   int ShowModal() wxOVERRIDE;
 
+  // Thread safe progress to update from workers
+  ProgressReporter& GetReporter()
+  {
+    return Reporter;
+  }
+
 private:
   void OnCancelClicked(wxCommandEvent&);
 
+  void OnTick(wxTimerEvent& e);
+
   void OnUpdateMaxProgress(wxCommandEvent& e);
 
   void OnUpdateProgress(wxCommandEvent& e);
@@ -57,4 +104,9 @@ private:
   wxGauge* ProgressBar = nullptr;
   wxButton* CancelButton = nullptr;
   std::atomic_bool Canceled = { false };
+  ProgressReporter Reporter;
+  wxTimer PollTimer;
+  // Reporter values applied by the last tick
+  int LastProgress = 0;
+  int LastMaxProgress = 0;
 };
\ No newline at end of file
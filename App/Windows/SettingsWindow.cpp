@@ -3,6 +3,7 @@
 #include "DcToolDialog.h"
 #include "REDialogs.h"
 #include "../App.h"
+#include "../Misc/TextureCache.h"
 
 #include <wx/statline.h>
 #include <thread>
@@ -37,7 +38,7 @@ bool IsValidDir(const wxString& path)
 }
 
 SettingsWindow::SettingsWindow(const FAppConfig& currentConfig, FAppConfig& output, bool allowRebuild, const wxPoint& pos)
-  : WXDialog(nullptr, wxID_ANY, wxS("Settings"), pos, wxSize(668, IS_TERA_BUILD ? 468 : 398), wxCAPTION | wxCLOSE_BOX | wxSYSTEM_MENU | wxTAB_TRAVERSAL)
+  : WXDialog(nullptr, wxID_ANY, wxS("Settings"), pos, wxSize(668, IS_TERA_BUILD ? 498 : 428), wxCAPTION | wxCLOSE_BOX | wxSYSTEM_MENU | wxTAB_TRAVERSAL)
   , CurrentConfig(currentConfig)
   , NewConfig(output)
   , AllowRebuild(allowRebuild)
@@ -220,6 +221,25 @@ SettingsWindow::SettingsWindow(const FAppConfig& currentConfig, FAppConfig& outp
   ShowImportObjects->SetValue(CurrentConfig.ShowImports);
   bSizer11->Add(ShowImportObjects, 0, wxALL, FromDIP(5));
 
+  wxBoxSizer* bSizer15;
+  bSizer15 = new wxBoxSizer(wxHORIZONTAL);
+
+  wxStaticText* m_staticText11;
+  m_staticText11 = new wxStaticText(m_panel6, wxID_ANY, wxT("Texture cache, MB:"), wxDefaultPosition, wxDefaultSize, 0);
+  m_staticText11->Wrap(-1);
+  bSizer15->Add(m_staticText11, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(5));
+
+  TextureCacheBudget = new wxSpinCtrl(m_panel6, wxID_ANY, wxEmptyString, wxDefaultPosition, FromDIP(wxSize(80, -1)), wxSP_ARROW_KEYS, 64, 16384, CurrentConfig.TextureCacheBudget);
+  TextureCacheBudget->SetToolTip(wxT("Memory budget for decoded textures shared by all 3D viewers. Least recently used textures are released first."));
+  bSizer15->Add(TextureCacheBudget, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(5));
+
+  wxStaticText* m_staticText12;
+  m_staticText12 = new wxStaticText(m_panel6, wxID_ANY, wxString::Format(wxT("In use: %llu MB"), TextureCache::Get().GetUsage() / (1024 * 1024)), wxDefaultPosition, wxDefaultSize, 0);
+  m_staticText12->Wrap(-1);
+  bSizer15->Add(m_staticText12, 0, wxALIGN_CENTER_VERTICAL | wxALL, FromDIP(5));
+
+  bSizer11->Add(bSizer15, 0, wxEXPAND, FromDIP(5));
+
   m_panel6->SetSizer(bSizer11);
   m_panel6->Layout();
   bSizer11->Fit(m_panel6);
@@ -340,6 +360,7 @@ void SettingsWindow::OnUpdateDirCacheClicked(wxCommandEvent&)
     try
     {
       FPackage::UpdateDirCache();
+      App::GetSharedApp()->OnDirCacheUpdated();
     }
     catch (const std::exception& e)
     {
@@ -490,6 +511,7 @@ void SettingsWindow::OnCancelClicked(wxCommandEvent&)
 void SettingsWindow::OnOkClicked(wxCommandEvent&)
 {
   NewConfig.FastObjectDump = FastObjDump->GetValue();
+  NewConfig.TextureCacheBudget = TextureCacheBudget->GetValue();
 #if IS_ASTELLIA_BUILD
   std::filesystem::path path = PathField->GetValue().ToStdWstring();
   FPackage::S1DirError err = FPackage::ValidateRootDirCandidate(path.wstring());
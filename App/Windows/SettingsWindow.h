@@ -1,5 +1,6 @@
 #pragma once
 #include <wx/wx.h>
+#include <wx/spinctrl.h>
 #include "WXDialog.h"
 #include "../Misc/AConfiguration.h"
 
@@ -48,6 +49,7 @@ private:
   wxCheckBox* FastObjDump;
   wxCheckBox* UseBuiltInS1Game32;
   wxCheckBox* ShowImportObjects;
+  wxSpinCtrl* TextureCacheBudget;
 
   bool AllowRebuild = true;
   bool WasRegistered = false;
@@ -2,6 +2,8 @@
 #include "../App.h"
 #include "../Windows/ProgressWindow.h"
 #include "../Windows/REDialogs.h"
+#include "../Misc/ATrace.h"
+#include "../Misc/TextureFormats.h"
 
 #include <Tera/FStream.h>
 #include <Tera/UTexture.h>
@@ -466,31 +468,14 @@ bool TextureImporter::Run()
       return false;
     }
 
-    switch (importer.GetPixelFormat())
-    {
-    case PF_DXT1:
-      outputFormat = TextureProcessor::TCFormat::DXT1;
-      break;
-    case PF_DXT3:
-      outputFormat = TextureProcessor::TCFormat::DXT3;
-      break;
-    case PF_DXT5:
-      outputFormat = TextureProcessor::TCFormat::DXT5;
-      break;
-    case PF_A8R8G8B8:
-      outputFormat = TextureProcessor::TCFormat::ARGB8;
-      break;
-    case PF_G8:
-      outputFormat = TextureProcessor::TCFormat::G8;
-      break;
-    default:
+    outputFormat = TextureFormats::GetProcessorFormat(importer.GetPixelFormat());
+    if (outputFormat == TextureProcessor::TCFormat::None)
     {
       std::string errmsg = std::string("Format ") + PixelFormatToString(Texture->Format).String() + " is not supported!";
       LogE(errmsg.c_str());
       REDialog::Error(errmsg);
       return false;
     }
-    }
   }
   else
   {
@@ -500,51 +485,25 @@ bool TextureImporter::Run()
       FReadStream s(path.ToStdWstring());
       DDS::DDSHeader header;
       s << header;
-      switch (header.GetPixelFormat())
-      {
-      case PF_DXT1:
-      case PF_DXT3:
-      case PF_DXT5:
-        outputFormat = TextureProcessor::TCFormat::DXT;
-        break;
-      case PF_A8R8G8B8:
-        outputFormat = TextureProcessor::TCFormat::ARGB8;
-        break;
-      case PF_G8:
-        outputFormat = TextureProcessor::TCFormat::G8;
-        break;
-      default:
+      outputFormat = TextureFormats::GetProcessorDdsFormat(header.GetPixelFormat());
+      if (outputFormat == TextureProcessor::TCFormat::None)
       {
         std::string errmsg = std::string("Format ") + PixelFormatToString(header.GetPixelFormat()).String() + " is not supported!\nUse one of the following formats: DXT1-5(BC1-3), ARGB8, G8(R8).";
         LogE(errmsg.c_str());
         REDialog::Error(errmsg);
         return false;
       }
-      }
     }
     else
     {
-      switch (Texture->Format)
-      {
-      case PF_DXT1:
-      case PF_DXT3:
-      case PF_DXT5:
-        outputFormat = TextureProcessor::TCFormat::DXT;
-        break;
-      case PF_A8R8G8B8:
-        outputFormat = TextureProcessor::TCFormat::ARGB8;
-        break;
-      case PF_G8:
-        outputFormat = TextureProcessor::TCFormat::G8;
-        break;
-      default:
+      outputFormat = TextureFormats::GetProcessorDdsFormat(Texture->Format);
+      if (outputFormat == TextureProcessor::TCFormat::None)
       {
         std::string errmsg = std::string("Format ") + PixelFormatToString(Texture->Format).String() + " is not supported!";
         LogE(errmsg.c_str());
         REDialog::Error(errmsg);
         return false;
       }
-      }
     }
   }
 
@@ -567,6 +526,7 @@ bool TextureImporter::Run()
     bool result = false;
     try
     {
+      TRACE_SCOPE("TextureProcess");
       result = processor.Process();
     }
     catch (const std::exception& e)
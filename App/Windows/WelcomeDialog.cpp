@@ -408,6 +408,7 @@ int WelcomeDialog::ShowModal()
       std::vector<std::pair<std::string, std::string>> failed;
       std::thread([&] {
         FPackage::UpdateDirCache(App::GetSharedApp()->GetConfig().RootDir);
+        App::GetSharedApp()->OnDirCacheUpdated();
         pkgList = FPackage::FilePackageNames;
         SendEvent(&progress, UPDATE_PROGRESS_FINISH);
       }).detach();
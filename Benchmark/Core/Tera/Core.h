@@ -0,0 +1,37 @@
+#pragma once
+// Stand-in for the core library header. Provides only what the benchmarked App/Misc modules use,
+// so the benchmark builds without the core.
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef int8_t int8;
+typedef uint8_t uint8;
+typedef int16_t int16;
+typedef uint16_t uint16;
+typedef int32_t int32;
+typedef uint32_t uint32;
+typedef int64_t int64;
+typedef uint64_t uint64;
+
+typedef signed int PACKAGE_INDEX;
+#define INDEX_NONE -1
+
+inline bool HasAVX2()
+{
+#ifdef _MSC_VER
+  int32 info[4] = {};
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return info[1] & (1 << 5);
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
@@ -0,0 +1,27 @@
+#pragma once
+// Stand-in for the core library export table entry. Holds only the fields ExportNameIndex reads.
+#include "Core.h"
+#include "FString.h"
+
+#include <vector>
+
+#define NAME_Package "Package"
+
+class FObjectExport {
+public:
+  FString GetObjectNameString() const
+  {
+    return ObjectName;
+  }
+
+  FString GetClassName() const
+  {
+    return ClassName;
+  }
+
+  FString ObjectName;
+  FString ClassName;
+  PACKAGE_INDEX ObjectIndex = 0;
+  FObjectExport* Outer = nullptr;
+  std::vector<FObjectExport*> Inner;
+};
@@ -0,0 +1,40 @@
+#pragma once
+// Stand-in for the core library string. UTF-8 storage with the members ExportNameIndex uses.
+#include "Core.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+class FString {
+public:
+  FString() = default;
+
+  FString(const char* str)
+    : Data(str)
+  {}
+
+  FString(const std::string& str)
+    : Data(str)
+  {}
+
+  FString ToUpper() const
+  {
+    std::string result = Data;
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return (char)std::toupper(c); });
+    return result;
+  }
+
+  const std::string& UTF8() const
+  {
+    return Data;
+  }
+
+  bool operator==(const char* str) const
+  {
+    return Data == str;
+  }
+
+private:
+  std::string Data;
+};
@@ -0,0 +1,14 @@
+#pragma once
+// Stand-in for the core library header. Only the pixel formats TextureDecoder maps are declared.
+#include "Core.h"
+
+enum EPixelFormat {
+  PF_Unknown = 0,
+  PF_A8R8G8B8 = 2,
+  PF_G8 = 3,
+  PF_G16 = 4,
+  PF_DXT1 = 5,
+  PF_DXT3 = 6,
+  PF_DXT5 = 7,
+  PF_BC5 = 25
+};
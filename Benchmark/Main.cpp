@@ -0,0 +1,271 @@
+// Benchmark of the App modules that don't need the core library: texture decoding, export and package
+// name search and terrain rasters. Inputs are generated from a fixed seed, so runs are comparable.
+// Usage: Benchmark [output.json] [iterations]
+// Core/Tera holds minimal stand-ins for the core headers: only the types and members the benchmarked modules
+// use. They are not kept in sync with the core, so extend them when those modules start using more of it.
+// Build with Benchmark.vcxproj or, without MSBuild, with CMakeLists.txt.
+#include "../App/Misc/ExportNameIndex.h"
+#include "../App/Misc/PackageNameIndex.h"
+#include "../App/Misc/TerrainRaster.h"
+#include "../App/Misc/TextureDecoder.h"
+
+#include <Tera/FObjectResource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  struct BenchResult {
+    std::string Name;
+    double MinMs = 0.;
+    double AvgMs = 0.;
+    // Processed bytes per iteration. Zero if throughput doesn't apply.
+    uint64 Bytes = 0;
+  };
+
+  class Random {
+  public:
+    uint32 Next()
+    {
+      Seed = Seed * 1664525 + 1013904223;
+      return Seed >> 8;
+    }
+
+  private:
+    uint32 Seed = 0x2545F491;
+  };
+
+  std::vector<BenchResult> Results;
+  int32 Iterations = 10;
+
+  void Measure(const std::string& name, uint64 bytes, const std::function<void()>& body)
+  {
+    BenchResult result;
+    result.Name = name;
+    result.Bytes = bytes;
+    result.MinMs = 1e20;
+    double total = 0.;
+    // The first run warms up caches and the thread pool
+    body();
+    for (int32 idx = 0; idx < Iterations; ++idx)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      body();
+      const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      result.MinMs = std::min(result.MinMs, ms);
+      total += ms;
+    }
+    result.AvgMs = total / Iterations;
+    printf("%-40s min %9.3f ms  avg %9.3f ms\n", name.c_str(), result.MinMs, result.AvgMs);
+    Results.push_back(result);
+  }
+
+  void BenchTextureDecoder()
+  {
+    const TextureDecoder::Format formats[] = { TextureDecoder::Format::DXT1, TextureDecoder::Format::DXT5, TextureDecoder::Format::BC5, TextureDecoder::Format::G16 };
+    const char* formatNames[] = { "DXT1", "DXT5", "BC5", "G16" };
+    const int32 size = 2048;
+    Random random;
+    std::vector<uint8> pixels(size_t(size) * size * 4);
+    for (size_t formatIdx = 0; formatIdx < sizeof(formats) / sizeof(*formats); ++formatIdx)
+    {
+      const TextureDecoder::Format format = formats[formatIdx];
+      std::vector<uint8> data(TextureDecoder::GetEncodedSize(format, size, size));
+      for (uint8& v : data)
+      {
+        v = uint8(random.Next());
+      }
+      for (int32 kernel = 0; kernel <= (int32)TextureDecoder::GetBestKernel(); ++kernel)
+      {
+        Measure(std::string("Decode.") + formatNames[formatIdx] + "." + TextureDecoder::GetKernelName((TextureDecoder::Kernel)kernel), pixels.size(), [&] {
+          TextureDecoder::Decode(format, data.data(), data.size(), size, size, pixels.data(), (TextureDecoder::Kernel)kernel);
+        });
+      }
+    }
+  }
+
+  void BenchExportNameIndex()
+  {
+    // A map package: levels with actors, and top level packages with assets
+    static const char* prefixes[] = { "StaticMeshActor", "PointLight", "SM_Rock", "T_Ground", "MI_Foliage", "Emitter", "BlockingVolume", "SkeletalMeshActor" };
+    std::vector<std::unique_ptr<FObjectExport>> storage;
+    std::vector<FObjectExport*> rootExports;
+    auto addExport = [&](FObjectExport* outer, const std::string& name, const char* className) {
+      FObjectExport* exp = storage.emplace_back(std::make_unique<FObjectExport>()).get();
+      exp->ObjectName = name;
+      exp->ClassName = className;
+      exp->ObjectIndex = PACKAGE_INDEX(storage.size());
+      exp->Outer = outer;
+      if (outer)
+      {
+        outer->Inner.push_back(exp);
+      }
+      else
+      {
+        rootExports.push_back(exp);
+      }
+      return exp;
+    };
+    Random random;
+    for (int32 levelIdx = 0; levelIdx < 8; ++levelIdx)
+    {
+      FObjectExport* level = addExport(nullptr, "Level_" + std::to_string(levelIdx), "Level");
+      for (int32 idx = 0; idx < 20000; ++idx)
+      {
+        const char* prefix = prefixes[random.Next() % (sizeof(prefixes) / sizeof(*prefixes))];
+        FObjectExport* actor = addExport(level, std::string(prefix) + "_" + std::to_string(idx), prefix);
+        // Components aren't searchable and only make the tree deeper
+        addExport(actor, "Component_" + std::to_string(idx), "Component");
+      }
+    }
+    for (int32 packageIdx = 0; packageIdx < 200; ++packageIdx)
+    {
+      FObjectExport* package = addExport(nullptr, "Package_" + std::to_string(packageIdx), NAME_Package);
+      for (int32 idx = 0; idx < 200; ++idx)
+      {
+        const char* prefix = prefixes[random.Next() % (sizeof(prefixes) / sizeof(*prefixes))];
+        addExport(package, std::string(prefix) + "_" + std::to_string(packageIdx * 1000 + idx), "StaticMesh");
+      }
+    }
+
+    Measure("ExportNameIndex.Build", 0, [&] {
+      ExportNameIndex index;
+      index.Build(rootExports);
+    });
+    ExportNameIndex index;
+    index.Build(rootExports);
+    Measure("ExportNameIndex.Find", 0, [&] {
+      index.Find(FString("rock_1"));
+    });
+    Measure("ExportNameIndex.FindShort", 0, [&] {
+      index.Find(FString("_1"));
+    });
+    const ExportNameIndex::Result previous = index.Find(FString("rock_1"));
+    Measure("ExportNameIndex.Refine", 0, [&] {
+      index.Find(FString("rock_12"), &previous);
+    });
+  }
+
+  void BenchPackageNameIndex()
+  {
+    Random random;
+    std::vector<wxString> names;
+    names.reserve(300000);
+    for (int32 idx = 0; idx < 300000; ++idx)
+    {
+      names.push_back(wxString::Format("%c%c_Package_%06u", 'A' + random.Next() % 26, 'a' + random.Next() % 26, random.Next() % 1000000));
+    }
+    Measure("PackageNameIndex.Build", 0, [&] {
+      PackageNameIndex index;
+      index.Build(std::vector<wxString>(names));
+    });
+    PackageNameIndex index;
+    index.Build(std::vector<wxString>(names));
+    std::vector<wxString> queries;
+    for (int32 idx = 0; idx < 10000; ++idx)
+    {
+      queries.push_back(names[random.Next() % names.size()].Left(1 + random.Next() % 10).Upper());
+    }
+    Measure("PackageNameIndex.FindPrefix", 0, [&] {
+      for (const wxString& query : queries)
+      {
+        index.FindPrefix(query);
+      }
+    });
+    Measure("PackageNameIndex.Contains", 0, [&] {
+      for (const wxString& query : queries)
+      {
+        index.Contains(query);
+      }
+    });
+  }
+
+  void BenchTerrainRaster()
+  {
+    const int32 size = 1025;
+    Random random;
+    std::vector<uint16> heights(size_t(size) * size);
+    for (uint16& v : heights)
+    {
+      v = uint16(random.Next());
+    }
+    std::vector<uint8> weights(heights.size());
+    for (uint8& v : weights)
+    {
+      v = uint8(random.Next());
+    }
+    TerrainRaster heightmap = TerrainRaster::View(heights.data(), size, size, 2);
+    TerrainRaster weightmap = TerrainRaster::View(weights.data(), size, size, 1);
+    Measure("TerrainRaster.Resample16", uint64(4033) * 4033 * 2, [&] {
+      heightmap.Resampled(4033, 4033);
+    });
+    Measure("TerrainRaster.Resample8", uint64(4033) * 4033, [&] {
+      weightmap.Resampled(4033, 4033);
+    });
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string error;
+    Measure("TerrainRaster.SavePng16", heights.size() * 2, [&] {
+      heightmap.SavePng(dir / "REBenchmark.png", error);
+    });
+    Measure("TerrainRaster.SaveTga8", weights.size(), [&] {
+      weightmap.SaveTga(dir / "REBenchmark.tga", error);
+    });
+    std::error_code err;
+    std::filesystem::remove(dir / "REBenchmark.png", err);
+    std::filesystem::remove(dir / "REBenchmark.tga", err);
+  }
+
+  bool SaveJson(const std::filesystem::path& path)
+  {
+    std::ofstream s(path, std::ios::out | std::ios::trunc);
+    if (!s.is_open())
+    {
+      return false;
+    }
+    s << "{\n  \"iterations\": " << Iterations << ",\n  \"kernel\": \"" << TextureDecoder::GetKernelName(TextureDecoder::GetBestKernel()) << "\",\n  \"results\": [\n";
+    for (size_t idx = 0; idx < Results.size(); ++idx)
+    {
+      const BenchResult& r = Results[idx];
+      s << "    { \"name\": \"" << r.Name << "\", \"minMs\": " << r.MinMs << ", \"avgMs\": " << r.AvgMs << ", \"bytes\": " << r.Bytes << " }";
+      s << (idx + 1 < Results.size() ? ",\n" : "\n");
+    }
+    s << "  ]\n}\n";
+    return s.good();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 2)
+  {
+    Iterations = std::max(1, atoi(argv[2]));
+  }
+
+  std::string error;
+  if (!TextureDecoder::SelfCheck(error))
+  {
+    printf("TextureDecoder self-check failed: %s\n", error.c_str());
+    return 1;
+  }
+
+  BenchTextureDecoder();
+  BenchExportNameIndex();
+  BenchPackageNameIndex();
+  BenchTerrainRaster();
+
+  if (argc > 1 && !SaveJson(argv[1]))
+  {
+    printf("Failed to save %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}